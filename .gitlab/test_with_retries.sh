@@ -5,23 +5,24 @@ set -u
 set -o pipefail
 
 # --- Script Arguments ---
-if [ "$#" -ne 2 ]; then
-  echo "Usage: $0 <TARGET> <IDF_VER>"
-  echo "Example: $0 esp32c6 release-v5.4"
+if [ "$#" -ne 3 ]; then
+  echo "Usage: $0 <TARGET> <IDF_VER> <CONFIG>"
+  echo "Example: $0 esp32c6 release-v5.4 default"
   exit 1
 fi
 
 TARGET="$1"
 IDF_VER="$2"
+CONFIG="$3"
 
-echo "--- Test Script Started for Target: ${TARGET}, IDF: ${IDF_VER} ---"
+echo "--- Test Script Started for Target: ${TARGET}, IDF: ${IDF_VER}, Config: ${CONFIG} ---"
 
 echo "Running pytest for ${TARGET}..."
 export ESPBAUD=115200
 
 MAX_ATTEMPTS=4
-PYTEST_COMMAND="uv run pytest --target ${TARGET} --junit-xml=result_${TARGET}_${IDF_VER}.xml --build-dir=build_idf-${IDF_VER}_${TARGET}"
-XML_REPORT_FILE="result_${TARGET}_${IDF_VER}.xml"
+PYTEST_COMMAND="uv run pytest --target ${TARGET} --junit-xml=result_${TARGET}_${IDF_VER}_${CONFIG}.xml --build-dir=build_idf-${IDF_VER}_${TARGET}_${CONFIG}"
+XML_REPORT_FILE="result_${TARGET}_${IDF_VER}_${CONFIG}.xml"
 
 for attempt in $(seq 1 $MAX_ATTEMPTS); do
   echo "Pytest attempt ${attempt}/${MAX_ATTEMPTS} for target ${TARGET}, IDF ${IDF_VER}"
@@ -18,6 +18,8 @@ struct _reent *__getreent(void)
     return _GLOBAL_REENT;
 }
 
+#if !CONFIG_ESP_AMP_SUBCORE_FILE_PROXY
+/* file syscalls are forwarded to maincore by esp_amp file proxy if enabled */
 void _fstat_r(void) {}
 
 void _close_r(void) {}
@@ -27,6 +29,7 @@ void _lseek_r(void) {}
 void _read_r(void) {}
 
 void _write_r(void) {}
+#endif
 
 void _getpid_r(void) {}
 
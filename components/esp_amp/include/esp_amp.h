@@ -10,6 +10,10 @@
 #include "esp_amp_sys_info.h"
 #include "esp_amp_event.h"
 #include "esp_amp_queue.h"
+#include "esp_amp_shared_var.h"
+#include "esp_amp_triple_buf.h"
+#include "esp_amp_pool.h"
+#include "esp_amp_copy.h"
 #include "esp_amp_rpmsg.h"
 #include "esp_amp_rpc.h"
 
@@ -0,0 +1,97 @@
+/*
+* SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#pragma once
+
+#include "stdint.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Copy data from or into shared memory
+ *
+ * Moves the body of the buffer 32 bytes per iteration with aligned 32-bit accesses when
+ * `dst` and `src` have the same alignment, and falls back to byte copy otherwise. Unlike
+ * libc memcpy(), behaviour is the same on maincore and subcore and never performs unaligned
+ * access, which is not supported by LP core.
+ *
+ * @param dst destination buffer
+ * @param src source buffer, must not overlap with `dst`
+ * @param size number of bytes to copy
+ *
+ * @retval `dst`
+ *
+ * @note This API can be called in interrupt context.
+ */
+void *esp_amp_copy(void *dst, const void *src, uint32_t size);
+
+/**
+ * Copy kernels used by esp_amp_copy(), exposed for benchmarking
+ *
+ * esp_amp_copy_byte() accepts any alignment. esp_amp_copy_word() and esp_amp_copy_word_x8()
+ * require both `dst` and `src` to be 4-byte aligned. The trailing `size % 4` bytes are copied
+ * byte by byte.
+ */
+void esp_amp_copy_byte(void *dst, const void *src, uint32_t size);
+void esp_amp_copy_word(void *dst, const void *src, uint32_t size);
+void esp_amp_copy_word_x8(void *dst, const void *src, uint32_t size);
+
+/**
+ * Callback invoked when an asynchronous copy is finished
+ *
+ * @param arg user argument passed to esp_amp_copy_async()
+ *
+ * @note may be invoked in interrupt context of the copy backend
+ */
+typedef void (*esp_amp_copy_done_cb_t)(void *arg);
+
+/**
+ * Asynchronous copy backend, e.g. built on GDMA of ESP32-P4 (esp_async_memcpy)
+ */
+typedef struct {
+    /* start copying, invoke `done_cb(arg)` when finished. Return 0 on success, or -1 to let the caller copy by CPU */
+    int (*copy)(void *ctx, void *dst, const void *src, uint32_t size, esp_amp_copy_done_cb_t done_cb, void *arg);
+    void *ctx;              /* backend context passed to `copy` */
+    uint32_t min_size;      /* smaller copies are done by CPU, since setting up DMA costs more than copying */
+    uint32_t align;         /* required alignment of `dst`, `src` and `size`, power of 2. Unaligned copies are done by CPU */
+} esp_amp_copy_backend_t;
+
+/**
+ * Register asynchronous copy backend on this core
+ *
+ * @param backend backend to use, set to NULL to unregister. Must stay valid until unregistered
+ *
+ * @retval ESP_OK successfully register the backend
+ * @retval ESP_ERR_INVALID_ARG `copy` of `backend` is NULL or `align` is not power of 2
+ */
+int esp_amp_copy_register_backend(const esp_amp_copy_backend_t *backend);
+
+/**
+ * Copy data asynchronously if a backend is registered
+ *
+ * Copies which the backend does not accept (too small, unaligned or rejected by the backend) are done
+ * by CPU with esp_amp_copy() before returning, and `done_cb` is invoked from the calling context.
+ *
+ * @param dst destination buffer
+ * @param src source buffer, must not overlap with `dst`
+ * @param size number of bytes to copy
+ * @param done_cb callback invoked when copy is finished, must not be NULL
+ * @param arg argument of `done_cb`
+ *
+ * @retval ESP_OK copy is finished or started
+ * @retval ESP_ERR_INVALID_ARG `done_cb` is NULL
+ *
+ * @note Neither buffer can be accessed until `done_cb` is invoked. With buffers in cached memory,
+ *       the backend is responsible for cache maintenance.
+ */
+int esp_amp_copy_async(void *dst, const void *src, uint32_t size, esp_amp_copy_done_cb_t done_cb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
@@ -16,6 +16,9 @@ extern "C" {
 /**
  * Send an event to notify peer core
  *
+ * @note each event must only be notified from one core. With CONFIG_ESP_AMP_SHARED_MEM_IN_LP,
+ *       notifying an event from both cores asserts
+ *
  * @param sysinfo_id sysinfo id of esp-amp event
  * @param bit_mask event to notify
  * @retval bit mask before notify
@@ -0,0 +1,146 @@
+/*
+* SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#pragma once
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stddef.h"
+#include "esp_err.h"
+
+#include "esp_amp_sys_info.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fixed-block pool handle
+ *
+ * A pool is a set of equally sized blocks in shared memory. Both cores can allocate
+ * blocks from and free blocks to the same pool without locks. A block allocated on one
+ * core can be handed to the other core (e.g. by passing its address in an RPMsg) and
+ * freed there.
+ */
+typedef struct esp_amp_pool_t {
+    void* shm;                  /* shared memory allocated from sysinfo */
+    uint16_t* next;             /* free list link of each block */
+    uint8_t* blocks;            /* base address of blocks */
+    uint16_t block_size;        /* size of each block in byte (aligned) */
+    uint16_t block_num;         /* number of blocks */
+    bool cached;                /* blocks are in cached memory and need cache maintenance */
+} esp_amp_pool_t;
+
+#if IS_MAIN_CORE
+/**
+ * Create a fixed-block pool on main-core
+ *
+ * @param pool                  allocated pool handle to initialize
+ * @param block_size            size of each block in byte
+ * @param block_num             number of blocks (1 ~ 65534)
+ * @param sysinfo_id            sysinfo id of shared memory allocated for the pool
+ *
+ * @retval ESP_OK               successfully create the pool
+ * @retval ESP_ERR_INVALID_ARG  invalid `pool`, `block_size` or `block_num`
+ * @retval ESP_ERR_NO_MEM       insufficient shared memory (sysinfo) space
+ *
+ * @note The pool relies on atomic operations and is allocated from a shared memory region with
+ *       ESP_AMP_SYS_INFO_CAP_ATOMIC. With shared memory in LP RAM, a bulk region in HP RAM is required.
+ */
+int esp_amp_pool_main_init(esp_amp_pool_t* pool, uint16_t block_size, uint16_t block_num, esp_amp_sys_info_id_t sysinfo_id);
+
+/**
+ * Create a fixed-block pool on main-core with blocks in a specific shared memory region
+ *
+ * Free list stays under `sysinfo_id` in a region with ESP_AMP_SYS_INFO_CAP_ATOMIC, while blocks are
+ * allocated from a region providing `block_caps`, e.g. a large cached region for bulk data. Blocks are
+ * aligned to cache line size. If the region is cached (ESP_AMP_SYS_INFO_CAP_CACHED), use
+ * esp_amp_pool_writeback() and esp_amp_pool_invalidate() when handing blocks over between cores.
+ *
+ * @param pool                  allocated pool handle to initialize
+ * @param block_size            size of each block in byte
+ * @param block_num             number of blocks (1 ~ 65534)
+ * @param block_caps            bitwise OR of ESP_AMP_SYS_INFO_CAP_* the region of blocks must provide, 0 to allocate blocks along with free list
+ * @param sysinfo_id            sysinfo id of shared memory allocated for the pool
+ *
+ * @retval ESP_OK               successfully create the pool
+ * @retval ESP_ERR_INVALID_ARG  invalid `pool`, `block_size` or `block_num`
+ * @retval ESP_ERR_NO_MEM       insufficient shared memory (sysinfo) space
+ */
+int esp_amp_pool_main_init_with_caps(esp_amp_pool_t* pool, uint16_t block_size, uint16_t block_num, uint32_t block_caps, esp_amp_sys_info_id_t sysinfo_id);
+#endif
+
+/**
+ * Get a fixed-block pool created by main-core
+ *
+ * @param pool                  allocated pool handle to initialize
+ * @param sysinfo_id            sysinfo id of shared memory allocated for the pool
+ *
+ * @retval ESP_OK               successfully get the pool
+ * @retval ESP_ERR_INVALID_ARG  `pool` is NULL
+ * @retval ESP_ERR_NOT_FOUND    failed to find corresponding sysinfo entry with given sysinfo_id
+ */
+int esp_amp_pool_sub_init(esp_amp_pool_t* pool, esp_amp_sys_info_id_t sysinfo_id);
+
+/**
+ * Allocate a block from pool
+ *
+ * @param pool                  pool handle
+ *
+ * @retval NULL if pool is exhausted
+ * @retval pointer to the allocated block
+ *
+ * @note This API is lock-free and can be called in interrupt context on either core.
+ */
+void* esp_amp_pool_alloc(esp_amp_pool_t* pool);
+
+/**
+ * Free a block to pool
+ *
+ * @param pool                  pool handle
+ * @param block                 block allocated from this pool, on either core
+ *
+ * @retval ESP_OK               successfully free the block
+ * @retval ESP_ERR_INVALID_ARG  `block` does not belong to this pool
+ *
+ * @note This API is lock-free and can be called in interrupt context on either core.
+ */
+int esp_amp_pool_free(esp_amp_pool_t* pool, void* block);
+
+/**
+ * Get the number of free blocks in pool
+ *
+ * @param pool                  pool handle
+ *
+ * @retval number of free blocks. The value may be outdated if the other core is allocating or freeing concurrently
+ */
+uint16_t esp_amp_pool_get_free_num(esp_amp_pool_t* pool);
+
+/**
+ * Write back data of a block before handing it over to the other core
+ *
+ * @param pool                  pool handle
+ * @param block                 block allocated from this pool
+ * @param size                  number of bytes written from start of block
+ *
+ * @note no-op if blocks are not in cached memory
+ */
+void esp_amp_pool_writeback(esp_amp_pool_t* pool, void* block, uint16_t size);
+
+/**
+ * Invalidate a block handed over from the other core before reading it
+ *
+ * @param pool                  pool handle
+ * @param block                 block allocated from this pool
+ * @param size                  number of bytes to read from start of block
+ *
+ * @note no-op if blocks are not in cached memory. Blocks returned by esp_amp_pool_alloc() are already invalidated.
+ */
+void esp_amp_pool_invalidate(esp_amp_pool_t* pool, void* block, uint16_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -37,6 +37,9 @@ typedef struct esp_amp_queue_t {
     void* priv_data;
     uint16_t free_flip_counter;
     uint16_t used_flip_counter;
+    bool cached;                                /* data buffers are in cached memory and need cache maintenance */
+    volatile uint32_t* free_waiting;            /* shared flag, set by `master-core` waiting for a buffer to be freed */
+    esp_amp_queue_cb_t free_notify_fc;          /* This function is used by `remote-core` to notify the opposite side that buffers are freed */
 } esp_amp_queue_t;
 
 typedef struct esp_amp_queue_ops_t {
@@ -51,6 +54,8 @@ typedef struct esp_amp_queue_conf_t {
     uint16_t max_queue_item_size;
     uint8_t* queue_buffer;
     esp_amp_queue_desc_t* queue_desc;
+    uint32_t buffer_caps;                       /* ESP_AMP_SYS_INFO_CAP_* of the region queue_buffer is in */
+    uint32_t free_waiting;                      /* non-zero if `master-core` waits for a buffer to be freed */
 } esp_amp_queue_conf_t;
 
 /**
@@ -91,8 +96,25 @@ int esp_amp_queue_recv_try(esp_amp_queue_t *queue, void** buffer, uint16_t* size
  */
 int esp_amp_queue_alloc_try(esp_amp_queue_t *queue, void** buffer, uint16_t size);
 
+/**
+ * Ask `remote-core` to notify when it frees the next data buffer (must be called on `master-core`)
+ *
+ * Call it after esp_amp_queue_alloc_try() fails, then try to allocate once more before waiting for the
+ * notification, since a buffer may have been freed in between. The request is cleared once notified.
+ *
+ * @param queue                 virtqueue to use
+ *
+ * @retval ESP_OK                   request is recorded in virtqueue
+ * @retval ESP_ERR_NOT_SUPPORTED    expected to be called only on `master-core`
+ */
+int esp_amp_queue_request_free_notify(esp_amp_queue_t *queue);
+
 /**
  * Try to free(give back) the data buffer received from `master-core` (must be called on `remote-core`)
+ *
+ * If `master-core` requested with esp_amp_queue_request_free_notify(), the function set by
+ * esp_amp_queue_free_notify_enable() is invoked after the buffer is freed.
+ *
  * @param queue                 virtqueue to use
  * @param buffer                data buffer to free
  *
@@ -104,6 +126,10 @@ int esp_amp_queue_free_try(esp_amp_queue_t *queue, void* buffer);
 
 /**
  * Initialize the buffer and descriptor of virtqueue, store the virtqueue config in provided structure
+ *
+ * `buffer_caps` of the config is cleared. Set ESP_AMP_SYS_INFO_CAP_CACHED in it afterwards if `queue_buffer`
+ * is in cached memory, so that both sides maintain data cache of the buffers on send and receive.
+ *
  * @param queue_conf            allocated virtqueue config struct to initialize
  * @param queue_len             virtqueue length
  * @param queue_item_size       maximum item size of virtqueue
@@ -159,6 +185,27 @@ int esp_amp_queue_main_init(esp_amp_queue_t* queue, uint16_t queue_len, uint16_t
  */
 int esp_amp_queue_sub_init(esp_amp_queue_t* queue, esp_amp_queue_cb_t cb_func, void* priv_data, bool is_master, esp_amp_sys_info_id_t sysinfo_id);
 
+/**
+ * Initialize a virtqueue in storage with compile-time layout, without SysInfo
+ *
+ * On main-core, descriptors and buffers in `storage` are initialized first, so it must be called on
+ * main-core before subcore is started. On sub-core, the virtqueue is only bound to `storage`. Prefer
+ * ESP_AMP_QUEUE_STATIC_INIT(), which derives `queue_len` and `queue_item_size` from the storage type.
+ *
+ * @param queue                 allocated virtqueue handler to initialize
+ * @param storage               storage declared by ESP_AMP_QUEUE_STATIC_T(), placed in shared memory (e.g. ESP_AMP_STATIC_LAYOUT())
+ * @param queue_len             the length of `Virtqueue`, must be power of 2
+ * @param queue_item_size       the maximum size of each `Virtqueue` element, must be multiple of 4
+ * @param cb_func               callback function, set to `NULL` if not required. When `is_master` is true, it will be invoked after successfully sending data; Otherwise, it will be invoked when receiving new data.
+ * @param priv_data             pointer of arbitrary data which will be passed as the argument when invoking cb_func
+ * @param is_master             whether to initialize as the role of `master-core` for this virtqueue
+ *
+ * @retval ESP_OK               successfully initialize the virtqueue
+ * @retval ESP_ERR_INVALID_ARG  `storage` is NULL, or `queue_len` or `queue_item_size` is inappropriate
+ * @retval ESP_ERR_INVALID_STATE on sub-core, virtqueue initialized by main-core has a different layout
+ */
+int esp_amp_queue_static_init(esp_amp_queue_t* queue, void* storage, uint16_t queue_len, uint16_t queue_item_size, esp_amp_queue_cb_t cb_func, void* priv_data, bool is_master);
+
 /**
  * Enable the virtqueue software interrupt handler, must be invoked when handling incoming data with interrupt on `remote-core`
  *
@@ -171,6 +218,47 @@ int esp_amp_queue_sub_init(esp_amp_queue_t* queue, esp_amp_queue_cb_t cb_func, v
  */
 int esp_amp_queue_intr_enable(esp_amp_queue_t* queue, esp_amp_sw_intr_id_t sw_intr_id);
 
+/**
+ * Set the function to notify `master-core` of freed buffers, e.g. by software interrupt (must be called on `remote-core`)
+ *
+ * @param queue                     virtqueue handler
+ * @param notify_fc                 invoked with `priv_data` of the virtqueue when a buffer is freed while `master-core` waits for it
+ *
+ * @retval ESP_OK                   successfully set the function
+ * @retval ESP_ERR_NOT_SUPPORTED    failed to set, expected to be called only on `remote-core`
+ */
+int esp_amp_queue_free_notify_enable(esp_amp_queue_t* queue, esp_amp_queue_cb_t notify_fc);
+
+#ifdef __cplusplus
+#define ESP_AMP_QUEUE_STATIC_ASSERT(cond, msg) static_assert(cond, msg)
+#else
+#define ESP_AMP_QUEUE_STATIC_ASSERT(cond, msg) _Static_assert(cond, msg)
+#endif
+
+/**
+ * Storage type of a virtqueue with compile-time length and item size
+ *
+ * Layout is identical on both cores as long as both firmware are built from the same declaration.
+ * Invalid sizes are rejected at compile time.
+ */
+#define ESP_AMP_QUEUE_STATIC_T(queue_len, queue_item_size) \
+    struct { \
+        ESP_AMP_QUEUE_STATIC_ASSERT((queue_len) > 0 && (queue_len) <= 0x8000 && ((queue_len) & ((queue_len) - 1)) == 0, "queue_len must be power of 2"); \
+        ESP_AMP_QUEUE_STATIC_ASSERT((queue_item_size) > 0 && (queue_item_size) <= 0xfffc && ((queue_item_size) & 0x3) == 0, "queue_item_size must be multiple of 4"); \
+        esp_amp_queue_conf_t conf; \
+        esp_amp_queue_desc_t desc[queue_len]; \
+        uint32_t buffer[(queue_len) * (queue_item_size) / 4]; \
+    }
+
+#define ESP_AMP_QUEUE_STATIC_LEN(sq)            (sizeof((sq)->desc) / sizeof((sq)->desc[0]))
+#define ESP_AMP_QUEUE_STATIC_ITEM_SIZE(sq)      (sizeof((sq)->buffer) / ESP_AMP_QUEUE_STATIC_LEN(sq))
+
+/**
+ * Initialize a virtqueue in storage declared by ESP_AMP_QUEUE_STATIC_T(), see esp_amp_queue_static_init()
+ */
+#define ESP_AMP_QUEUE_STATIC_INIT(queue, sq, cb_func, priv_data, is_master) \
+    esp_amp_queue_static_init((queue), (sq), ESP_AMP_QUEUE_STATIC_LEN(sq), ESP_AMP_QUEUE_STATIC_ITEM_SIZE(sq), (cb_func), (priv_data), (is_master))
+
 #define ESP_AMP_QUEUE_AVAILABLE_MASK(bit)                       (uint16_t)((uint16_t)(bit) << 7)
 #define ESP_AMP_QUEUE_USED_MASK(bit)                            (uint16_t)((uint16_t)(bit) << 15)
 #define ESP_AMP_QUEUE_FLAG_IS_USED(flipCounter, flag)           (((ESP_AMP_QUEUE_AVAILABLE_MASK(1) & (flag)) != ESP_AMP_QUEUE_AVAILABLE_MASK((flipCounter))) && ((ESP_AMP_QUEUE_USED_MASK(1) & (flag)) != ESP_AMP_QUEUE_USED_MASK((flipCounter))))
@@ -115,6 +115,7 @@ typedef struct {
     esp_amp_rpmsg_ept_t rpmsg_ept;
     void *queue;
     esp_amp_rpc_service_t *srv;
+    uint32_t resp_drop_num;
 } esp_amp_rpc_server_inst_t;
 
 /**
@@ -239,6 +240,17 @@ int esp_amp_rpc_server_add_service(esp_amp_rpc_server_t server, uint16_t cmd_id,
  */
 int esp_amp_rpc_server_del_service(esp_amp_rpc_server_t server, uint16_t cmd_id);
 
+/**
+ * @brief get number of responses dropped by server
+ *
+ * A response is dropped if it still cannot be sent after several retries, e.g. when
+ * rpmsg tx buffers are used up. Client of a dropped response will time out.
+ *
+ * @param server server handle
+ * @retval number of dropped responses, 0 if server is NULL
+ */
+uint32_t esp_amp_rpc_server_get_resp_drop_num(esp_amp_rpc_server_t server);
+
 #if !IS_ENV_BM
 /**
  * @brief rpc server run
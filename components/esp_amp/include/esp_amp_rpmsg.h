@@ -17,8 +17,35 @@ extern "C" {
 #endif
 
 #define ESP_AMP_RPMSG_DATA_DEFAULT      (uint16_t)(0x0)
+#define ESP_AMP_RPMSG_DATA_PACKED       (uint16_t)(0x1)     /* msg_data holds several small rpmsgs, each with its own head */
+#define ESP_AMP_RPMSG_DATA_PACKED_MEMBER (uint16_t)(0x2)    /* rpmsg is a member of a packed rpmsg */
+#define ESP_AMP_RPMSG_DATA_FRAG         (uint16_t)(0x4)     /* rpmsg is a fragment of a larger message */
+#define ESP_AMP_RPMSG_DATA_FRAG_FIRST   (uint16_t)(0x8)     /* first fragment, msg_data starts with uint32_t total length */
+#define ESP_AMP_RPMSG_DATA_FRAG_LAST    (uint16_t)(0x10)    /* last fragment */
+#define ESP_AMP_RPMSG_DATA_CREDIT       (uint16_t)(0x20)    /* msg_data is uint16_t number of credits returned to destination endpoint */
+#define ESP_AMP_RPMSG_DATA_CREDIT_REQ   (uint16_t)(0x40)    /* rpmsg consumed one credit, return it when destroyed */
+#define ESP_AMP_RPMSG_DATA_LANE_MASK    (uint16_t)(0x3000)  /* lane whose virtqueue the rpmsg buffer belongs to */
+#define ESP_AMP_RPMSG_DATA_LANE_SHIFT   12
+#define ESP_AMP_RPMSG_DATA_LANE(lane)   (uint16_t)(((uint16_t)(lane) << ESP_AMP_RPMSG_DATA_LANE_SHIFT) & ESP_AMP_RPMSG_DATA_LANE_MASK)
+
+/* maximum number of virtqueue pairs of one rpmsg device, see esp_amp_rpmsg_main_init_lanes() */
+#define ESP_AMP_RPMSG_MAX_LANES                 4
+
+/* wait until a buffer is available, see esp_amp_rpmsg_create_message_timeout() */
+#define ESP_AMP_RPMSG_MAX_DELAY                 UINT32_MAX
 
 #define ESP_AMP_RPMSG_RESERVED_EPT_SYS_PRT      (uint16_t)(UINT16_MAX)
+#define ESP_AMP_RPMSG_RESERVED_EPT_NS           (uint16_t)(UINT16_MAX - 1)  /* name service endpoint, see esp_amp_rpmsg_ns_enable() */
+
+/* pass as `ept_addr` to esp_amp_rpmsg_create_endpoint() to allocate an unused address in dynamic range */
+#define ESP_AMP_RPMSG_ADDR_ANY                  (uint16_t)(UINT16_MAX - 2)
+#define ESP_AMP_RPMSG_ADDR_DYNAMIC_BASE         (uint16_t)(0x8000)
+#define ESP_AMP_RPMSG_ADDR_DYNAMIC_END          (uint16_t)(0xff00)          /* exclusive */
+
+#define ESP_AMP_RPMSG_NS_NAME_LEN               16
+#define ESP_AMP_RPMSG_NS_CREATE                 (uint16_t)(0x0)     /* endpoint is up */
+#define ESP_AMP_RPMSG_NS_DESTROY                (uint16_t)(0x1)     /* endpoint is gone */
+#define ESP_AMP_RPMSG_NS_SYNC                   (uint16_t)(0x2)     /* name service is up, receiver announces its endpoints again */
 
 typedef struct esp_amp_rpmsg_head_t {
     uint16_t src_addr;                  /* source endpoint address */
@@ -32,13 +59,80 @@ typedef struct esp_amp_rpmsg_t {
     uint8_t msg_data[1];                /* rpmsg data */
 } esp_amp_rpmsg_t;
 
+/**
+ * One fragment of a rpmsg, used to gather data on send and scatter it on receive
+ */
+typedef struct esp_amp_rpmsg_iovec_t {
+    void* data;                         /* fragment buffer */
+    uint16_t len;                       /* fragment length in byte */
+} esp_amp_rpmsg_iovec_t;
+
 typedef int (*esp_amp_ept_cb_t)(void* msg_data, uint16_t data_len, uint16_t src_addr, void* rx_cb_data);
 
+/**
+ * Callback of messages sent by esp_amp_rpmsg_send_large()
+ *
+ * @param data          reassembled message, or one fragment of it when streaming
+ * @param data_len      length of `data`
+ * @param offset        offset of `data` in the message, always 0 for reassembled message
+ * @param total_len     total length of the message
+ * @param src_addr      source endpoint address
+ * @param rx_cb_data    endpoint data pointer
+ *
+ * @note `data` is only valid until the callback returns, and MUST NOT be destroyed
+ */
+typedef int (*esp_amp_ept_frag_cb_t)(void* data, uint32_t data_len, uint32_t offset, uint32_t total_len, uint16_t src_addr, void* rx_cb_data);
+
+struct esp_amp_rpmsg_ept_t;
+
+/**
+ * Message exchanged between name service endpoints of both cores
+ */
+typedef struct esp_amp_rpmsg_ns_msg_t {
+    char name[ESP_AMP_RPMSG_NS_NAME_LEN];   /* endpoint name, not NUL-terminated if it takes whole array */
+    uint16_t addr;                          /* endpoint address */
+    uint16_t flags;                         /* ESP_AMP_RPMSG_NS_* */
+} esp_amp_rpmsg_ns_msg_t;
+
+/**
+ * Callback invoked when peer announces an endpoint
+ *
+ * @param name          NUL-terminated endpoint name
+ * @param addr          endpoint address on peer
+ * @param flags         ESP_AMP_RPMSG_NS_CREATE or ESP_AMP_RPMSG_NS_DESTROY
+ * @param ns_cb_data    data pointer passed to esp_amp_rpmsg_ns_enable()
+ */
+typedef void (*esp_amp_rpmsg_ns_cb_t)(const char* name, uint16_t addr, uint16_t flags, void* ns_cb_data);
+
+/**
+ * Callback invoked when peer endpoint returns credits
+ *
+ * @param ept               endpoint receiving credits
+ * @param tx_credits        number of rpmsgs which can be sent to peer now
+ * @param credit_cb_data    data pointer passed to esp_amp_rpmsg_set_credit()
+ */
+typedef void (*esp_amp_ept_credit_cb_t)(struct esp_amp_rpmsg_ept_t* ept, uint16_t tx_credits, void* credit_cb_data);
+
 typedef struct esp_amp_rpmsg_ept_t {
     esp_amp_ept_cb_t rx_cb;     /* ISR callback function */
     void* rx_cb_data;                       /* ISR callback data */
     struct esp_amp_rpmsg_ept_t* next_ept;    /* Pointer to the next endpoint*/
     uint16_t addr;                          /* endpoint address */
+    uint16_t frag_src_addr;                 /* source of the fragmented message being received */
+    esp_amp_ept_frag_cb_t frag_cb;          /* callback of fragmented messages, NULL to drop them */
+    uint8_t* frag_buf;                      /* reassembly buffer, NULL to stream fragments to frag_cb */
+    uint32_t frag_buf_size;                 /* size of reassembly buffer */
+    uint32_t frag_total;                    /* total length of the fragmented message being received */
+    uint32_t frag_offset;                   /* bytes of it received so far */
+    bool frag_active;                       /* a fragmented message is being received */
+    uint16_t credit_peer_addr;              /* peer endpoint of flow control */
+    uint16_t credit_window;                 /* rpmsgs in flight allowed in each direction, 0 if flow control is disabled */
+    uint16_t tx_credits;                    /* rpmsgs which can still be sent to peer */
+    uint16_t rx_consumed;                   /* rpmsgs from peer destroyed but not credited back yet */
+    esp_amp_ept_credit_cb_t credit_cb;      /* invoked when peer returns credits */
+    void* credit_cb_data;                   /* data pointer passed to credit_cb */
+    const char* ns_name;                    /* name announced to peer, NULL if not announced */
+    uint8_t lane;                           /* lane rpmsgs from this endpoint are sent on */
 } esp_amp_rpmsg_ept_t;
 
 typedef struct esp_amp_rpmsg_dev_t {
@@ -46,6 +140,23 @@ typedef struct esp_amp_rpmsg_dev_t {
     esp_amp_queue_t* tx_queue;
     esp_amp_rpmsg_ept_t* ept_list;
     esp_amp_queue_ops_t queue_ops;
+    esp_amp_rpmsg_t* tx_pack;           /* tx buffer collecting small rpmsgs, NULL if none pending */
+    uint16_t tx_pack_len;               /* bytes of tx_pack already filled */
+    uint16_t tx_pack_flush_size;        /* flush tx_pack once it holds this many bytes, 0 if coalescing is disabled */
+    uint32_t tx_pack_timeout_ms;        /* flush tx_pack at latest this long after its first rpmsg */
+    uint32_t tx_pack_start_ms;          /* time the first rpmsg was packed into tx_pack */
+    bool credit_return_pending;         /* an endpoint failed to return credits and should retry */
+    esp_amp_sw_intr_id_t sw_intr_id;    /* software interrupt used as doorbell in both directions */
+    bool intr_enabled;                  /* esp_amp_rpmsg_intr_enable() succeeded */
+    bool tx_doorbell;                   /* doorbell from peer is handled by interrupt on this core */
+    volatile bool tx_space;             /* doorbell rang while senders wait for tx buffers */
+    uint8_t tx_waiting;                 /* number of senders waiting for tx buffers */
+    void* tx_wait_queue;                /* env queue senders sleep on until doorbell rings, unused on bare-metal */
+    esp_amp_rpmsg_ns_cb_t ns_cb;        /* invoked when peer announces an endpoint */
+    void* ns_cb_data;                   /* data pointer passed to ns_cb */
+    uint8_t lane_num;                   /* number of virtqueue pairs, lane 0 is rx_queue/tx_queue */
+    esp_amp_queue_t* lane_rx_queue[ESP_AMP_RPMSG_MAX_LANES];    /* rx virtqueue of each lane */
+    esp_amp_queue_t* lane_tx_queue[ESP_AMP_RPMSG_MAX_LANES];    /* tx virtqueue of each lane */
 } esp_amp_rpmsg_dev_t;
 
 /* RPMsg Endpoint Management API */
@@ -54,13 +165,14 @@ typedef struct esp_amp_rpmsg_dev_t {
  *
  * Create an endpoint with specific address
  * @param rpmsg_device      rpmsg context
- * @param ept_addr          endpoint address the created endpoint will have
+ * @param ept_addr          endpoint address the created endpoint will have, or ESP_AMP_RPMSG_ADDR_ANY to use an unused address
+ *                          between ESP_AMP_RPMSG_ADDR_DYNAMIC_BASE and ESP_AMP_RPMSG_ADDR_DYNAMIC_END
  * @param ept_rx_cb         endpoint callback triggered in ISR context when receiving incoming messages, set to NULL if don't need
  * @param ept_rx_cb_data    endpoint data pointer saved in endpoint data structure, passed to the callback function when invoked
  * @param ept_ctx           allocated endpoint data structure in advance
  *
- * @retval NULL         endpoint with corresponding address exist, or ept_ctx is NULL
- * @retval ept_ctx      the same pointer as `ept_ctx` passed in
+ * @retval NULL         endpoint with corresponding address exist, no address left in dynamic range, or ept_ctx is NULL
+ * @retval ept_ctx      the same pointer as `ept_ctx` passed in, its `addr` holds the address allocated
  *
  * @note Create an endpoint with specific `ept_addr` and callback function(`ept_rx_cb`).
  *       `ept_rx_cb_data` will be saved in this endpoint data structure and passed to the callback function when invoked.
@@ -78,6 +190,7 @@ esp_amp_rpmsg_ept_t* esp_amp_rpmsg_create_endpoint(esp_amp_rpmsg_dev_t* rpmsg_de
  * @retval NULL             the endpoint with corresponding `ept_addr` doesn't exist
  * @retval ept_ctx          the pointer to the deleted endpoint data structure
  *
+ * @note If the endpoint was announced with esp_amp_rpmsg_ns_announce(), peer is told that it is gone.
  * @note This API MUST NOT be called in interrupt context.
  */
 esp_amp_rpmsg_ept_t* esp_amp_rpmsg_delete_endpoint(esp_amp_rpmsg_dev_t* rpmsg_device, uint16_t ept_addr);
@@ -118,6 +231,8 @@ esp_amp_rpmsg_ept_t* esp_amp_rpmsg_search_endpoint(esp_amp_rpmsg_dev_t* rpmsg_de
  * @retval -1               no more available rpmsg to process at this time
  * @retval 0                successfully polled and processed one rpmsg, maybe still available rpmsg left, should poll again
  *
+ * @note With several lanes, the rpmsg is taken from the highest lane which has one, so each call picks up
+ *       pending high-priority rpmsgs first.
  * @note Should only be called when using polling mechanism.
  */
 int esp_amp_rpmsg_poll(esp_amp_rpmsg_dev_t* rpmsg_dev);
@@ -129,7 +244,7 @@ int esp_amp_rpmsg_poll(esp_amp_rpmsg_dev_t* rpmsg_dev);
  * Create and return a rpmsg buffer to read/write in place and then send with no-copy
  * @param rpmsg_dev         rpmsg context
  * @param nbytes            number of maximum bytes which you want to send with rpmsg
- * @param flags             currently reserved, should always set to ESP_AMP_RPMSG_DATA_DEFAULT
+ * @param flags             ESP_AMP_RPMSG_DATA_DEFAULT, or ESP_AMP_RPMSG_DATA_LANE(lane) to take the buffer from another lane, the rpmsg is then sent on that lane
  *
  * @retval NULL             no available buffer to use / message size is larger than the maximum settings (can use esp_amp_rpmsg_get_max_size to check)
  * @retval void* ptr        successfully get the pointer to the data buffer for read/write (should be subsequently sent with nocopy version API)
@@ -142,6 +257,26 @@ int esp_amp_rpmsg_poll(esp_amp_rpmsg_dev_t* rpmsg_dev);
  */
 void* esp_amp_rpmsg_create_message(esp_amp_rpmsg_dev_t* rpmsg_dev, uint32_t nbytes, uint16_t flags);
 
+/**
+ * Create a rpmsg buffer like `esp_amp_rpmsg_create_message()`, waiting for the other side to give one back if all are in use
+ *
+ * The other side rings a doorbell (software interrupt) when it frees a buffer while this side is waiting.
+ * When `esp_amp_rpmsg_intr_enable()` has been called, the caller sleeps until then: FreeRTOS task blocks,
+ * and bare-metal core stalls in WFI if `timeout_ms` is ESP_AMP_RPMSG_MAX_DELAY. Otherwise it checks for free
+ * buffers periodically.
+ *
+ * @param rpmsg_dev         rpmsg context
+ * @param nbytes            number of maximum bytes which you want to send with rpmsg
+ * @param flags             ESP_AMP_RPMSG_DATA_DEFAULT, or ESP_AMP_RPMSG_DATA_LANE(lane), see esp_amp_rpmsg_create_message()
+ * @param timeout_ms        maximum time to wait, 0 to return immediately, ESP_AMP_RPMSG_MAX_DELAY to wait forever
+ *
+ * @retval NULL             timeout / message size is larger than the maximum settings
+ * @retval void* ptr        successfully get the pointer to the data buffer, MUST be sent subsequently with esp_amp_rpmsg_send_nocopy()
+ *
+ * @note In interrupt context, it never waits and behaves like `esp_amp_rpmsg_create_message()`
+ */
+void* esp_amp_rpmsg_create_message_timeout(esp_amp_rpmsg_dev_t* rpmsg_dev, uint32_t nbytes, uint16_t flags, uint32_t timeout_ms);
+
 /**
  * Send the data buffer(rpmsg) allocated with `esp_amp_rpmsg_create_message()` to the other side without copy
  *
@@ -153,6 +288,7 @@ void* esp_amp_rpmsg_create_message(esp_amp_rpmsg_dev_t* rpmsg_dev, uint32_t nbyt
  *
  * @retval 0                successfully send the data buffer to the other side
  * @retval -1               fatal error happens internally / data_len is larger than the maximum settings (can use esp_amp_rpmsg_get_max_size to check)
+ *                          / no credit left to send to `dst_addr` (see esp_amp_rpmsg_set_credit()), the buffer is kept and can be sent again later
  *
  * @note MUST be used along with the buffer allocated by `esp_amp_rpmsg_create_message()`. Otherwise, it will cause UNDEFINED BEHAVIOR!
  * @note This API should ALWAYS succeed and return immediately if used correctly. Any errors reported by this API indicate the fatal error of rpmsg framework
@@ -170,7 +306,7 @@ int esp_amp_rpmsg_send_nocopy(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_
  * @param data_len          the size of data to send(byte), this should be smaller than the maximum settings (can use esp_amp_rpmsg_get_max_size to check)
  *
  * @retval 0                successfully copy and send the data
- * @retval -1               data_len exceeds the maximum settings (can use esp_amp_rpmsg_get_max_size() to check), or there is no available buffer for use at present (should retry later)
+ * @retval -1               data_len exceeds the maximum settings (can use esp_amp_rpmsg_get_max_size() to check), or there is no available buffer or credit for use at present (should retry later)
 
  * @note This API will internally allocate the rpmsg data buffer, copy the data from user-provided pointer to the rpmsg data buffer, and then send it.
  * @note MUST be used standalone and without invoking `esp_amp_rpmsg_create_message()`. Otherwise, the buffer allocated by `esp_amp_rpmsg_create_message()` will never be able to be used again
@@ -178,6 +314,159 @@ int esp_amp_rpmsg_send_nocopy(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_
  */
 int esp_amp_rpmsg_send(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, void* data, uint16_t data_len);
 
+/**
+ * Gather several fragments into one rpmsg and send it to the other side
+ *
+ * @param rpmsg_dev         rpmsg context
+ * @param ept               pointer to endpoint context, indicating the identity of sender
+ * @param dst_addr          destination address of the target endpoint to send
+ * @param iov               array of fragments, sent in order. Fragments with zero `len` are skipped
+ * @param iov_cnt           number of fragments in `iov`
+ *
+ * @retval 0                successfully copy and send the data
+ * @retval -1               total length is zero or exceeds the maximum settings (can use esp_amp_rpmsg_get_max_size() to check), or there is no available buffer for use at present (should retry later)
+ *
+ * @note Each fragment is copied once, straight into the rpmsg data buffer. Typical use is a protocol header
+ *       followed by user payload, without assembling them in an intermediate buffer first.
+ * @note MUST be used standalone and without invoking `esp_amp_rpmsg_create_message()`
+ * @note This API can be used in interrupt context
+ */
+int esp_amp_rpmsg_sendv(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, const esp_amp_rpmsg_iovec_t* iov, uint16_t iov_cnt);
+
+/**
+ * Scatter received rpmsg data into several fragments
+ *
+ * Counterpart of esp_amp_rpmsg_sendv() on receiver side, usually called in endpoint callback
+ * before `esp_amp_rpmsg_destroy()`.
+ *
+ * @param msg_data          pointer to the received rpmsg data buffer
+ * @param data_len          length of received data
+ * @param iov               array of fragments, filled in order. Fragments with NULL `data` skip `len` bytes
+ * @param iov_cnt           number of fragments in `iov`
+ *
+ * @retval size             number of bytes consumed from `msg_data`, less than `data_len` if fragments are too short
+ *
+ * @note This API can be used in interrupt context
+ */
+uint16_t esp_amp_rpmsg_scatter(const void* msg_data, uint16_t data_len, const esp_amp_rpmsg_iovec_t* iov, uint16_t iov_cnt);
+
+/**
+ * Send a message of any length, split into fragments
+ *
+ * The message is split into as many rpmsgs as needed, each flagged with ESP_AMP_RPMSG_DATA_FRAG, and
+ * reassembled or streamed on receiver side according to esp_amp_rpmsg_set_frag_rx() of the destination
+ * endpoint. Fragments are sent back to back as long as the virtqueue has free buffers, and this API only
+ * waits when all buffers are in flight, so a transfer larger than the virtqueue is pipelined.
+ *
+ * @param rpmsg_dev         rpmsg context
+ * @param ept               pointer to endpoint context, indicating the identity of sender
+ * @param dst_addr          destination address of the target endpoint to send
+ * @param data              pointer to the data to be sent
+ * @param data_len          the size of data to send(byte)
+ * @param timeout_ms        maximum time in total to wait for free buffers, set to 0 to fail immediately when virtqueue is full
+ *
+ * @retval 0                successfully copy and send all fragments
+ * @retval -1               invalid arguments, or timeout waiting for free buffers. Fragments already sent are dropped by receiver
+ *
+ * @note Transfers to the same destination endpoint MUST NOT be interleaved, serialize them on sender side
+ * @note This API MUST NOT be called in interrupt context unless `timeout_ms` is 0
+ */
+int esp_amp_rpmsg_send_large(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, const void* data, uint32_t data_len, uint32_t timeout_ms);
+
+/**
+ * Set how an endpoint receives messages sent by esp_amp_rpmsg_send_large()
+ *
+ * With a reassembly buffer, fragments are copied into `buf` and `frag_cb` is invoked once with the whole
+ * message. Messages larger than `buf_size` are dropped. Without a reassembly buffer, `frag_cb` is invoked
+ * for each fragment in order, with its offset in the message. In both cases, fragment rpmsgs are destroyed
+ * by rpmsg framework after `frag_cb` returns.
+ *
+ * @param ept               endpoint to configure
+ * @param frag_cb           callback of fragmented messages, invoked in the same context as endpoint callback. Set to NULL to drop them
+ * @param buf               reassembly buffer, set to NULL to stream fragments
+ * @param buf_size          size of reassembly buffer
+ *
+ * @retval 0                successfully configure the endpoint
+ * @retval -1               `ept` is NULL
+ *
+ * @note Fragments of one message from different source endpoints can not be received at the same time. A fragment
+ *       from another source is dropped until the current message is complete or a new first fragment arrives
+ */
+int esp_amp_rpmsg_set_frag_rx(esp_amp_rpmsg_ept_t* ept, esp_amp_ept_frag_cb_t frag_cb, void* buf, uint32_t buf_size);
+
+/**
+ * Enable credit-based flow control between an endpoint and its peer endpoint on the other core
+ *
+ * Both endpoints of the pair MUST be configured with the same `window` before exchanging rpmsgs. Each
+ * endpoint can then have at most `window` rpmsgs to its peer not destroyed yet by the peer. Sending more
+ * fails immediately with -1 without taking a virtqueue buffer, instead of starving other endpoints.
+ * Credits are returned on a control rpmsg flagged ESP_AMP_RPMSG_DATA_CREDIT once the peer has destroyed
+ * half of the window, and `credit_cb` is invoked on the sender, e.g. to wake up a task waiting to send.
+ *
+ * Only rpmsgs from `ept` to `peer_addr` are counted. They are never coalesced. Fragments sent by
+ * esp_amp_rpmsg_send_large() count one credit each, and it waits for credits like it waits for buffers.
+ *
+ * @param ept               endpoint to configure
+ * @param peer_addr         address of peer endpoint on the other core
+ * @param window            number of rpmsgs allowed in flight, set to 0 to disable flow control
+ * @param credit_cb         callback invoked in the receiving context when credits are returned, set to NULL if not required
+ * @param credit_cb_data    data pointer passed to `credit_cb`
+ *
+ * @retval 0                successfully configure flow control
+ * @retval -1               `ept` is NULL
+ *
+ * @note To guarantee capacity to each endpoint, keep the sum of windows within the virtqueue length and leave
+ *       room for control rpmsgs in the opposite direction
+ */
+int esp_amp_rpmsg_set_credit(esp_amp_rpmsg_ept_t* ept, uint16_t peer_addr, uint16_t window, esp_amp_ept_credit_cb_t credit_cb, void* credit_cb_data);
+
+/**
+ * Get the number of rpmsgs an endpoint can send to its flow control peer now
+ *
+ * @param ept               endpoint with flow control enabled
+ *
+ * @retval credits          number of rpmsgs which can be sent, UINT16_MAX if flow control is disabled
+ */
+uint16_t esp_amp_rpmsg_get_credit(esp_amp_rpmsg_ept_t* ept);
+
+/**
+ * Enable or disable coalescing of small rpmsgs on this core
+ *
+ * With coalescing enabled, rpmsgs sent by esp_amp_rpmsg_send() and esp_amp_rpmsg_sendv() which take no more
+ * than `flush_size` bytes (data plus 8-byte head, rounded up to 4 bytes) are packed into one virtqueue buffer
+ * and sent together, using one virtqueue slot and one notification. The packed buffer is sent when it holds
+ * `flush_size` bytes or the next rpmsg does not fit, when esp_amp_rpmsg_flush() is called, or when it has been
+ * pending for `flush_timeout_ms` at the next send or esp_amp_rpmsg_poll() on this core. Larger rpmsgs and those
+ * sent by esp_amp_rpmsg_send_nocopy() flush pending rpmsgs first, so order is preserved. Only rpmsgs on lane 0
+ * are coalesced, see esp_amp_rpmsg_set_lane().
+ *
+ * Receiver unpacks coalesced rpmsgs transparently. Each of them is passed to its endpoint callback and
+ * MUST be destroyed with esp_amp_rpmsg_destroy() as usual.
+ *
+ * @param rpmsg_dev         rpmsg context
+ * @param flush_size        flush packed rpmsgs once they take this many bytes, capped to the virtqueue buffer. Set to 0 to disable coalescing
+ * @param flush_timeout_ms  maximum time rpmsgs stay packed before they are sent, checked at next send or poll. Set to 0 to flush on size and esp_amp_rpmsg_flush() only
+ *
+ * @retval 0                successfully configure coalescing
+ * @retval -1               failed to send pending rpmsgs when disabling coalescing
+ *
+ * @note This API can be used in interrupt context
+ */
+int esp_amp_rpmsg_set_coalescing(esp_amp_rpmsg_dev_t* rpmsg_dev, uint16_t flush_size, uint32_t flush_timeout_ms);
+
+/**
+ * Send rpmsgs packed by coalescing immediately
+ *
+ * @param rpmsg_dev         rpmsg context
+ *
+ * @retval 0                successfully send pending rpmsgs, or nothing to send
+ * @retval -1               fatal error happens internally
+ *
+ * @note Call it from a periodic timer if rpmsgs must not wait for the next send or poll
+ * @note This API can be used in interrupt context
+ */
+int esp_amp_rpmsg_flush(esp_amp_rpmsg_dev_t* rpmsg_dev);
+
 /**
  * Get the maximum settings of data size which one rpmsg can send at most
  * @param rpmsg_dev         rpmsg context
@@ -220,6 +509,35 @@ int esp_amp_rpmsg_destroy(esp_amp_rpmsg_dev_t* rpmsg_dev, void* msg_data);
  */
 int esp_amp_rpmsg_main_init_by_id(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id);
 
+/**
+ * Initialize the rpmsg framework on main-core with several lanes
+ *
+ * Each lane is a pair of virtqueues of its own, so rpmsgs on one lane never wait for free buffers or
+ * virtqueue slots of another one. Lanes are ordered by priority: receiver drains lane `lane_num - 1`
+ * first and lane 0 last. Endpoints send on lane 0 unless assigned to another with esp_amp_rpmsg_set_lane(),
+ * e.g. a control endpoint on lane 1 is not held up behind bulk data on lane 0. All lanes share one
+ * software interrupt.
+ *
+ * The SysInfo entry starts with `lane_num`, followed by configuration of all virtqueues ahead of their
+ * descriptors, lane by lane, main-to-sub virtqueue first. With `lane_num` 1 the layout is the same as
+ * esp_amp_rpmsg_main_init_by_id().
+ *
+ * @param rpmsg_dev         rpmsg context, should be allocated in advance, either statically or dynamically
+ * @param rpmsg_vqueue      array of `2 * lane_num` virtqueue handlers, allocated in advance
+ * @param lane_num          number of lanes, 1 ~ ESP_AMP_RPMSG_MAX_LANES
+ * @param queue_len         the length of `Virtqueue` of each lane
+ * @param queue_item_size   the maximum size of each `Virtqueue` element (including header), same on all lanes
+ * @param notify            whether to notify the other side after sending the data (send software interrupt)
+ * @param poll              whether to use the polling mechanism on this specific core, if set to false, then `esp_amp_rpmsg_intr_enable()` MUST be called later
+ * @param sysinfo_id        sysinfo id of shared memory allocated for rpmsg queue buffer
+ *
+ * @retval 0                successfully initialize the rpmsg framework
+ * @retval -1               invalid arguments, or failed to allocate shared memory
+ *
+ * @note Subcore MUST call esp_amp_rpmsg_sub_init_lanes() with the same `lane_num`
+ */
+int esp_amp_rpmsg_main_init_lanes(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], uint8_t lane_num, uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id);
+
 /**
  * Initialize the rpmsg framework on main-core
  * @param rpmsg_dev         rpmsg context, should be allocated in advance, either statically or dynamically
@@ -251,6 +569,22 @@ int esp_amp_rpmsg_main_init(esp_amp_rpmsg_dev_t* rpmsg_dev, uint16_t queue_len,
  */
 int esp_amp_rpmsg_sub_init_by_id(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id);
 
+/**
+ * Initialize the rpmsg framework on sub-core with several lanes, see esp_amp_rpmsg_main_init_lanes()
+ * @param rpmsg_dev         rpmsg context, should be allocated in advance, either statically or dynamically
+ * @param rpmsg_vqueue      array of `2 * lane_num` virtqueue handlers, allocated in advance
+ * @param lane_num          number of lanes, the same as on main-core
+ * @param notify            whether to notify the other side after sending the data (send software interrupt)
+ * @param poll              whether to use the polling mechanism on this specific core, if set to false, then `esp_amp_rpmsg_intr_enable()` MUST be called later
+ * @param sysinfo_id        sysinfo id of shared memory allocated for rpmsg queue buffer
+ *
+ * @retval 0                successfully initialize the rpmsg framework
+ * @retval -1               invalid `lane_num`, `lane_num` differs from main-core, or shared memory not found
+ *
+ * @note this api MUST be called before any other rpmsg APIs on subcore
+ */
+int esp_amp_rpmsg_sub_init_lanes(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], uint8_t lane_num, bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id);
+
 /**
  * Initialize the rpmsg framework on sub-core
  * @param rpmsg_dev         rpmsg context, should be allocated in advance, either statically or dynamically
@@ -264,6 +598,129 @@ int esp_amp_rpmsg_sub_init_by_id(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t
  */
 int esp_amp_rpmsg_sub_init(esp_amp_rpmsg_dev_t* rpmsg_dev, bool notify, bool poll);
 
+/**
+ * Storage type of rpmsg virtqueues with compile-time length and item size
+ *
+ * `vq[0]` carries messages from main-core to sub-core, `vq[1]` from sub-core to main-core.
+ */
+#define ESP_AMP_RPMSG_STATIC_T(queue_len, queue_item_size) \
+    ESP_AMP_RPMSG_STATIC_LANES_T(1, queue_len, queue_item_size)
+
+/**
+ * Storage type of rpmsg virtqueues with several lanes, see esp_amp_rpmsg_main_init_lanes()
+ *
+ * `vq[2 * lane]` carries messages of `lane` from main-core to sub-core, `vq[2 * lane + 1]` from sub-core to main-core.
+ */
+#define ESP_AMP_RPMSG_STATIC_LANES_T(lane_num, queue_len, queue_item_size) \
+    struct { \
+        ESP_AMP_QUEUE_STATIC_T(queue_len, queue_item_size) vq[2 * (lane_num)]; \
+    }
+
+#define ESP_AMP_RPMSG_STATIC_LANE_NUM(srpmsg)   (sizeof((srpmsg)->vq) / sizeof((srpmsg)->vq[0]) / 2)
+
+/**
+ * Initialize the rpmsg framework in storage with compile-time layout, without SysInfo
+ *
+ * Can be called on either core. Main-core initializes the virtqueues in `storage`, so it must be
+ * called on main-core before subcore is started. Prefer ESP_AMP_RPMSG_STATIC_INIT(), which derives
+ * `queue_len` and `queue_item_size` from the storage type.
+ *
+ * @param rpmsg_dev         rpmsg context, should be allocated in advance, either statically or dynamically
+ * @param rpmsg_vqueue      array of 2 virtqueue handlers, allocated in advance
+ * @param storage           storage declared by ESP_AMP_RPMSG_STATIC_T(), placed in shared memory (e.g. ESP_AMP_STATIC_LAYOUT())
+ * @param queue_len         the length of `Virtqueue`, must be power of 2
+ * @param queue_item_size   the maximum size of each `Virtqueue` element (including header), must be multiple of 4
+ * @param notify            whether to notify the other side after sending the data (send software interrupt)
+ * @param poll              whether to use the polling mechanism on this specific core, if set to false, then `esp_amp_rpmsg_intr_enable()` MUST be called later
+ *
+ * @retval 0                successfully initialize the rpmsg framework
+ * @retval -1               invalid arguments, or layout differs from the one initialized by main-core
+ */
+int esp_amp_rpmsg_static_init(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], void* storage, uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll);
+
+/**
+ * Initialize the rpmsg framework with several lanes in storage declared by ESP_AMP_RPMSG_STATIC_LANES_T()
+ *
+ * Same as esp_amp_rpmsg_static_init(), with `rpmsg_vqueue` holding `2 * lane_num` virtqueue handlers.
+ *
+ * @retval 0                successfully initialize the rpmsg framework
+ * @retval -1               invalid arguments, or layout differs from the one initialized by main-core
+ */
+int esp_amp_rpmsg_static_init_lanes(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], void* storage, uint8_t lane_num, uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll);
+
+/* works with storage declared by either ESP_AMP_RPMSG_STATIC_T() or ESP_AMP_RPMSG_STATIC_LANES_T() */
+#define ESP_AMP_RPMSG_STATIC_INIT(rpmsg_dev, rpmsg_vqueue, srpmsg, notify, poll) \
+    esp_amp_rpmsg_static_init_lanes((rpmsg_dev), (rpmsg_vqueue), (srpmsg), ESP_AMP_RPMSG_STATIC_LANE_NUM(srpmsg), ESP_AMP_QUEUE_STATIC_LEN(&(srpmsg)->vq[0]), ESP_AMP_QUEUE_STATIC_ITEM_SIZE(&(srpmsg)->vq[0]), (notify), (poll))
+
+/**
+ * Enable name service on a rpmsg device
+ *
+ * Creates the name service endpoint at ESP_AMP_RPMSG_RESERVED_EPT_NS and asks peer to announce its endpoints
+ * again, so announcements sent before this core was ready are not lost.
+ *
+ * @param rpmsg_dev         rpmsg context
+ * @param ns_ept_ctx        allocated endpoint data structure for name service endpoint
+ * @param ns_cb             invoked in endpoint callback context when peer announces an endpoint, set to NULL if don't need
+ * @param ns_cb_data        data pointer passed to `ns_cb`
+ *
+ * @retval 0                successfully enable name service
+ * @retval -1               name service is already enabled, or invalid arguments
+ *
+ * @note This API MUST NOT be called in interrupt context.
+ */
+int esp_amp_rpmsg_ns_enable(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ns_ept_ctx, esp_amp_rpmsg_ns_cb_t ns_cb, void* ns_cb_data);
+
+/**
+ * Announce an endpoint to peer under a name, or withdraw it
+ *
+ * @param rpmsg_dev         rpmsg context
+ * @param ept               endpoint to announce
+ * @param name              endpoint name, at most ESP_AMP_RPMSG_NS_NAME_LEN characters. MUST stay valid while announced
+ * @param flags             ESP_AMP_RPMSG_NS_CREATE or ESP_AMP_RPMSG_NS_DESTROY
+ *
+ * @retval 0                announcement is sent
+ * @retval -1               invalid arguments, or no available buffer. An endpoint announced is re-announced anyway when peer enables name service
+ *
+ * @note This API can be called in interrupt context.
+ */
+int esp_amp_rpmsg_ns_announce(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, const char* name, uint16_t flags);
+
+/**
+ * Assign an endpoint to a lane of its rpmsg device
+ *
+ * All rpmsgs sent from the endpoint, including flow control and name service rpmsgs, take buffers from and
+ * are queued on virtqueues of this lane. Rpmsgs on lanes other than 0 are never coalesced.
+ *
+ * @param rpmsg_dev         rpmsg context
+ * @param ept               endpoint to assign
+ * @param lane              0 ~ number of lanes of `rpmsg_dev` - 1, higher lane is received first
+ *
+ * @retval 0                successfully assign the endpoint
+ * @retval -1               `ept` is NULL or `lane` does not exist
+ *
+ * @note Peer endpoint does not need to be on the same lane, lanes only decide which virtqueues carry rpmsgs of
+ *       this endpoint. Do not change the lane while rpmsgs created with the old lane are not sent yet.
+ */
+int esp_amp_rpmsg_set_lane(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint8_t lane);
+
+/**
+ * Use a dedicated software interrupt for a rpmsg device instead of SW_INTR_RESERVED_ID_RPMSG
+ *
+ * Devices sharing one software interrupt are all polled whenever it is triggered. With a dedicated
+ * one, e.g. a latency-critical control channel is not held up by draining a bulk data channel, and
+ * can be given a higher priority class.
+ *
+ * @param rpmsg_dev         rpmsg context
+ * @param sw_intr_id        SW_INTR_ID_0 ~ SW_INTR_ID_15, or SW_INTR_RESERVED_ID_RPMSG. MUST be the same on both cores
+ * @param prio              priority class of `sw_intr_id` on local core, see esp_amp_sw_intr_set_priority()
+ *
+ * @retval 0                successfully set the software interrupt
+ * @retval -1               invalid `sw_intr_id` or `prio`, or `esp_amp_rpmsg_intr_enable()` has been called
+ *
+ * @note Call it on both cores after initializing the rpmsg framework and before `esp_amp_rpmsg_intr_enable()`
+ */
+int esp_amp_rpmsg_set_intr_id(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_sw_intr_id_t sw_intr_id, esp_amp_sw_intr_prio_t prio);
+
 /**
  * Enable the rpmsg framework software interrupt handler, MUST be called when poll is set to false when initializing the rpmsg framework
  * @param rpmsg_dev         rpmsg context
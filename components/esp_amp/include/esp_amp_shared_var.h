@@ -0,0 +1,119 @@
+/*
+* SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#pragma once
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "esp_err.h"
+
+#include "esp_amp_sys_info.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Shared variable handle
+ *
+ * A shared variable is a fixed-size record in shared memory protected by a
+ * sequence lock. Only the latest value is kept: the writer overwrites the record
+ * in place without waiting for readers, and readers retry if they observe a
+ * record which is being updated.
+ */
+typedef struct esp_amp_shared_var_t {
+    void* shm;                  /* shared memory record allocated from sysinfo */
+    uint16_t size;              /* size of the value in byte */
+    uint16_t notify_id;         /* sysinfo id of esp-amp event to notify after each write */
+    uint32_t notify_mask;       /* event bits to notify after each write, 0 to disable */
+} esp_amp_shared_var_t;
+
+#if IS_MAIN_CORE
+/**
+ * Create a shared variable on main-core
+ *
+ * @param var                   allocated shared variable handle to initialize
+ * @param size                  size of the value in byte
+ * @param sysinfo_id            sysinfo id of shared memory allocated for the shared variable
+ *
+ * @retval ESP_OK               successfully create the shared variable
+ * @retval ESP_ERR_INVALID_ARG  `var` is NULL, `size` is 0 or too large to fit into a sysinfo block with its header
+ * @retval ESP_ERR_NO_MEM       insufficient shared memory (sysinfo) space
+ */
+int esp_amp_shared_var_main_init(esp_amp_shared_var_t* var, uint16_t size, esp_amp_sys_info_id_t sysinfo_id);
+#endif
+
+/**
+ * Get a shared variable created by main-core
+ *
+ * @param var                   allocated shared variable handle to initialize
+ * @param sysinfo_id            sysinfo id of shared memory allocated for the shared variable
+ *
+ * @retval ESP_OK               successfully get the shared variable
+ * @retval ESP_ERR_INVALID_ARG  `var` is NULL
+ * @retval ESP_ERR_NOT_FOUND    failed to find corresponding sysinfo entry with given sysinfo_id
+ */
+int esp_amp_shared_var_sub_init(esp_amp_shared_var_t* var, esp_amp_sys_info_id_t sysinfo_id);
+
+/**
+ * Notify an esp-amp event after each write
+ *
+ * @param var                   shared variable handle
+ * @param event_id              sysinfo id of esp-amp event to notify
+ * @param bit_mask              event bits to notify, 0 to disable notification
+ *
+ * @note notification is optional. Readers which poll the shared variable do not need it.
+ */
+void esp_amp_shared_var_set_notify(esp_amp_shared_var_t* var, uint16_t event_id, uint32_t bit_mask);
+
+/**
+ * Publish a new value of the shared variable
+ *
+ * @param var                   shared variable handle
+ * @param data                  pointer to the new value
+ * @param size                  size of the new value, must be equal to the size of shared variable
+ *
+ * @retval ESP_OK                   successfully publish the new value
+ * @retval ESP_ERR_INVALID_SIZE     `size` does not match the size of shared variable
+ *
+ * @note This API never waits for readers and can be called in interrupt context.
+ * @note There must be only one writer of a shared variable at any time. Writing from
+ *       both cores or from task and ISR on the same core concurrently corrupts the value.
+ */
+int esp_amp_shared_var_write(esp_amp_shared_var_t* var, const void* data, uint16_t size);
+
+/**
+ * Read the latest value of the shared variable
+ *
+ * @param var                   shared variable handle
+ * @param data                  buffer to store the value
+ * @param size                  size of the buffer, must be equal to the size of shared variable
+ * @param seq                   optional pointer to store the sequence number of the value read, set to NULL if not required
+ *
+ * @retval ESP_OK                   successfully read a consistent value
+ * @retval ESP_ERR_INVALID_SIZE     `size` does not match the size of shared variable
+ * @retval ESP_ERR_TIMEOUT          writer kept updating the value and no consistent copy was observed after retrying
+ *
+ * @note This API can be called in interrupt context. Retries back off from 1us to 32us, so a read
+ *       racing with a busy writer may take up to about 1ms before it gives up.
+ */
+int esp_amp_shared_var_read(esp_amp_shared_var_t* var, void* data, uint16_t size, uint32_t* seq);
+
+/**
+ * Get the sequence number of the shared variable
+ *
+ * Sequence number increases by 2 on each write. An odd number indicates an update is in progress.
+ * Readers can compare sequence numbers to check whether a new value is published without copying it.
+ *
+ * @param var                   shared variable handle
+ *
+ * @retval sequence number
+ */
+uint32_t esp_amp_shared_var_get_seq(esp_amp_shared_var_t* var);
+
+#ifdef __cplusplus
+}
+#endif
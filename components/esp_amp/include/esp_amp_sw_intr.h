@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "stdint.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -45,6 +47,20 @@ typedef enum {
     SW_INTR_ID_MAX = 31,
 } esp_amp_sw_intr_id_t;
 
+/**
+ * Software interrupt priority class
+ *
+ * Pending software interrupts are dispatched class by class, from high to low. Between
+ * two handlers of normal or low class, newly arrived high class interrupts are served first.
+ * All classes are dispatched in ISR context: low class is not deferred to a task, it only
+ * runs after the other classes.
+ */
+typedef enum {
+    SW_INTR_PRIO_HIGH = 0,
+    SW_INTR_PRIO_NORMAL,
+    SW_INTR_PRIO_LOW,
+} esp_amp_sw_intr_prio_t;
+
 /**
  * Software Interrupt Handler
  *
@@ -72,6 +88,30 @@ int esp_amp_sw_intr_add_handler(esp_amp_sw_intr_id_t intr_id, esp_amp_sw_intr_ha
  */
 void esp_amp_sw_intr_delete_handler(esp_amp_sw_intr_id_t intr_id, esp_amp_sw_intr_handler_t handler);
 
+/**
+ * Set the priority class of a software interrupt on local core
+ *
+ * By default, SW_INTR_RESERVED_ID_EVENT and SW_INTR_RESERVED_ID_PANIC are of high priority class,
+ * all other software interrupts are of normal priority class.
+ *
+ * @param[in] intr_id identifier of the software interrupt
+ * @param[in] prio priority class of the software interrupt
+ *
+ * @retval 0 if successful
+ * @retval -1 invalid intr_id or prio
+ */
+int esp_amp_sw_intr_set_priority(esp_amp_sw_intr_id_t intr_id, esp_amp_sw_intr_prio_t prio);
+
+/**
+ * Get the priority class of a software interrupt on local core
+ *
+ * @param[in] intr_id identifier of the software interrupt
+ *
+ * @retval priority class (esp_amp_sw_intr_prio_t) of the software interrupt
+ * @retval -1 invalid intr_id
+ */
+int esp_amp_sw_intr_get_priority(esp_amp_sw_intr_id_t intr_id);
+
 /**
  * Trigger an software interrupt on peer core
  *
@@ -79,6 +119,17 @@ void esp_amp_sw_intr_delete_handler(esp_amp_sw_intr_id_t intr_id, esp_amp_sw_int
  */
 void esp_amp_sw_intr_trigger(esp_amp_sw_intr_id_t intr_id);
 
+/**
+ * Get the number of triggers coalesced into a previously raised interrupt
+ *
+ * When CONFIG_ESP_AMP_SW_INTR_COALESCE is enabled, esp_amp_sw_intr_trigger() only raises the
+ * hardware interrupt on peer core if peer core has no pending software interrupt. Otherwise,
+ * the trigger only sets its pending bit and is counted here.
+ *
+ * @retval number of coalesced triggers issued by local core, always 0 if coalescing is disabled
+ */
+uint32_t esp_amp_sw_intr_get_coalesced_count(void);
+
 /**
  * Dump the software interrupt handler table (for debug use)
  */
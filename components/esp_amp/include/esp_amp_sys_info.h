@@ -7,6 +7,7 @@
 #pragma once
 
 #include "stdint.h"
+#include "sdkconfig.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,9 +19,45 @@ typedef enum {
     SYS_INFO_RESERVED_ID_EVENT_SUB,  /* reserved for sub core event */
     SYS_INFO_RESERVED_ID_VQUEUE,     /* store shared queue (packed virt queue) data structure and buffer */
     SYS_INFO_RESERVED_ID_SYSTEM, /* reserved for system service */
+    SYS_INFO_RESERVED_ID_LOG,    /* reserved for subcore log ring */
+    SYS_INFO_RESERVED_ID_FILE,   /* reserved for subcore file proxy */
     SYS_INFO_ID_MAX = 0xffff, /* max number of sys info */
 } esp_amp_sys_info_id_t;
 
+/* capabilities of shared memory regions managed by sys info */
+#define ESP_AMP_SYS_INFO_CAP_CONTROL    (1 << 0)    /* small region for control structures (default region) */
+#define ESP_AMP_SYS_INFO_CAP_BULK       (1 << 1)    /* large region for data buffers */
+#define ESP_AMP_SYS_INFO_CAP_CACHED     (1 << 2)    /* region accessed through cache, needs writeback/invalidate across cores */
+#define ESP_AMP_SYS_INFO_CAP_ATOMIC     (1 << 3)    /* region supports atomic read-modify-write from both cores */
+
+/**
+ * Base address of static layout area in control shared memory
+ *
+ * The area is reserved by CONFIG_ESP_AMP_SHARED_MEM_STATIC_SIZE at the same address on
+ * both cores. Use ESP_AMP_STATIC_LAYOUT() to access it.
+ */
+extern uint8_t* const esp_amp_sys_info_static_mem;
+
+/**
+ * Access static layout area as a struct shared by maincore and subcore firmware
+ *
+ * Define the struct in a header included by both firmware, with channels declared by
+ * ESP_AMP_QUEUE_STATIC_T() or ESP_AMP_RPMSG_STATIC_T() as members. Offsets of members are
+ * resolved at compile time and no SysInfo lookup is required at runtime.
+ */
+#define ESP_AMP_STATIC_LAYOUT(type) ((type *)esp_amp_sys_info_static_mem)
+
+/**
+ * Check at compile time that a static layout struct fits into static layout area
+ */
+#ifdef __cplusplus
+#define ESP_AMP_STATIC_LAYOUT_CHECK(type) \
+    static_assert(sizeof(type) <= (CONFIG_ESP_AMP_SHARED_MEM_STATIC_SIZE & ~0xf), "static layout " #type " exceeds CONFIG_ESP_AMP_SHARED_MEM_STATIC_SIZE")
+#else
+#define ESP_AMP_STATIC_LAYOUT_CHECK(type) \
+    _Static_assert(sizeof(type) <= (CONFIG_ESP_AMP_SHARED_MEM_STATIC_SIZE & ~0xf), "static layout " #type " exceeds CONFIG_ESP_AMP_SHARED_MEM_STATIC_SIZE")
+#endif
+
 /**
  * @brief Allocate sys info
  *
@@ -34,6 +71,79 @@ typedef enum {
  */
 void *esp_amp_sys_info_alloc(uint16_t info_id, uint16_t size);
 
+/**
+ * @brief Allocate sys info from a shared memory region with given capabilities
+ *
+ * Regions are tried in registration order. The first region providing all requested
+ * capabilities and enough free space is used.
+ *
+ * @param info_id identifier for sys info data (0x0000 ~ 0xff00). 0xff00 ~ 0xffff is reserved for internal use
+ * @param size size of sys info data needed
+ * @param caps bitwise OR of ESP_AMP_SYS_INFO_CAP_* the region must provide. 0 for any region
+ *
+ * @retval NULL failed to alloc sys info
+ * @retval pointer to allocated shared memory region for sys info data
+ */
+void *esp_amp_sys_info_alloc_with_caps(uint16_t info_id, uint32_t size, uint32_t caps);
+
+/**
+ * @brief Register an additional shared memory region
+ *
+ * The region must be accessible by both maincore and subcore and must not be used by anything else.
+ * Reserve it (e.g. with SOC_RESERVE_MEMORY_REGION or heap_caps_malloc) before registering it.
+ *
+ * @param start start address of the region
+ * @param size size of the region in byte
+ * @param caps bitwise OR of ESP_AMP_SYS_INFO_CAP_* describing the region
+ *
+ * @retval 0 if successful
+ * @retval -1 invalid region, overlapping region or too many regions
+ */
+int esp_amp_sys_info_add_region(void *start, uint32_t size, uint32_t caps);
+
+/**
+ * @brief Free sys info
+ *
+ * Release the shared memory block allocated for sys info so that it can be reused by later allocation.
+ * Users must ensure the peer core no longer accesses this block before freeing it.
+ *
+ * @param info_id identifier for sys info data
+ *
+ * @retval 0 if successful
+ * @retval -1 sys info with given id not found
+ */
+int esp_amp_sys_info_free(uint16_t info_id);
+
+/**
+ * Statistics of shared memory managed by sys info
+ */
+typedef struct {
+    uint32_t total;                 /* size of memory managed by sys info in byte */
+    uint32_t free;                  /* size of free memory in byte */
+    uint32_t largest_free_block;    /* size of the largest free block in byte */
+    uint32_t max_used;              /* high-water mark of used memory in byte */
+} esp_amp_sys_info_mem_info_t;
+
+/**
+ * @brief Get statistics of shared memory managed by sys info
+ *
+ * Only default control region is counted.
+ *
+ * @param info pointer to store the statistics
+ */
+void esp_amp_sys_info_get_mem_info(esp_amp_sys_info_mem_info_t *info);
+
+/**
+ * @brief Get statistics of shared memory regions with given capabilities
+ *
+ * Statistics of all regions providing the requested capabilities are summed up,
+ * except that largest_free_block is the largest one among these regions.
+ *
+ * @param caps bitwise OR of ESP_AMP_SYS_INFO_CAP_*. 0 for all regions
+ * @param info pointer to store the statistics
+ */
+void esp_amp_sys_info_get_mem_info_with_caps(uint32_t caps, esp_amp_sys_info_mem_info_t *info);
+
 /**
  * @brief Get sys info
  *
@@ -44,9 +154,23 @@ void *esp_amp_sys_info_alloc(uint16_t info_id, uint16_t size);
  *
  * @retval NULL failed to get sys info
  * @retval pointer to allocated shared memory region for sys info data
+ *
+ * @note if sys info data is larger than 65535 bytes, size is reported as 65535. Use esp_amp_sys_info_get_with_caps() instead
  */
 void *esp_amp_sys_info_get(uint16_t info_id, uint16_t *size);
 
+/**
+ * @brief Get sys info with 32-bit size and capabilities of the region it is allocated from
+ *
+ * @param info_id identifier for sys info data
+ * @param size size of sys info data allocated by maincore, set to NULL if not required
+ * @param caps capabilities of the region the data is allocated from, set to NULL if not required
+ *
+ * @retval NULL failed to get sys info
+ * @retval pointer to allocated shared memory region for sys info data
+ */
+void *esp_amp_sys_info_get_with_caps(uint16_t info_id, uint32_t *size, uint32_t *caps);
+
 /**
  * Init sys info manager
  *
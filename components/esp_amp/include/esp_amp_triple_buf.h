@@ -0,0 +1,122 @@
+/*
+* SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#pragma once
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "esp_err.h"
+
+#include "esp_amp_sys_info.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Triple buffer handle
+ *
+ * A triple buffer consists of three equally sized slots in shared memory. Producer
+ * owns the back slot, consumer owns the front slot, and the remaining middle slot
+ * is exchanged between them by a single atomic operation. Neither side ever waits
+ * for the other, and data is never copied: producer fills the back slot in place and
+ * consumer reads the front slot in place.
+ */
+typedef struct esp_amp_triple_buf_t {
+    void* shm;                  /* shared memory allocated from sysinfo */
+    uint8_t* slots;             /* base address of the three slots */
+    uint16_t slot_size;         /* size of each slot in byte (aligned) */
+    uint8_t local_idx;          /* index of the slot owned by this side: back slot for producer, front slot for consumer */
+    bool producer;
+} esp_amp_triple_buf_t;
+
+#if IS_MAIN_CORE
+/**
+ * Create a triple buffer on main-core
+ *
+ * @param tb                    allocated triple buffer handle to initialize
+ * @param slot_size             size of each slot in byte
+ * @param is_producer           true if main-core publishes data, false if main-core consumes data
+ * @param sysinfo_id            sysinfo id of shared memory allocated for the triple buffer
+ *
+ * @retval ESP_OK               successfully create the triple buffer
+ * @retval ESP_ERR_INVALID_ARG  `tb` is NULL or `slot_size` is 0
+ * @retval ESP_ERR_NO_MEM       insufficient shared memory (sysinfo) space
+ *
+ * @note The triple buffer relies on atomic operations and is allocated from a shared memory region with
+ *       ESP_AMP_SYS_INFO_CAP_ATOMIC. With shared memory in LP RAM, a bulk region in HP RAM is required.
+ */
+int esp_amp_triple_buf_main_init(esp_amp_triple_buf_t* tb, uint16_t slot_size, bool is_producer, esp_amp_sys_info_id_t sysinfo_id);
+#endif
+
+/**
+ * Get a triple buffer created by main-core
+ *
+ * @param tb                    allocated triple buffer handle to initialize
+ * @param is_producer           true if this side publishes data, false if this side consumes data.
+ *                              Must be the opposite of the role chosen when creating the triple buffer
+ * @param sysinfo_id            sysinfo id of shared memory allocated for the triple buffer
+ *
+ * @retval ESP_OK               successfully get the triple buffer
+ * @retval ESP_ERR_INVALID_ARG  `tb` is NULL
+ * @retval ESP_ERR_NOT_FOUND    failed to find corresponding sysinfo entry with given sysinfo_id
+ */
+int esp_amp_triple_buf_sub_init(esp_amp_triple_buf_t* tb, bool is_producer, esp_amp_sys_info_id_t sysinfo_id);
+
+/**
+ * Get the slot to fill on producer side
+ *
+ * @param tb                    triple buffer handle
+ *
+ * @retval pointer to the back slot, NULL if called on consumer side
+ *
+ * @note The returned slot belongs to producer until `esp_amp_triple_buf_publish()` is called.
+ *       After publishing, producer must call this API again to get a new slot.
+ */
+void* esp_amp_triple_buf_get_write_buf(esp_amp_triple_buf_t* tb);
+
+/**
+ * Publish the back slot on producer side
+ *
+ * The back slot becomes the latest data and producer gets a new back slot. If consumer has
+ * not acquired the previously published slot yet, the previous data is overwritten.
+ *
+ * @param tb                    triple buffer handle
+ *
+ * @retval ESP_OK               successfully publish data
+ * @retval ESP_ERR_INVALID_STATE called on consumer side
+ *
+ * @note This API can be called in interrupt context.
+ */
+int esp_amp_triple_buf_publish(esp_amp_triple_buf_t* tb);
+
+/**
+ * Acquire the latest published slot on consumer side
+ *
+ * @param tb                    triple buffer handle
+ * @param buffer                pointer to store the front slot address
+ *
+ * @retval ESP_OK               `buffer` points to data published since last acquire
+ * @retval ESP_ERR_NOT_FOUND    nothing new is published since last acquire. `buffer` points to previously acquired data
+ * @retval ESP_ERR_INVALID_STATE called on producer side
+ *
+ * @note The front slot belongs to consumer until next call of this API.
+ * @note This API can be called in interrupt context.
+ */
+int esp_amp_triple_buf_acquire(esp_amp_triple_buf_t* tb, void** buffer);
+
+/**
+ * Get the size of each slot in triple buffer
+ *
+ * @param tb                    triple buffer handle
+ *
+ * @retval size of slot in byte
+ */
+uint16_t esp_amp_triple_buf_get_slot_size(esp_amp_triple_buf_t* tb);
+
+#ifdef __cplusplus
+}
+#endif
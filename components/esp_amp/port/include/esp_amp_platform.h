@@ -7,12 +7,20 @@
 #pragma once
 
 #include "stdint.h"
+#include "sdkconfig.h"
 #include "esp_amp_arch.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* granularity of cache maintenance. Buffers in cached shared memory must be aligned to it */
+#if CONFIG_IDF_TARGET_ESP32P4
+#define ESP_AMP_PLATFORM_CACHE_LINE_SIZE 64
+#else
+#define ESP_AMP_PLATFORM_CACHE_LINE_SIZE 4
+#endif
+
 /**
  * Get cpu core id by reading register
  *
@@ -101,6 +109,47 @@ void esp_amp_platform_sw_intr_trigger(void);
 void esp_amp_platform_sw_intr_clear(void);
 
 
+/**
+ * Write back data cache of a memory range to memory
+ *
+ * Call this after writing to a buffer in cached shared memory and before handing it over to
+ * the other core, so that the other core reads the latest data.
+ *
+ * @param addr start address of the range
+ * @param size size of the range in byte
+ *
+ * @note no-op on platforms which do not access internal memory through data cache
+ */
+void esp_amp_platform_cache_writeback(void *addr, uint32_t size);
+
+
+/**
+ * Invalidate data cache of a memory range
+ *
+ * Call this before reading a buffer in cached shared memory written by the other core, so that
+ * stale cache lines are dropped. Dirty lines in the range are discarded without write-back, so
+ * the range must be cache-line aligned to avoid losing adjacent data.
+ *
+ * @param addr start address of the range
+ * @param size size of the range in byte
+ *
+ * @note no-op on platforms which do not access internal memory through data cache
+ */
+void esp_amp_platform_cache_invalidate(void *addr, uint32_t size);
+
+
+/**
+ * Stall local core until an interrupt is pending
+ *
+ * It also returns when interrupts are disabled, so a condition set by interrupt handler can be
+ * checked in critical section before waiting, without missing the interrupt in between.
+ */
+static inline void esp_amp_platform_wait_for_intr(void)
+{
+    esp_amp_arch_wait_for_intr();
+}
+
+
 /**
  * Memory barrier
  */
@@ -4,10 +4,16 @@
 * SPDX-License-Identifier: Apache-2.0
 */
 
+#include "sdkconfig.h"
+#include "soc/soc_caps.h"
 #include "esp_rom_sys.h"
 #include "esp_amp_arch.h"
 #include "esp_amp_platform.h"
 
+#if SOC_CACHE_INTERNAL_MEM_VIA_L1CACHE
+#include "hal/cache_ll.h"
+#endif
+
 void esp_amp_platform_delay_us(uint32_t time)
 {
     esp_rom_delay_us(time);
@@ -34,3 +40,25 @@ void esp_amp_platform_intr_disable(void)
 {
     esp_amp_arch_intr_disable();
 }
+
+void esp_amp_platform_cache_writeback(void *addr, uint32_t size)
+{
+#if SOC_CACHE_INTERNAL_MEM_VIA_L1CACHE
+    esp_amp_arch_memory_barrier();
+    cache_ll_writeback_addr(CACHE_LL_LEVEL_INT_MEM, CACHE_TYPE_DATA, CACHE_LL_ID_ALL, (uint32_t)addr, size);
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+void esp_amp_platform_cache_invalidate(void *addr, uint32_t size)
+{
+#if SOC_CACHE_INTERNAL_MEM_VIA_L1CACHE
+    cache_ll_invalidate_addr(CACHE_LL_LEVEL_INT_MEM, CACHE_TYPE_DATA, CACHE_LL_ID_ALL, (uint32_t)addr, size);
+    esp_amp_arch_memory_barrier();
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
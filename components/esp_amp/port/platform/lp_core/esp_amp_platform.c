@@ -42,3 +42,16 @@ void esp_amp_platform_intr_disable(void)
 {
     ulp_lp_core_intr_disable();
 }
+
+void esp_amp_platform_cache_writeback(void *addr, uint32_t size)
+{
+    /* LP core accesses memory without cache */
+    (void)addr;
+    (void)size;
+}
+
+void esp_amp_platform_cache_invalidate(void *addr, uint32_t size)
+{
+    (void)addr;
+    (void)size;
+}
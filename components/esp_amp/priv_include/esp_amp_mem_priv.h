@@ -8,22 +8,55 @@
 
 #include "sdkconfig.h"
 
+/* upper bound of HP RAM used by ESP-AMP. Subcore panic dump is placed right above it */
 #if CONFIG_IDF_TARGET_ESP32C6
-#define ESP_AMP_SHARED_MEM_END 0x4087e560
+#define ESP_AMP_HP_MEM_END 0x4087e560
 #elif CONFIG_IDF_TARGET_ESP32C5
-#define ESP_AMP_SHARED_MEM_END 0x4085e4f0
+#define ESP_AMP_HP_MEM_END 0x4085e4f0
 #elif CONFIG_IDF_TARGET_ESP32P4
-#define ESP_AMP_SHARED_MEM_END 0x4ff7f000
+#define ESP_AMP_HP_MEM_END 0x4ff7f000
 #endif
 
 #define ALIGN_DOWN(size, align)  ((size) & ~((align) - 1))
 
-/* shared memory region */
+/* shared memory (control) region */
 #if CONFIG_ESP_AMP_SHARED_MEM_IN_HP
+#define ESP_AMP_SHARED_MEM_END ESP_AMP_HP_MEM_END
 #define ESP_AMP_SHARED_MEM_START ALIGN_DOWN(ESP_AMP_SHARED_MEM_END - CONFIG_ESP_AMP_SHARED_MEM_SIZE, 0x10)
+/* lowest address of HP RAM taken by control region */
+#define ESP_AMP_HP_SHARED_MEM_START ESP_AMP_SHARED_MEM_START
+#elif CONFIG_ESP_AMP_SHARED_MEM_IN_LP
+/**
+ * Control region is carved out of the top of RTC RAM reserved for LP core, right below
+ * ULP shared memory. Start of LP core reserved memory is only known at link time when
+ * LP ROM reserves the beginning of RTC RAM, hence no alignment arithmetic on it here.
+ * Reserved memory start is 8-byte aligned and so are the sizes below.
+ */
+#if CONFIG_ESP_ROM_HAS_LP_ROM
+#ifndef __ASSEMBLER__
+#include "stdint.h"
+extern uint32_t _rtc_ulp_memory_start;
+#endif
+#define ESP_AMP_LP_MEM_START ((intptr_t)&_rtc_ulp_memory_start)
+#else
+#include "soc/soc.h"
+#define ESP_AMP_LP_MEM_START SOC_RTC_DRAM_LOW
+#endif
+#define ESP_AMP_LP_SHARED_MEM_SIZE ALIGN_DOWN(CONFIG_ESP_AMP_SHARED_MEM_SIZE, 0x8)
+#define ESP_AMP_LP_SHARED_MEM_OFFSET (ALIGN_DOWN(CONFIG_ULP_COPROC_RESERVE_MEM, 0x8) - CONFIG_ULP_SHARED_MEM - ESP_AMP_LP_SHARED_MEM_SIZE)
+#define ESP_AMP_SHARED_MEM_START (ESP_AMP_LP_MEM_START + ESP_AMP_LP_SHARED_MEM_OFFSET)
+#define ESP_AMP_SHARED_MEM_END (ESP_AMP_SHARED_MEM_START + ESP_AMP_LP_SHARED_MEM_SIZE)
+/* no HP RAM taken by control region */
+#define ESP_AMP_HP_SHARED_MEM_START ESP_AMP_HP_MEM_END
+#endif /* CONFIG_ESP_AMP_SHARED_MEM_IN_HP */
+
+/* optional bulk shared memory region in HP RAM, right below control region or HP RAM upper bound */
+#ifdef CONFIG_ESP_AMP_SHARED_MEM_BULK_SIZE
+#define ESP_AMP_SHARED_MEM_BULK_SIZE CONFIG_ESP_AMP_SHARED_MEM_BULK_SIZE
 #else
-#error "CONFIG_ESP_AMP_SHARED_MEM_IN_LP is not supported yet"
-#endif /* ESP_AMP_SHARED_MEM_IN_HP */
+#define ESP_AMP_SHARED_MEM_BULK_SIZE 0
+#endif
+#define ESP_AMP_SHARED_MEM_BULK_START ALIGN_DOWN(ESP_AMP_HP_SHARED_MEM_START - ESP_AMP_SHARED_MEM_BULK_SIZE, 0x10)
 
 /* reserved shared memory region */
 #define ESP_AMP_RESERVED_SHARED_MEM_SIZE 0x20
@@ -31,17 +64,28 @@
 /* software interrupt bit */
 #define ESP_AMP_SW_INTR_BIT_ADDR ESP_AMP_SHARED_MEM_START
 
+/* static layout area, right after reserved region */
+#ifdef CONFIG_ESP_AMP_SHARED_MEM_STATIC_SIZE
+#define ESP_AMP_SHARED_MEM_STATIC_SIZE ALIGN_DOWN(CONFIG_ESP_AMP_SHARED_MEM_STATIC_SIZE, 0x10)
+#else
+#define ESP_AMP_SHARED_MEM_STATIC_SIZE 0
+#endif
+#define ESP_AMP_SHARED_MEM_STATIC_START (ESP_AMP_SHARED_MEM_START + ESP_AMP_RESERVED_SHARED_MEM_SIZE)
+
 /* sys info or customized shared memory pool */
+#define ESP_AMP_SHARED_MEM_POOL_START (ESP_AMP_SHARED_MEM_STATIC_START + ESP_AMP_SHARED_MEM_STATIC_SIZE)
+#define ESP_AMP_SHARED_MEM_POOL_SIZE (ESP_AMP_SHARED_MEM_END - ESP_AMP_SHARED_MEM_POOL_START)
+
+/* capabilities of default control region */
 #if CONFIG_ESP_AMP_SHARED_MEM_IN_HP
-#define ESP_AMP_SHARED_MEM_POOL_START (ESP_AMP_SHARED_MEM_START + ESP_AMP_RESERVED_SHARED_MEM_SIZE)
+#define ESP_AMP_SHARED_MEM_CAPS (ESP_AMP_SYS_INFO_CAP_CONTROL | ESP_AMP_SYS_INFO_CAP_ATOMIC)
 #else
-#error "CONFIG_ESP_AMP_SHARED_MEM_IN_LP is not supported yet"
+#define ESP_AMP_SHARED_MEM_CAPS (ESP_AMP_SYS_INFO_CAP_CONTROL)
 #endif
-#define ESP_AMP_SHARED_MEM_POOL_SIZE (ESP_AMP_SHARED_MEM_END - ESP_AMP_SHARED_MEM_POOL_START)
 
 /* hp memory for subcore use */
 #if CONFIG_ESP_AMP_SUBCORE_USE_HP_MEM
-#define SUBCORE_USE_HP_MEM_END ESP_AMP_SHARED_MEM_START
+#define SUBCORE_USE_HP_MEM_END ESP_AMP_SHARED_MEM_BULK_START
 #define SUBCORE_USE_HP_MEM_SIZE CONFIG_ESP_AMP_SUBCORE_USE_HP_MEM_SIZE
 #define SUBCORE_USE_HP_MEM_START (SUBCORE_USE_HP_MEM_END - SUBCORE_USE_HP_MEM_SIZE)
 #endif
@@ -8,8 +8,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-
-#define SYSTEM_SERVICE_ID_PRINT 0x0001
+#include "esp_amp_system.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,27 +16,7 @@ extern "C" {
 
 int esp_amp_system_service_init(void);
 
-#if !IS_MAIN_CORE
-/**
- * @brief Create a system service request
- * @note can only be called in subcore
- *
- * @param buf pointer to the buffer to store request data
- * @param max_len The maximum length of the buffer
- */
-int esp_amp_system_service_create_request(void **buf, uint16_t *max_len);
-
-/**
- * @brief Send request to maincore
- * @note can only be called in subcore
- *
- * @param id service id
- * @param param buffer pointer to the request data
- * @param param_len The length of the request data
- */
-int esp_amp_system_service_send_request(uint16_t id, void* param, uint16_t param_len);
-
-#else
+#if IS_MAIN_CORE
 
 /**
  * @brief Receive request from subcore
@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "stdint.h"
+#include "assert.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+#include <atomic>
+using std::atomic_uint;
+#else
+#include <stdatomic.h>
+#endif
+
+#include "esp_amp_env.h"
+#include "esp_amp_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Bit flags in shared memory, set by one core and consumed by the other
+ *
+ * Used for software interrupt and event bits. In HP RAM this is a single word
+ * updated with atomic read-modify-write. RTC RAM does not support atomic
+ * read-modify-write, so in LP RAM each side owns one word: the setter toggles
+ * bits in `req` and the consumer acknowledges them by toggling the same bits
+ * in `ack`. A bit is pending when it differs between `req` and `ack`.
+ *
+ * In LP RAM, bits of one flag word must only be set from one core. The first core
+ * setting bits is recorded as the setter, setting bits from the other core asserts.
+ */
+#if CONFIG_ESP_AMP_SHARED_MEM_IN_LP
+#define ESP_AMP_SHM_BITS_SETTER_NONE 0
+#define ESP_AMP_SHM_BITS_SETTER_MAIN 1
+#define ESP_AMP_SHM_BITS_SETTER_SUB  2
+
+typedef struct {
+    volatile uint32_t req;      /* written by setter only */
+    volatile uint32_t ack;      /* written by consumer only */
+    volatile uint32_t setter;   /* core setting bits, recorded on first set */
+} esp_amp_shm_bits_t;
+#else
+typedef struct {
+    atomic_uint bits;
+} esp_amp_shm_bits_t;
+#endif
+
+static inline void esp_amp_shm_bits_init(esp_amp_shm_bits_t *flags)
+{
+#if CONFIG_ESP_AMP_SHARED_MEM_IN_LP
+    flags->req = 0;
+    flags->ack = 0;
+    flags->setter = ESP_AMP_SHM_BITS_SETTER_NONE;
+#else
+    atomic_init(&flags->bits, 0);
+#endif
+    esp_amp_platform_memory_barrier();
+}
+
+/**
+ * Get pending bits
+ */
+static inline uint32_t esp_amp_shm_bits_get(esp_amp_shm_bits_t *flags)
+{
+#if CONFIG_ESP_AMP_SHARED_MEM_IN_LP
+    esp_amp_platform_memory_barrier();
+    return flags->req ^ flags->ack;
+#else
+    return atomic_load(&flags->bits);
+#endif
+}
+
+/**
+ * Set bits, called by setter
+ *
+ * @note in LP RAM, must always be called from the same core for the same flags
+ *
+ * @retval bits pending before this call
+ */
+static inline uint32_t esp_amp_shm_bits_set(esp_amp_shm_bits_t *flags, uint32_t bit_mask)
+{
+#if CONFIG_ESP_AMP_SHARED_MEM_IN_LP
+#if IS_MAIN_CORE
+    const uint32_t setter = ESP_AMP_SHM_BITS_SETTER_MAIN;
+#else
+    const uint32_t setter = ESP_AMP_SHM_BITS_SETTER_SUB;
+#endif
+    if (flags->setter == ESP_AMP_SHM_BITS_SETTER_NONE) {
+        flags->setter = setter;
+    }
+    /* toggling `req` from both cores loses bits, see docs/memory_layout.md */
+    assert(flags->setter == setter);
+
+    esp_amp_env_enter_critical();
+    /* data written before setting bits must be visible to the consumer first, and must
+     * not be reordered after reading `ack` below, otherwise consumer may acknowledge a bit
+     * without seeing the new data while this call still sees the bit as pending */
+    esp_amp_platform_memory_barrier();
+    /* bits already pending stay pending, toggling them again would cancel them */
+    uint32_t toggle = bit_mask & ~(flags->req ^ flags->ack);
+    uint32_t req = flags->req ^ toggle;
+    flags->req = req;
+    /* sample `ack` after publishing `req`. If the consumer missed the new bits, it is
+     * guaranteed to see that the previously pending bits are gone and vice versa */
+    esp_amp_platform_memory_barrier();
+    uint32_t prev = (req ^ flags->ack) & ~toggle;
+    esp_amp_env_exit_critical();
+    return prev;
+#else
+    return atomic_fetch_or(&flags->bits, bit_mask);
+#endif
+}
+
+/**
+ * Consume bits, called by consumer
+ *
+ * @retval bits pending before this call. Only bits in `bit_mask` are cleared
+ */
+static inline uint32_t esp_amp_shm_bits_take(esp_amp_shm_bits_t *flags, uint32_t bit_mask)
+{
+#if CONFIG_ESP_AMP_SHARED_MEM_IN_LP
+    esp_amp_env_enter_critical();
+    esp_amp_platform_memory_barrier();
+    uint32_t pending = flags->req ^ flags->ack;
+    flags->ack ^= pending & bit_mask;
+    /* acknowledge before reading data protected by the bits */
+    esp_amp_platform_memory_barrier();
+    esp_amp_env_exit_critical();
+    return pending;
+#else
+    return atomic_fetch_and(&flags->bits, ~bit_mask);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
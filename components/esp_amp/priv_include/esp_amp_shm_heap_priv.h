@@ -0,0 +1,97 @@
+/*
+* SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#pragma once
+
+#include "stdint.h"
+#include "stddef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if IS_MAIN_CORE
+
+/* TLSF (two-level segregated fit) parameters */
+#define SHM_HEAP_ALIGN_LOG2     2
+#define SHM_HEAP_ALIGN          (1 << SHM_HEAP_ALIGN_LOG2)
+#define SHM_HEAP_SL_LOG2        3
+#define SHM_HEAP_SL_COUNT       (1 << SHM_HEAP_SL_LOG2)
+#define SHM_HEAP_FL_SHIFT       (SHM_HEAP_SL_LOG2 + SHM_HEAP_ALIGN_LOG2)
+#define SHM_HEAP_FL_MAX         24      /* blocks up to 16 MB */
+#define SHM_HEAP_FL_COUNT       (SHM_HEAP_FL_MAX - SHM_HEAP_FL_SHIFT + 1)
+
+typedef struct shm_heap_block_t shm_heap_block_t;
+
+/**
+ * Control structure of a shared memory heap
+ *
+ * Only block headers are placed in the managed memory. Free lists and bitmaps
+ * are kept in this structure, which lives in maincore local memory.
+ */
+typedef struct {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[SHM_HEAP_FL_COUNT];
+    shm_heap_block_t *blocks[SHM_HEAP_FL_COUNT][SHM_HEAP_SL_COUNT];
+    uint8_t *start;
+    uint32_t size;
+    uint32_t used;              /* bytes taken by allocated blocks including headers */
+    uint32_t max_used;          /* high-water mark of used */
+} esp_amp_shm_heap_t;
+
+/**
+ * Initialize a heap over a memory region
+ *
+ * @param heap      heap control structure
+ * @param start     start address of the region
+ * @param size      size of the region in byte
+ *
+ * @retval 0 if successful
+ * @retval -1 region is too small or too large
+ */
+int esp_amp_shm_heap_init(esp_amp_shm_heap_t *heap, void *start, uint32_t size);
+
+/**
+ * Allocate a block
+ *
+ * Takes O(1) time if a free list guaranteed to fit the request is not empty. Otherwise
+ * the free list the requested size falls into is walked for a large enough block, which
+ * happens only when the heap is almost exhausted or too fragmented.
+ *
+ * @retval NULL if no free block is large enough
+ * @retval pointer to the allocated block, aligned to SHM_HEAP_ALIGN
+ */
+void *esp_amp_shm_heap_alloc(esp_amp_shm_heap_t *heap, uint32_t size);
+
+/**
+ * Free a block in O(1) time, merging it with free neighbours
+ */
+void esp_amp_shm_heap_free(esp_amp_shm_heap_t *heap, void *ptr);
+
+/**
+ * Check if an address belongs to the heap
+ */
+static inline int esp_amp_shm_heap_contains(esp_amp_shm_heap_t *heap, const void *ptr)
+{
+    return (const uint8_t *)ptr >= heap->start && (const uint8_t *)ptr < heap->start + heap->size;
+}
+
+/**
+ * Get heap statistics
+ *
+ * @param heap              heap control structure
+ * @param total             total size of allocatable memory in byte
+ * @param free              size of free memory in byte
+ * @param largest_free      largest block that can be allocated now, found by walking the highest non-empty free list
+ * @param max_used          high-water mark of used memory
+ */
+void esp_amp_shm_heap_get_stats(esp_amp_shm_heap_t *heap, uint32_t *total, uint32_t *free, uint32_t *largest_free, uint32_t *max_used);
+
+#endif /* IS_MAIN_CORE */
+
+#ifdef __cplusplus
+}
+#endif
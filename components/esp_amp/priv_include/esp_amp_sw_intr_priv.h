@@ -9,12 +9,14 @@
 #ifdef __cplusplus
 #include <atomic>
 using std::atomic_int;
+using std::atomic_uint;
 #else
 #include <stdatomic.h>
 #endif
 
 #include "riscv/rv_utils.h"
 #include "esp_amp_sw_intr.h"
+#include "esp_amp_shm_bits_priv.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,15 +24,16 @@ extern "C" {
 
 #define ESP_AMP_SW_INTR_HANDLER_TABLE_LEN CONFIG_ESP_AMP_SW_INTR_HANDLER_TABLE_LEN
 
-typedef struct {
+typedef struct sw_intr_handler_tbl_t {
     esp_amp_sw_intr_id_t intr_id;
     esp_amp_sw_intr_handler_t handler;
     void *arg;
+    struct sw_intr_handler_tbl_t *next;     /* next handler of the same intr_id, or next free entry */
 } sw_intr_handler_tbl_t;
 
 typedef struct {
-    atomic_int main_core_sw_intr_st;
-    atomic_int sub_core_sw_intr_st;
+    esp_amp_shm_bits_t main_core_sw_intr_st;
+    esp_amp_shm_bits_t sub_core_sw_intr_st;
 } esp_amp_sw_intr_st_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "stdint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if IS_MAIN_CORE
+/**
+ * Allocate a secondary buffer for an existing sys info entry
+ *
+ * Used by objects which keep their control structure in a sys info entry but place
+ * their data buffers in another region, referenced by address from the control structure.
+ * The buffer is recorded in the entry and freed together with it by esp_amp_sys_info_free().
+ * An entry holds at most one secondary buffer.
+ *
+ * @param info_id id of the sys info entry owning the buffer
+ * @param size size of buffer in byte
+ * @param caps bitwise OR of ESP_AMP_SYS_INFO_CAP_* the region must provide
+ * @param region_caps pointer to store capabilities of the region the buffer is allocated from, set to NULL if not required
+ *
+ * @retval NULL entry not found, entry already has a buffer, or no space in regions with requested capabilities
+ * @retval pointer to allocated buffer. Cache-line aligned if allocated from a cached region
+ */
+void *esp_amp_sys_info_alloc_buffer(uint16_t info_id, uint32_t size, uint32_t caps, uint32_t *region_caps);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
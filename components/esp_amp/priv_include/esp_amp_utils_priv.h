@@ -15,6 +15,8 @@ extern "C" {
 #if IS_MAIN_CORE
 uint16_t get_aligned_size(uint16_t size);
 uint16_t get_power_len(uint16_t len);
+uint16_t get_queue_item_size(uint16_t size);
+void *alloc_queue_shm(uint16_t sysinfo_id, uint32_t ctrl_size, uint32_t buf_size, void **buf, uint32_t *buf_caps);
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,111 @@
+/*
+* SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "sdkconfig.h"
+#include "stddef.h"
+#include "esp_attr.h"
+
+#include "esp_amp_copy.h"
+
+/* copies shorter than this are not worth aligning */
+#define COPY_WORD_THRESHOLD 16
+
+/* keep the compiler from turning copy loops back into calls to libc memcpy */
+#define COPY_KERNEL_ATTR __attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+static const esp_amp_copy_backend_t *s_copy_backend = NULL;
+
+static inline COPY_KERNEL_ATTR void copy_tail(uint8_t *d, const uint8_t *s, uint32_t size)
+{
+    while (size--) {
+        *d++ = *s++;
+    }
+}
+
+void IRAM_ATTR COPY_KERNEL_ATTR esp_amp_copy_byte(void *dst, const void *src, uint32_t size)
+{
+    copy_tail((uint8_t *)dst, (const uint8_t *)src, size);
+}
+
+void IRAM_ATTR COPY_KERNEL_ATTR esp_amp_copy_word(void *dst, const void *src, uint32_t size)
+{
+    uint32_t *d = (uint32_t *)dst;
+    const uint32_t *s = (const uint32_t *)src;
+
+    for (uint32_t n = size >> 2; n > 0; n--) {
+        *d++ = *s++;
+    }
+    copy_tail((uint8_t *)d, (const uint8_t *)s, size & 0x3);
+}
+
+void IRAM_ATTR COPY_KERNEL_ATTR esp_amp_copy_word_x8(void *dst, const void *src, uint32_t size)
+{
+    uint32_t *d = (uint32_t *)dst;
+    const uint32_t *s = (const uint32_t *)src;
+
+    /* issue all loads of a block before the stores, so that load latency of shared SRAM overlaps */
+    for (uint32_t n = size >> 5; n > 0; n--) {
+        uint32_t w0 = s[0], w1 = s[1], w2 = s[2], w3 = s[3];
+        uint32_t w4 = s[4], w5 = s[5], w6 = s[6], w7 = s[7];
+        d[0] = w0;
+        d[1] = w1;
+        d[2] = w2;
+        d[3] = w3;
+        d[4] = w4;
+        d[5] = w5;
+        d[6] = w6;
+        d[7] = w7;
+        d += 8;
+        s += 8;
+    }
+    esp_amp_copy_word(d, s, size & 0x1f);
+}
+
+void * IRAM_ATTR COPY_KERNEL_ATTR esp_amp_copy(void *dst, const void *src, uint32_t size)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (size < COPY_WORD_THRESHOLD || (((uintptr_t)d ^ (uintptr_t)s) & 0x3) != 0) {
+        /* short copy, or buffers can never be word-aligned at the same time */
+        esp_amp_copy_byte(d, s, size);
+        return dst;
+    }
+
+    uint32_t head = (0x4 - ((uintptr_t)d & 0x3)) & 0x3;
+    copy_tail(d, s, head);
+    esp_amp_copy_word_x8(d + head, s + head, size - head);
+    return dst;
+}
+
+int esp_amp_copy_register_backend(const esp_amp_copy_backend_t *backend)
+{
+    if (backend != NULL && (backend->copy == NULL || backend->align == 0 || (backend->align & (backend->align - 1)) != 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_copy_backend = backend;
+    return ESP_OK;
+}
+
+int esp_amp_copy_async(void *dst, const void *src, uint32_t size, esp_amp_copy_done_cb_t done_cb, void *arg)
+{
+    if (done_cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const esp_amp_copy_backend_t *backend = s_copy_backend;
+    if (backend != NULL && size >= backend->min_size &&
+            (((uintptr_t)dst | (uintptr_t)src | size) & (backend->align - 1)) == 0) {
+        if (backend->copy(backend->ctx, dst, src, size, done_cb, arg) == 0) {
+            return ESP_OK;
+        }
+    }
+
+    esp_amp_copy(dst, src, size);
+    done_cb(arg);
+    return ESP_OK;
+}
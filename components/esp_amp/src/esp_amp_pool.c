@@ -0,0 +1,199 @@
+/*
+* SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "sdkconfig.h"
+#include "esp_attr.h"
+
+#ifdef __cplusplus
+#include <atomic>
+using std::atomic_uint;
+#else
+#include <stdatomic.h>
+#endif
+
+#include "esp_amp_pool.h"
+#include "esp_amp_sys_info.h"
+#include "esp_amp_platform.h"
+#include "esp_amp_sys_info_priv.h"
+
+/*
+ * Free list head is a tagged index: bit[15:0] index of the first free block, bit[31:16]
+ * a tag incremented on every update. A stale head read by one core no longer compares
+ * equal after the other core pops and pushes the same block, which avoids ABA.
+ */
+#define POOL_IDX_NONE           0xffff
+#define POOL_HEAD(tag, idx)     (((uint32_t)(tag) << 16) | (idx))
+#define POOL_HEAD_IDX(head)     ((head) & 0xffff)
+#define POOL_HEAD_TAG(head)     ((head) >> 16)
+
+#define POOL_BLOCK_ALIGN        4
+
+typedef struct {
+    atomic_uint head;
+    atomic_uint free_num;
+    uint16_t block_size;
+    uint16_t block_num;
+    uint8_t* blocks;    /* follow `next` unless allocated from another region */
+    uint32_t block_caps; /* capabilities of the region blocks are in */
+    uint16_t next[0];
+} esp_amp_pool_shm_t;
+
+static inline uint32_t pool_next_size(uint16_t block_num)
+{
+    return (sizeof(uint16_t) * block_num + POOL_BLOCK_ALIGN - 1) & ~(POOL_BLOCK_ALIGN - 1);
+}
+
+static void pool_bind(esp_amp_pool_t* pool, esp_amp_pool_shm_t* shm)
+{
+    pool->shm = shm;
+    pool->next = shm->next;
+    pool->blocks = shm->blocks;
+    pool->block_size = shm->block_size;
+    pool->block_num = shm->block_num;
+    pool->cached = (shm->block_caps & ESP_AMP_SYS_INFO_CAP_CACHED) != 0;
+}
+
+#if IS_MAIN_CORE
+int esp_amp_pool_main_init_with_caps(esp_amp_pool_t* pool, uint16_t block_size, uint16_t block_num, uint32_t block_caps, esp_amp_sys_info_id_t sysinfo_id)
+{
+    if (pool == NULL || block_size == 0 || block_num == 0 || block_num == POOL_IDX_NONE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* blocks in a separate region may be cached, never let two blocks share one cache line */
+    uint32_t align = (block_caps != 0) ? ESP_AMP_PLATFORM_CACHE_LINE_SIZE : POOL_BLOCK_ALIGN;
+    uint32_t aligned_size = (block_size + align - 1) & ~(align - 1);
+    if (aligned_size > UINT16_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t ctrl_size = sizeof(esp_amp_pool_shm_t) + pool_next_size(block_num);
+    uint32_t blocks_size = aligned_size * block_num;
+    uint32_t total_size = (block_caps != 0) ? ctrl_size : ctrl_size + blocks_size;
+
+    esp_amp_pool_shm_t* shm = (esp_amp_pool_shm_t*)esp_amp_sys_info_alloc_with_caps(sysinfo_id, total_size, ESP_AMP_SYS_INFO_CAP_ATOMIC);
+    if (shm == NULL) {
+        // reserve memory not enough or corresponding sys_info already occupied
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (block_caps != 0) {
+        shm->blocks = (uint8_t*)esp_amp_sys_info_alloc_buffer(sysinfo_id, blocks_size, block_caps, &shm->block_caps);
+        if (shm->blocks == NULL) {
+            esp_amp_sys_info_free(sysinfo_id);
+            return ESP_ERR_NO_MEM;
+        }
+    } else {
+        shm->blocks = (uint8_t*)shm + ctrl_size;
+        esp_amp_sys_info_get_with_caps(sysinfo_id, NULL, &shm->block_caps);
+    }
+
+    shm->block_size = (uint16_t)aligned_size;
+    shm->block_num = block_num;
+    for (uint16_t i = 0; i < block_num; i++) {
+        shm->next[i] = (i + 1 < block_num) ? i + 1 : POOL_IDX_NONE;
+    }
+    atomic_init(&shm->free_num, block_num);
+    esp_amp_platform_memory_barrier();
+    atomic_init(&shm->head, POOL_HEAD(0, 0));
+
+    pool_bind(pool, shm);
+    return ESP_OK;
+}
+
+int esp_amp_pool_main_init(esp_amp_pool_t* pool, uint16_t block_size, uint16_t block_num, esp_amp_sys_info_id_t sysinfo_id)
+{
+    return esp_amp_pool_main_init_with_caps(pool, block_size, block_num, 0, sysinfo_id);
+}
+#endif
+
+int esp_amp_pool_sub_init(esp_amp_pool_t* pool, esp_amp_sys_info_id_t sysinfo_id)
+{
+    if (pool == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_amp_pool_shm_t* shm = (esp_amp_pool_shm_t*)esp_amp_sys_info_get(sysinfo_id, NULL);
+    if (shm == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    pool_bind(pool, shm);
+    return ESP_OK;
+}
+
+void* IRAM_ATTR esp_amp_pool_alloc(esp_amp_pool_t* pool)
+{
+    esp_amp_pool_shm_t* shm = (esp_amp_pool_shm_t*)pool->shm;
+    unsigned int head = atomic_load(&shm->head);
+    uint16_t idx;
+
+    do {
+        idx = POOL_HEAD_IDX(head);
+        if (idx == POOL_IDX_NONE) {
+            return NULL;
+        }
+        /* next[idx] may be stale if another core took idx meanwhile, tag makes CAS fail then */
+        uint16_t next = pool->next[idx];
+        unsigned int new_head = POOL_HEAD(POOL_HEAD_TAG(head) + 1, next);
+        if (atomic_compare_exchange_weak(&shm->head, &head, new_head)) {
+            break;
+        }
+    } while (1);
+
+    atomic_fetch_sub(&shm->free_num, 1);
+    uint8_t* block = pool->blocks + (uint32_t)idx * pool->block_size;
+    if (pool->cached) {
+        /* drop lines cached while the block was owned by the other core */
+        esp_amp_platform_cache_invalidate(block, pool->block_size);
+    }
+    return block;
+}
+
+int IRAM_ATTR esp_amp_pool_free(esp_amp_pool_t* pool, void* block)
+{
+    esp_amp_pool_shm_t* shm = (esp_amp_pool_shm_t*)pool->shm;
+    uint32_t offset = (uint8_t*)block - pool->blocks;
+    if ((uint8_t*)block < pool->blocks || offset % pool->block_size != 0 || offset / pool->block_size >= pool->block_num) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (pool->cached) {
+        /* dirty lines written back later would corrupt the block after the other core takes it */
+        esp_amp_platform_cache_invalidate(block, pool->block_size);
+    }
+
+    uint16_t idx = offset / pool->block_size;
+    unsigned int head = atomic_load(&shm->head);
+    do {
+        pool->next[idx] = POOL_HEAD_IDX(head);
+        /* link must be visible before the block is published as head */
+        esp_amp_platform_memory_barrier();
+    } while (!atomic_compare_exchange_weak(&shm->head, &head, POOL_HEAD(POOL_HEAD_TAG(head) + 1, idx)));
+
+    atomic_fetch_add(&shm->free_num, 1);
+    return ESP_OK;
+}
+
+uint16_t esp_amp_pool_get_free_num(esp_amp_pool_t* pool)
+{
+    esp_amp_pool_shm_t* shm = (esp_amp_pool_shm_t*)pool->shm;
+    return (uint16_t)atomic_load(&shm->free_num);
+}
+
+void IRAM_ATTR esp_amp_pool_writeback(esp_amp_pool_t* pool, void* block, uint16_t size)
+{
+    if (pool->cached) {
+        esp_amp_platform_cache_writeback(block, size);
+    }
+}
+
+void IRAM_ATTR esp_amp_pool_invalidate(esp_amp_pool_t* pool, void* block, uint16_t size)
+{
+    if (pool->cached) {
+        esp_amp_platform_cache_invalidate(block, size);
+    }
+}
@@ -38,6 +38,11 @@ int IRAM_ATTR esp_amp_queue_send_try(esp_amp_queue_t *queue, void* data, uint16_
         return ESP_ERR_NOT_ALLOWED;
     }
 
+    if (queue->cached) {
+        // data must reach memory before the opposite side can see the buffer
+        esp_amp_platform_cache_writeback(data, size);
+    }
+
     queue->desc[q_idx].addr = (uint32_t)(data);
     queue->desc[q_idx].len = size;
     esp_amp_platform_memory_barrier();
@@ -89,6 +94,11 @@ int IRAM_ATTR esp_amp_queue_recv_try(esp_amp_queue_t *queue, void** buffer, uint
         queue->free_flip_counter = !queue->free_flip_counter;
     }
 
+    if (queue->cached) {
+        // drop stale cache lines left from the previous use of this buffer
+        esp_amp_platform_cache_invalidate(*buffer, *size);
+    }
+
     return ESP_OK;
 }
 
@@ -125,6 +135,19 @@ int IRAM_ATTR esp_amp_queue_alloc_try(esp_amp_queue_t *queue, void** buffer, uin
     return ESP_OK;
 }
 
+int IRAM_ATTR esp_amp_queue_request_free_notify(esp_amp_queue_t *queue)
+{
+    if (!queue->master) {
+        // can only be called on `master-core`
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    *queue->free_waiting = 1;
+    // request must be visible before master-core checks for free buffers again
+    esp_amp_platform_memory_barrier();
+    return ESP_OK;
+}
+
 int IRAM_ATTR esp_amp_queue_free_try(esp_amp_queue_t *queue, void* buffer)
 {
     if (queue->master) {
@@ -145,6 +168,11 @@ int IRAM_ATTR esp_amp_queue_free_try(esp_amp_queue_t *queue, void* buffer)
         return ESP_ERR_NOT_ALLOWED;
     }
 
+    if (queue->cached) {
+        // drop lines cached while reading, master-core may refill the buffer behind our back
+        esp_amp_platform_cache_invalidate(buffer, queue->max_item_size);
+    }
+
     queue->desc[q_idx].addr = (uint32_t)(buffer);
     queue->desc[q_idx].len = queue->max_item_size;
     esp_amp_platform_memory_barrier();
@@ -160,6 +188,15 @@ int IRAM_ATTR esp_amp_queue_free_try(esp_amp_queue_t *queue, void* buffer)
         queue->used_flip_counter = !queue->used_flip_counter;
     }
 
+    // freed slot must be visible before checking whether master-core waits for it
+    esp_amp_platform_memory_barrier();
+    if (*queue->free_waiting) {
+        *queue->free_waiting = 0;
+        if (queue->free_notify_fc != NULL) {
+            return queue->free_notify_fc(queue->priv_data);
+        }
+    }
+
     return ESP_OK;
 }
 
@@ -169,6 +206,8 @@ int esp_amp_queue_init_buffer(esp_amp_queue_conf_t* queue_conf, uint16_t queue_l
     queue_conf->max_queue_item_size = queue_item_size;
     queue_conf->queue_desc = queue_desc;
     queue_conf->queue_buffer = queue_buffer;
+    queue_conf->buffer_caps = 0;
+    queue_conf->free_waiting = 0;
     uint8_t* _queue_buffer = (uint8_t*)queue_buffer;
     for (uint16_t desc_idx = 0; desc_idx < queue_conf->queue_size; desc_idx++) {
         queue_conf->queue_desc[desc_idx].addr = (uint32_t)_queue_buffer;
@@ -188,6 +227,9 @@ int esp_amp_queue_create(esp_amp_queue_t* queue, esp_amp_queue_conf_t* queue_con
     queue->free_index = 0;
     queue->used_index = 0;
     queue->max_item_size = queue_conf->max_queue_item_size;
+    queue->cached = (queue_conf->buffer_caps & ESP_AMP_SYS_INFO_CAP_CACHED) != 0;
+    queue->free_waiting = &queue_conf->free_waiting;
+    queue->free_notify_fc = NULL;
     if (is_master) {
         /* master can only send message */
         queue->notify_fc = cb_func;
@@ -209,16 +251,19 @@ int esp_amp_queue_main_init(esp_amp_queue_t* queue, uint16_t queue_len, uint16_t
 
     // force to ceil the queue length to power of 2
     uint16_t aligned_queue_len = get_power_len(queue_len);
-    // force to align the queue item size with word boundary
-    uint16_t aligned_queue_item_size = get_aligned_size(queue_item_size);
+    // force to align the queue item size with word (or cache line) boundary
+    uint16_t aligned_queue_item_size = get_queue_item_size(queue_item_size);
 
     if (aligned_queue_len == 0 || aligned_queue_item_size == 0) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    size_t queue_shm_size = sizeof(esp_amp_queue_conf_t) + sizeof(esp_amp_queue_desc_t) * aligned_queue_len + aligned_queue_item_size * aligned_queue_len;
+    size_t queue_ctrl_size = sizeof(esp_amp_queue_conf_t) + sizeof(esp_amp_queue_desc_t) * aligned_queue_len;
+    size_t queue_data_size = aligned_queue_item_size * aligned_queue_len;
 
-    uint8_t* vq_buffer = (uint8_t*)(esp_amp_sys_info_alloc(sysinfo_id, queue_shm_size));
+    void* vq_data_buffer;
+    uint32_t vq_data_caps = 0;
+    uint8_t* vq_buffer = (uint8_t*)(alloc_queue_shm(sysinfo_id, queue_ctrl_size, queue_data_size, &vq_data_buffer, &vq_data_caps));
     if (vq_buffer == NULL) {
         // reserve memory not enough or corresponding sys_info already occupied
         return ESP_ERR_NO_MEM;
@@ -227,10 +272,9 @@ int esp_amp_queue_main_init(esp_amp_queue_t* queue, uint16_t queue_len, uint16_t
     esp_amp_queue_conf_t* vq_confg = (esp_amp_queue_conf_t*)(vq_buffer);
     vq_buffer += sizeof(esp_amp_queue_conf_t);
     esp_amp_queue_desc_t* vq_desc = (esp_amp_queue_desc_t*)(vq_buffer);
-    vq_buffer += sizeof(esp_amp_queue_desc_t) * aligned_queue_len;
-    void* vq_data_buffer = (void*)(vq_buffer);
 
     esp_amp_queue_init_buffer(vq_confg, aligned_queue_len, aligned_queue_item_size, vq_desc, vq_data_buffer);
+    vq_confg->buffer_caps = vq_data_caps;
     esp_amp_queue_create(queue, vq_confg, cb_func, priv_data, is_master);
 
     return ESP_OK;
@@ -253,6 +297,29 @@ int esp_amp_queue_sub_init(esp_amp_queue_t* queue, esp_amp_queue_cb_t cb_func, v
     return ESP_OK;
 }
 
+int esp_amp_queue_static_init(esp_amp_queue_t* queue, void* storage, uint16_t queue_len, uint16_t queue_item_size, esp_amp_queue_cb_t cb_func, void* priv_data, bool is_master)
+{
+    if (storage == NULL || queue_len == 0 || (queue_len & (queue_len - 1)) != 0 || queue_item_size == 0 || (queue_item_size & 0x3) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* same layout as ESP_AMP_QUEUE_STATIC_T */
+    esp_amp_queue_conf_t* vq_confg = (esp_amp_queue_conf_t*)storage;
+
+#if IS_MAIN_CORE
+    esp_amp_queue_desc_t* vq_desc = (esp_amp_queue_desc_t*)(vq_confg + 1);
+    esp_amp_queue_init_buffer(vq_confg, queue_len, queue_item_size, vq_desc, vq_desc + queue_len);
+#else
+    if (vq_confg->queue_size != queue_len || vq_confg->max_queue_item_size != queue_item_size) {
+        // maincore firmware is built with a different layout
+        return ESP_ERR_INVALID_STATE;
+    }
+#endif
+    esp_amp_queue_create(queue, vq_confg, cb_func, priv_data, is_master);
+
+    return ESP_OK;
+}
+
 int esp_amp_queue_intr_enable(esp_amp_queue_t* queue, esp_amp_sw_intr_id_t sw_intr_id)
 {
     if (queue->master) {
@@ -267,4 +334,15 @@ int esp_amp_queue_intr_enable(esp_amp_queue_t* queue, esp_amp_sw_intr_id_t sw_in
     }
 
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+int esp_amp_queue_free_notify_enable(esp_amp_queue_t* queue, esp_amp_queue_cb_t notify_fc)
+{
+    if (queue->master) {
+        /* should only be called on `remote-core` */
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    queue->free_notify_fc = notify_fc;
+    return ESP_OK;
+}
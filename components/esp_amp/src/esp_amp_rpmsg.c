@@ -5,15 +5,158 @@
 */
 
 
+#include "string.h"
 #include "esp_attr.h"
 
 #include "esp_amp_env.h"
 #include "esp_amp_utils_priv.h"
 #include "esp_amp_rpmsg.h"
+#include "esp_amp_copy.h"
 #include "esp_amp_platform.h"
 #include "esp_amp_sys_info.h"
 #include "esp_amp_sw_intr.h"
 
+/* interval to check for free buffers when sender cannot sleep until doorbell */
+#define RPMSG_TX_RETRY_DELAY_US 10
+
+/* space one rpmsg takes in a packed rpmsg, members are word-aligned */
+#define RPMSG_PACK_MEMBER_SIZE(data_len) ((offsetof(esp_amp_rpmsg_t, msg_data) + (uint32_t)(data_len) + 0x3) & ~0x3)
+
+/* head of shared memory of rpmsg virtqueues, so that subcore can check it uses the same number of lanes */
+typedef struct {
+    uint16_t lane_num;
+    uint16_t reserved;
+    esp_amp_queue_conf_t vq_conf[0];    /* config of each virtqueue, followed by descriptors */
+} esp_amp_rpmsg_shm_t;
+
+/* credits are returned once peer has destroyed half of the window */
+#define RPMSG_CREDIT_BATCH(window) (((window) + 1) >> 1)
+
+/* whether rpmsgs from `ept` to `dst_addr` are subject to flow control */
+static inline bool __esp_amp_rpmsg_credit_enabled(esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr)
+{
+    return ept->credit_window != 0 && ept->credit_peer_addr == dst_addr;
+}
+
+/* virtqueues of the lane in `flags`, NULL if device has no such lane */
+static inline esp_amp_queue_t* __esp_amp_rpmsg_lane_tx_queue(esp_amp_rpmsg_dev_t* rpmsg_dev, uint16_t flags)
+{
+    uint8_t lane = (flags & ESP_AMP_RPMSG_DATA_LANE_MASK) >> ESP_AMP_RPMSG_DATA_LANE_SHIFT;
+    if (lane == 0) {
+        return rpmsg_dev->tx_queue;
+    }
+    return lane < rpmsg_dev->lane_num ? rpmsg_dev->lane_tx_queue[lane] : NULL;
+}
+
+static inline esp_amp_queue_t* __esp_amp_rpmsg_lane_rx_queue(esp_amp_rpmsg_dev_t* rpmsg_dev, uint16_t flags)
+{
+    uint8_t lane = (flags & ESP_AMP_RPMSG_DATA_LANE_MASK) >> ESP_AMP_RPMSG_DATA_LANE_SHIFT;
+    if (lane == 0) {
+        return rpmsg_dev->rx_queue;
+    }
+    return lane < rpmsg_dev->lane_num ? rpmsg_dev->lane_rx_queue[lane] : NULL;
+}
+
+/* must be called in critical section */
+static int IRAM_ATTR __esp_amp_rpmsg_flush(esp_amp_rpmsg_dev_t* rpmsg_dev)
+{
+    esp_amp_rpmsg_t* pack = rpmsg_dev->tx_pack;
+    if (pack == NULL) {
+        return 0;
+    }
+
+    /* keep the pack pending if it cannot be sent, so that it is retried on next flush */
+    pack->msg_head.data_len = rpmsg_dev->tx_pack_len;
+    if (rpmsg_dev->queue_ops.q_tx(rpmsg_dev->tx_queue, pack, rpmsg_dev->tx_queue->max_item_size) != 0) {
+        return -1;
+    }
+    rpmsg_dev->tx_pack = NULL;
+    return 0;
+}
+
+/* must be called in critical section */
+static bool IRAM_ATTR __esp_amp_rpmsg_pack_expired(esp_amp_rpmsg_dev_t* rpmsg_dev)
+{
+    return rpmsg_dev->tx_pack_timeout_ms != 0 &&
+           esp_amp_platform_get_time_ms() - rpmsg_dev->tx_pack_start_ms >= rpmsg_dev->tx_pack_timeout_ms;
+}
+
+static int IRAM_ATTR __esp_amp_rpmsg_flush_expired(esp_amp_rpmsg_dev_t* rpmsg_dev)
+{
+    int ret = 0;
+
+    esp_amp_env_enter_critical();
+
+    if (rpmsg_dev->tx_pack != NULL && __esp_amp_rpmsg_pack_expired(rpmsg_dev)) {
+        ret = __esp_amp_rpmsg_flush(rpmsg_dev);
+    }
+
+    esp_amp_env_exit_critical();
+
+    return ret;
+}
+
+/**
+ * Copy one rpmsg into the pending packed rpmsg
+ *
+ * @retval 0    rpmsg is packed
+ * @retval 1    rpmsg is too large to be packed, send it on its own
+ * @retval -1   no buffer to pack into, or failed to flush
+ */
+static int __esp_amp_rpmsg_pack(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, const esp_amp_rpmsg_iovec_t* iov, uint16_t iov_cnt, uint16_t data_len)
+{
+    uint32_t member_size = RPMSG_PACK_MEMBER_SIZE(data_len);
+    if (member_size > rpmsg_dev->tx_pack_flush_size || __esp_amp_rpmsg_credit_enabled(ept, dst_addr) || ept->lane != 0) {
+        // credits are counted per virtqueue buffer, so flow-controlled rpmsgs are sent on their own.
+        // packs are built on lane 0 only, higher lanes skip the wait
+        return 1;
+    }
+
+    int ret = 0;
+
+    esp_amp_env_enter_critical();
+
+    if (rpmsg_dev->tx_pack != NULL && rpmsg_dev->tx_pack_len + member_size > esp_amp_rpmsg_get_max_size(rpmsg_dev)) {
+        ret = __esp_amp_rpmsg_flush(rpmsg_dev);
+    }
+
+    if (ret == 0 && rpmsg_dev->tx_pack == NULL) {
+        esp_amp_rpmsg_t* pack = NULL;
+        if (rpmsg_dev->queue_ops.q_tx_alloc(rpmsg_dev->tx_queue, (void**)(&pack), rpmsg_dev->tx_queue->max_item_size) == 0 && pack != NULL) {
+            pack->msg_head.src_addr = 0;
+            pack->msg_head.dst_addr = 0;
+            pack->msg_head.data_flags = ESP_AMP_RPMSG_DATA_PACKED;
+            rpmsg_dev->tx_pack = pack;
+            rpmsg_dev->tx_pack_len = 0;
+            rpmsg_dev->tx_pack_start_ms = esp_amp_platform_get_time_ms();
+        } else {
+            ret = -1;
+        }
+    }
+
+    if (ret == 0) {
+        esp_amp_rpmsg_t* member = (esp_amp_rpmsg_t*)(rpmsg_dev->tx_pack->msg_data + rpmsg_dev->tx_pack_len);
+        member->msg_head.src_addr = ept->addr;
+        member->msg_head.dst_addr = dst_addr;
+        member->msg_head.data_len = data_len;
+        member->msg_head.data_flags = ESP_AMP_RPMSG_DATA_DEFAULT;
+        uint8_t* pos = member->msg_data;
+        for (uint16_t i = 0; i < iov_cnt; i++) {
+            esp_amp_copy(pos, iov[i].data, iov[i].len);
+            pos += iov[i].len;
+        }
+        rpmsg_dev->tx_pack_len += member_size;
+
+        /* rpmsg is packed even if flush fails, pack stays pending and is sent by a later flush */
+        if (rpmsg_dev->tx_pack_len >= rpmsg_dev->tx_pack_flush_size || __esp_amp_rpmsg_pack_expired(rpmsg_dev)) {
+            __esp_amp_rpmsg_flush(rpmsg_dev);
+        }
+    }
+
+    esp_amp_env_exit_critical();
+
+    return ret;
+}
 
 static void __esp_amp_rpmsg_extend_endpoint_list(esp_amp_rpmsg_ept_t** ept_head, esp_amp_rpmsg_ept_t* new_ept)
 {
@@ -57,6 +200,17 @@ esp_amp_rpmsg_ept_t* esp_amp_rpmsg_search_endpoint(esp_amp_rpmsg_dev_t* rpmsg_de
     return ept_ptr;
 }
 
+/* must be called in critical section, returns ESP_AMP_RPMSG_ADDR_ANY if dynamic range is used up */
+static uint16_t __esp_amp_rpmsg_alloc_addr(esp_amp_rpmsg_dev_t* rpmsg_device)
+{
+    for (uint32_t addr = ESP_AMP_RPMSG_ADDR_DYNAMIC_BASE; addr < ESP_AMP_RPMSG_ADDR_DYNAMIC_END; addr++) {
+        if (__esp_amp_rpmsg_search_endpoint(rpmsg_device, addr) == NULL) {
+            return addr;
+        }
+    }
+    return ESP_AMP_RPMSG_ADDR_ANY;
+}
+
 esp_amp_rpmsg_ept_t* esp_amp_rpmsg_create_endpoint(esp_amp_rpmsg_dev_t* rpmsg_device, uint16_t ept_addr, esp_amp_ept_cb_t ept_rx_cb, void* ept_rx_cb_data, esp_amp_rpmsg_ept_t* ept_ctx)
 {
     if (ept_ctx == NULL) {
@@ -66,7 +220,14 @@ esp_amp_rpmsg_ept_t* esp_amp_rpmsg_create_endpoint(esp_amp_rpmsg_dev_t* rpmsg_de
 
     esp_amp_env_enter_critical();
 
-    if (__esp_amp_rpmsg_search_endpoint(rpmsg_device, ept_addr) != NULL) {
+    if (ept_addr == ESP_AMP_RPMSG_ADDR_ANY) {
+        ept_addr = __esp_amp_rpmsg_alloc_addr(rpmsg_device);
+        if (ept_addr == ESP_AMP_RPMSG_ADDR_ANY) {
+            // no address left in dynamic range
+            esp_amp_env_exit_critical();
+            return NULL;
+        }
+    } else if (__esp_amp_rpmsg_search_endpoint(rpmsg_device, ept_addr) != NULL) {
         // endpoint address already exist!
         esp_amp_env_exit_critical();
         return NULL;
@@ -75,6 +236,14 @@ esp_amp_rpmsg_ept_t* esp_amp_rpmsg_create_endpoint(esp_amp_rpmsg_dev_t* rpmsg_de
     ept_ctx->addr = ept_addr;
     ept_ctx->rx_cb = ept_rx_cb;
     ept_ctx->rx_cb_data = ept_rx_cb_data;
+    ept_ctx->frag_cb = NULL;
+    ept_ctx->frag_buf = NULL;
+    ept_ctx->frag_buf_size = 0;
+    ept_ctx->frag_active = false;
+    ept_ctx->credit_window = 0;
+    ept_ctx->credit_cb = NULL;
+    ept_ctx->ns_name = NULL;
+    ept_ctx->lane = 0;
     __esp_amp_rpmsg_extend_endpoint_list(&(rpmsg_device->ept_list), ept_ctx);
 
     esp_amp_env_exit_critical();
@@ -114,6 +283,11 @@ esp_amp_rpmsg_ept_t* esp_amp_rpmsg_delete_endpoint(esp_amp_rpmsg_dev_t* rpmsg_de
 
     esp_amp_env_exit_critical();
 
+    if (cur_ept->ns_name != NULL) {
+        // tell peer the endpoint is gone
+        esp_amp_rpmsg_ns_announce(rpmsg_device, cur_ept, cur_ept->ns_name, ESP_AMP_RPMSG_NS_DESTROY);
+    }
+
     return cur_ept;
 }
 
@@ -137,9 +311,228 @@ esp_amp_rpmsg_ept_t* esp_amp_rpmsg_rebind_endpoint(esp_amp_rpmsg_dev_t* rpmsg_de
     return ept_ptr;
 }
 
+static int IRAM_ATTR __esp_amp_rpmsg_ns_send(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, const char* name, uint16_t flags)
+{
+    esp_amp_rpmsg_ns_msg_t ns_msg = {
+        .addr = ept->addr,
+        .flags = flags,
+    };
+    if (name != NULL) {
+        strncpy(ns_msg.name, name, ESP_AMP_RPMSG_NS_NAME_LEN);
+    }
+    return esp_amp_rpmsg_send(rpmsg_dev, ept, ESP_AMP_RPMSG_RESERVED_EPT_NS, &ns_msg, sizeof(esp_amp_rpmsg_ns_msg_t));
+}
+
+static void IRAM_ATTR __esp_amp_rpmsg_ns_sync(esp_amp_rpmsg_dev_t* rpmsg_dev)
+{
+    esp_amp_env_enter_critical();
+
+    for (esp_amp_rpmsg_ept_t* ept = rpmsg_dev->ept_list; ept != NULL; ept = ept->next_ept) {
+        if (ept->ns_name != NULL) {
+            __esp_amp_rpmsg_ns_send(rpmsg_dev, ept, ept->ns_name, ESP_AMP_RPMSG_NS_CREATE);
+        }
+    }
+
+    esp_amp_env_exit_critical();
+}
+
+static int IRAM_ATTR __esp_amp_rpmsg_ns_cb(void* msg_data, uint16_t data_len, uint16_t src_addr, void* rx_cb_data)
+{
+    esp_amp_rpmsg_dev_t* rpmsg_dev = (esp_amp_rpmsg_dev_t*)rx_cb_data;
+    esp_amp_rpmsg_ns_msg_t ns_msg;
+    bool valid = data_len >= sizeof(esp_amp_rpmsg_ns_msg_t);
+    if (valid) {
+        esp_amp_copy(&ns_msg, msg_data, sizeof(esp_amp_rpmsg_ns_msg_t));
+    }
+    esp_amp_rpmsg_destroy(rpmsg_dev, msg_data);
+    if (!valid) {
+        return -1;
+    }
+
+    if (ns_msg.flags == ESP_AMP_RPMSG_NS_SYNC) {
+        // peer has just enabled name service and may have missed earlier announcements
+        __esp_amp_rpmsg_ns_sync(rpmsg_dev);
+    } else if (rpmsg_dev->ns_cb != NULL) {
+        char name[ESP_AMP_RPMSG_NS_NAME_LEN + 1];
+        memcpy(name, ns_msg.name, ESP_AMP_RPMSG_NS_NAME_LEN);
+        name[ESP_AMP_RPMSG_NS_NAME_LEN] = '\0';
+        rpmsg_dev->ns_cb(name, ns_msg.addr, ns_msg.flags, rpmsg_dev->ns_cb_data);
+    }
+    return 0;
+}
+
+int esp_amp_rpmsg_ns_enable(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ns_ept_ctx, esp_amp_rpmsg_ns_cb_t ns_cb, void* ns_cb_data)
+{
+    if (ns_ept_ctx == NULL) {
+        return -1;
+    }
+
+    esp_amp_env_enter_critical();
+
+    if (__esp_amp_rpmsg_search_endpoint(rpmsg_dev, ESP_AMP_RPMSG_RESERVED_EPT_NS) != NULL) {
+        // name service already enabled
+        esp_amp_env_exit_critical();
+        return -1;
+    }
+    rpmsg_dev->ns_cb = ns_cb;
+    rpmsg_dev->ns_cb_data = ns_cb_data;
+
+    esp_amp_env_exit_critical();
+
+    if (esp_amp_rpmsg_create_endpoint(rpmsg_dev, ESP_AMP_RPMSG_RESERVED_EPT_NS, __esp_amp_rpmsg_ns_cb, rpmsg_dev, ns_ept_ctx) == NULL) {
+        return -1;
+    }
+
+    // dropped if peer is not ready yet, in which case peer sends it once ready
+    __esp_amp_rpmsg_ns_send(rpmsg_dev, ns_ept_ctx, NULL, ESP_AMP_RPMSG_NS_SYNC);
+    return 0;
+}
+
+int esp_amp_rpmsg_ns_announce(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, const char* name, uint16_t flags)
+{
+    if (ept == NULL || name == NULL || (flags != ESP_AMP_RPMSG_NS_CREATE && flags != ESP_AMP_RPMSG_NS_DESTROY)) {
+        return -1;
+    }
+
+    // remembered even if sending fails, announced again on peer's request
+    ept->ns_name = (flags == ESP_AMP_RPMSG_NS_CREATE) ? name : NULL;
+    return __esp_amp_rpmsg_ns_send(rpmsg_dev, ept, name, flags);
+}
+
+/* must be called in critical section */
+static int IRAM_ATTR __esp_amp_rpmsg_send_credit(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept)
+{
+    uint16_t* credits = (uint16_t*)esp_amp_rpmsg_create_message(rpmsg_dev, sizeof(uint16_t), ESP_AMP_RPMSG_DATA_CREDIT | ESP_AMP_RPMSG_DATA_LANE(ept->lane));
+    if (credits == NULL) {
+        return -1;
+    }
+
+    *credits = ept->rx_consumed;
+    if (esp_amp_rpmsg_send_nocopy(rpmsg_dev, ept, ept->credit_peer_addr, credits, sizeof(uint16_t)) != 0) {
+        return -1;
+    }
+    ept->rx_consumed = 0;
+    return 0;
+}
+
+/* peer destroyed one rpmsg sent with credit from `src_addr` to our endpoint `dst_addr` */
+static void IRAM_ATTR __esp_amp_rpmsg_return_credit(esp_amp_rpmsg_dev_t* rpmsg_dev, uint16_t dst_addr, uint16_t src_addr)
+{
+    esp_amp_env_enter_critical();
+
+    esp_amp_rpmsg_ept_t* ept = __esp_amp_rpmsg_search_endpoint(rpmsg_dev, dst_addr);
+    if (ept != NULL && __esp_amp_rpmsg_credit_enabled(ept, src_addr)) {
+        ept->rx_consumed++;
+        if (ept->rx_consumed >= RPMSG_CREDIT_BATCH(ept->credit_window) && __esp_amp_rpmsg_send_credit(rpmsg_dev, ept) != 0) {
+            // no buffer in the opposite direction, retry at next poll
+            rpmsg_dev->credit_return_pending = true;
+        }
+    }
+
+    esp_amp_env_exit_critical();
+}
+
+static void IRAM_ATTR __esp_amp_rpmsg_retry_credit(esp_amp_rpmsg_dev_t* rpmsg_dev)
+{
+    esp_amp_env_enter_critical();
+
+    rpmsg_dev->credit_return_pending = false;
+    for (esp_amp_rpmsg_ept_t* ept = rpmsg_dev->ept_list; ept != NULL; ept = ept->next_ept) {
+        if (ept->credit_window != 0 && ept->rx_consumed >= RPMSG_CREDIT_BATCH(ept->credit_window) && __esp_amp_rpmsg_send_credit(rpmsg_dev, ept) != 0) {
+            rpmsg_dev->credit_return_pending = true;
+        }
+    }
+
+    esp_amp_env_exit_critical();
+}
+
+static void IRAM_ATTR __esp_amp_rpmsg_credit_rx(esp_amp_rpmsg_ept_t* ept, esp_amp_rpmsg_t* rpmsg)
+{
+    if (!__esp_amp_rpmsg_credit_enabled(ept, rpmsg->msg_head.src_addr) || rpmsg->msg_head.data_len < sizeof(uint16_t)) {
+        return;
+    }
+
+    esp_amp_env_enter_critical();
+
+    uint32_t tx_credits = ept->tx_credits + *(uint16_t*)(rpmsg->msg_data);
+    ept->tx_credits = tx_credits > ept->credit_window ? ept->credit_window : tx_credits;
+    uint16_t credits_now = ept->tx_credits;
+
+    esp_amp_env_exit_critical();
+
+    if (ept->credit_cb != NULL) {
+        ept->credit_cb(ept, credits_now, ept->credit_cb_data);
+    }
+}
+
+static void IRAM_ATTR __esp_amp_rpmsg_frag_rx(esp_amp_rpmsg_ept_t* ept, esp_amp_rpmsg_t* rpmsg)
+{
+    uint16_t flags = rpmsg->msg_head.data_flags;
+    uint16_t src_addr = rpmsg->msg_head.src_addr;
+    uint8_t* data = rpmsg->msg_data;
+    uint32_t data_len = rpmsg->msg_head.data_len;
+
+    if (flags & ESP_AMP_RPMSG_DATA_FRAG_FIRST) {
+        if (data_len < sizeof(uint32_t)) {
+            ept->frag_active = false;
+            return;
+        }
+        // a new message drops the incomplete one
+        esp_amp_copy(&ept->frag_total, data, sizeof(uint32_t));
+        data += sizeof(uint32_t);
+        data_len -= sizeof(uint32_t);
+        ept->frag_offset = 0;
+        ept->frag_src_addr = src_addr;
+        ept->frag_active = (ept->frag_buf == NULL || ept->frag_total <= ept->frag_buf_size);
+    }
+
+    if (!ept->frag_active || ept->frag_src_addr != src_addr) {
+        // first fragment is lost, dropped, or fragment comes from another sender
+        return;
+    }
+
+    if (ept->frag_offset + data_len > ept->frag_total) {
+        ept->frag_active = false;
+        return;
+    }
+
+    if (ept->frag_buf != NULL) {
+        esp_amp_copy(ept->frag_buf + ept->frag_offset, data, data_len);
+    } else if (ept->frag_cb != NULL) {
+        ept->frag_cb(data, data_len, ept->frag_offset, ept->frag_total, src_addr, ept->rx_cb_data);
+    }
+    ept->frag_offset += data_len;
+
+    if (flags & ESP_AMP_RPMSG_DATA_FRAG_LAST) {
+        ept->frag_active = false;
+        if (ept->frag_buf != NULL && ept->frag_cb != NULL && ept->frag_offset == ept->frag_total) {
+            ept->frag_cb(ept->frag_buf, ept->frag_total, 0, ept->frag_total, src_addr, ept->rx_cb_data);
+        }
+    }
+}
+
 static int IRAM_ATTR __esp_amp_rpmsg_dispatcher(esp_amp_rpmsg_t* rpmsg, esp_amp_rpmsg_dev_t* rpmsg_dev)
 {
     esp_amp_rpmsg_ept_t* ept = __esp_amp_rpmsg_search_endpoint(rpmsg_dev, rpmsg->msg_head.dst_addr);
+
+    if (rpmsg->msg_head.data_flags & ESP_AMP_RPMSG_DATA_CREDIT) {
+        // control rpmsg of flow control, consumed by rpmsg framework
+        if (ept != NULL) {
+            __esp_amp_rpmsg_credit_rx(ept, rpmsg);
+        }
+        esp_amp_rpmsg_destroy(rpmsg_dev, rpmsg->msg_data);
+        return ept != NULL ? 0 : -1;
+    }
+
+    if (rpmsg->msg_head.data_flags & ESP_AMP_RPMSG_DATA_FRAG) {
+        // fragments are consumed by rpmsg framework
+        if (ept != NULL) {
+            __esp_amp_rpmsg_frag_rx(ept, rpmsg);
+        }
+        esp_amp_rpmsg_destroy(rpmsg_dev, rpmsg->msg_data);
+        return ept != NULL ? 0 : -1;
+    }
+
     if (ept == NULL) {
         // can't find endpoint, ignore and return
         return -1;
@@ -153,15 +546,119 @@ static int IRAM_ATTR __esp_amp_rpmsg_dispatcher(esp_amp_rpmsg_t* rpmsg, esp_amp_
     return 0;
 }
 
+int esp_amp_rpmsg_set_frag_rx(esp_amp_rpmsg_ept_t* ept, esp_amp_ept_frag_cb_t frag_cb, void* buf, uint32_t buf_size)
+{
+    if (ept == NULL) {
+        return -1;
+    }
+
+    esp_amp_env_enter_critical();
+
+    ept->frag_cb = frag_cb;
+    ept->frag_buf = (uint8_t*)buf;
+    ept->frag_buf_size = buf != NULL ? buf_size : 0;
+    ept->frag_active = false;
+
+    esp_amp_env_exit_critical();
+
+    return 0;
+}
+
+/* drop one reference to the packed rpmsg holding `member`, give the buffer back after its last member */
+static int IRAM_ATTR __esp_amp_rpmsg_release_member(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_t* member)
+{
+    esp_amp_rpmsg_t* pack = (esp_amp_rpmsg_t*)((uint8_t*)(member) - ((uint32_t)(member->msg_head.dst_addr) << 2));
+    int ret = 0;
+
+    esp_amp_env_enter_critical();
+
+    if (--pack->msg_head.src_addr == 0) {
+        // packs only travel on lane 0
+        ret = rpmsg_dev->queue_ops.q_rx_free(rpmsg_dev->rx_queue, pack);
+    }
+
+    esp_amp_env_exit_critical();
+
+    return ret;
+}
+
+static int IRAM_ATTR __esp_amp_rpmsg_unpack(esp_amp_rpmsg_t* pack, uint16_t pack_size, esp_amp_rpmsg_dev_t* rpmsg_dev)
+{
+    uint16_t pack_len = pack->msg_head.data_len;
+    if (pack_size < offsetof(esp_amp_rpmsg_t, msg_data)) {
+        pack_len = 0;
+    } else if (pack_len > pack_size - offsetof(esp_amp_rpmsg_t, msg_data)) {
+        pack_len = pack_size - offsetof(esp_amp_rpmsg_t, msg_data);
+    }
+    uint16_t member_cnt = 0;
+
+    for (uint32_t offset = 0; offset + offsetof(esp_amp_rpmsg_t, msg_data) <= pack_len;) {
+        esp_amp_rpmsg_t* member = (esp_amp_rpmsg_t*)(pack->msg_data + offset);
+        if (offset + offsetof(esp_amp_rpmsg_t, msg_data) + member->msg_head.data_len > pack_len) {
+            // malformed member runs past the pack, drop it and whatever follows
+            break;
+        }
+        offset += RPMSG_PACK_MEMBER_SIZE(member->msg_head.data_len);
+        member_cnt++;
+    }
+
+    if (member_cnt == 0) {
+        return rpmsg_dev->queue_ops.q_rx_free(rpmsg_dev->rx_queue, pack);
+    }
+
+    /* buffer is ours until given back, so its head keeps count of members not destroyed yet */
+    pack->msg_head.src_addr = member_cnt;
+    uint8_t* pos = pack->msg_data;
+    for (uint16_t i = 0; i < member_cnt; i++) {
+        esp_amp_rpmsg_t* member = (esp_amp_rpmsg_t*)(pos);
+        pos += RPMSG_PACK_MEMBER_SIZE(member->msg_head.data_len);
+
+        esp_amp_rpmsg_ept_t* ept = __esp_amp_rpmsg_search_endpoint(rpmsg_dev, member->msg_head.dst_addr);
+        /* dst_addr is no longer needed, it now links the member back to the packed buffer (in words) */
+        member->msg_head.dst_addr = (uint16_t)(((uint8_t*)(member) - (uint8_t*)(pack)) >> 2);
+        member->msg_head.data_flags |= ESP_AMP_RPMSG_DATA_PACKED_MEMBER;
+
+        if (ept == NULL || ept->rx_cb == NULL) {
+            // nobody will destroy this member
+            __esp_amp_rpmsg_release_member(rpmsg_dev, member);
+            continue;
+        }
+        ept->rx_cb((void*)(member->msg_data), member->msg_head.data_len, member->msg_head.src_addr, ept->rx_cb_data);
+    }
+
+    return 0;
+}
+
 int IRAM_ATTR esp_amp_rpmsg_poll(esp_amp_rpmsg_dev_t* rpmsg_dev)
 {
+    if (rpmsg_dev->tx_pack != NULL) {
+        __esp_amp_rpmsg_flush_expired(rpmsg_dev);
+    }
+
+    if (rpmsg_dev->credit_return_pending) {
+        __esp_amp_rpmsg_retry_credit(rpmsg_dev);
+    }
+
     esp_amp_rpmsg_t* rpmsg;
     uint16_t rpmsg_size;
-    if (rpmsg_dev->queue_ops.q_rx(rpmsg_dev->rx_queue, (void**)(&rpmsg), &rpmsg_size) != 0) {
+    int lane = rpmsg_dev->lane_num > 1 ? rpmsg_dev->lane_num - 1 : 0;
+    for (; lane >= 0; lane--) {
+        // higher lane has higher priority, so its rpmsgs never wait behind those of lower lanes
+        esp_amp_queue_t* rx_queue = (lane == 0) ? rpmsg_dev->rx_queue : rpmsg_dev->lane_rx_queue[lane];
+        if (rpmsg_dev->queue_ops.q_rx(rx_queue, (void**)(&rpmsg), &rpmsg_size) == 0) {
+            break;
+        }
+    }
+
+    if (lane < 0) {
         // nothing to receive
         return -1;
     }
 
+    if (rpmsg->msg_head.data_flags & ESP_AMP_RPMSG_DATA_PACKED) {
+        return __esp_amp_rpmsg_unpack(rpmsg, rpmsg_size, rpmsg_dev);
+    }
+
     return __esp_amp_rpmsg_dispatcher(rpmsg, rpmsg_dev);
 }
 
@@ -171,108 +668,216 @@ static int IRAM_ATTR __esp_amp_rpmsg_rx_callback(void* data)
     while (esp_amp_rpmsg_poll(rpmsg_dev) == 0) {
         // receive and process all avaialble vqueue item
     }
+
+    if (rpmsg_dev->tx_waiting != 0) {
+        // same doorbell is rung when peer gives back tx buffers, wake up senders to check
+        rpmsg_dev->tx_space = true;
+        if (rpmsg_dev->tx_wait_queue != NULL) {
+            uint8_t signal = 1;
+            esp_amp_env_queue_send(rpmsg_dev->tx_wait_queue, &signal, 0);
+        }
+    }
     return 0;
 }
 
 static int IRAM_ATTR __esp_amp_rpmsg_tx_notify(void* data)
 {
-    esp_amp_sw_intr_trigger(SW_INTR_RESERVED_ID_RPMSG);
+    esp_amp_rpmsg_dev_t* rpmsg_dev = (esp_amp_rpmsg_dev_t*) data;
+    esp_amp_sw_intr_trigger(rpmsg_dev->sw_intr_id);
+    return 0;
+}
+
+int esp_amp_rpmsg_set_intr_id(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_sw_intr_id_t sw_intr_id, esp_amp_sw_intr_prio_t prio)
+{
+    if ((int)sw_intr_id > (int)SW_INTR_ID_15 && sw_intr_id != SW_INTR_RESERVED_ID_RPMSG) {
+        return -1;
+    }
+
+    if (rpmsg_dev->intr_enabled) {
+        // handler is already installed on the old one
+        return -1;
+    }
+
+    if (esp_amp_sw_intr_set_priority(sw_intr_id, prio) != 0) {
+        return -1;
+    }
+
+    rpmsg_dev->sw_intr_id = sw_intr_id;
+    return 0;
+}
+
+int esp_amp_rpmsg_set_lane(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint8_t lane)
+{
+    if (ept == NULL || (lane != 0 && lane >= rpmsg_dev->lane_num)) {
+        return -1;
+    }
+
+    esp_amp_env_enter_critical();
+
+    ept->lane = lane;
+
+    esp_amp_env_exit_critical();
+
     return 0;
 }
 
 int esp_amp_rpmsg_intr_enable(esp_amp_rpmsg_dev_t* rpmsg_dev)
 {
-    return esp_amp_queue_intr_enable(rpmsg_dev->rx_queue, SW_INTR_RESERVED_ID_RPMSG);
+    int ret = esp_amp_queue_intr_enable(rpmsg_dev->rx_queue, rpmsg_dev->sw_intr_id);
+    if (ret != 0) {
+        return ret;
+    }
+    rpmsg_dev->intr_enabled = true;
+
+#if !IS_ENV_BM
+    if (rpmsg_dev->tx_wait_queue == NULL && esp_amp_env_queue_create(&rpmsg_dev->tx_wait_queue, 1, sizeof(uint8_t)) != 0) {
+        // senders fall back to checking for free buffers periodically
+        rpmsg_dev->tx_wait_queue = NULL;
+        return 0;
+    }
+#endif
+    rpmsg_dev->tx_doorbell = true;
+    return 0;
 }
 
-static void __esp_amp_rpmsg_dev_init(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t vqueue[])
+/* `vqueue` holds tx and rx virtqueue of each lane in turn */
+static void __esp_amp_rpmsg_dev_init(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t vqueue[], uint8_t lane_num)
 {
     rpmsg_dev->tx_queue = &vqueue[0];
     rpmsg_dev->rx_queue = &vqueue[1];
+    rpmsg_dev->lane_num = lane_num;
+    for (uint8_t lane = 0; lane < ESP_AMP_RPMSG_MAX_LANES; lane++) {
+        rpmsg_dev->lane_tx_queue[lane] = lane < lane_num ? &vqueue[2 * lane] : NULL;
+        rpmsg_dev->lane_rx_queue[lane] = lane < lane_num ? &vqueue[2 * lane + 1] : NULL;
+    }
     rpmsg_dev->ept_list = NULL;
     rpmsg_dev->queue_ops.q_tx = esp_amp_queue_send_try;
     rpmsg_dev->queue_ops.q_tx_alloc = esp_amp_queue_alloc_try;
     rpmsg_dev->queue_ops.q_rx = esp_amp_queue_recv_try;
     rpmsg_dev->queue_ops.q_rx_free = esp_amp_queue_free_try;
+    rpmsg_dev->tx_pack = NULL;
+    rpmsg_dev->tx_pack_len = 0;
+    rpmsg_dev->tx_pack_flush_size = 0;
+    rpmsg_dev->tx_pack_timeout_ms = 0;
+    rpmsg_dev->tx_pack_start_ms = 0;
+    rpmsg_dev->credit_return_pending = false;
+    rpmsg_dev->sw_intr_id = SW_INTR_RESERVED_ID_RPMSG;
+    rpmsg_dev->intr_enabled = false;
+    rpmsg_dev->tx_doorbell = false;
+    rpmsg_dev->tx_space = false;
+    rpmsg_dev->tx_waiting = 0;
+    rpmsg_dev->tx_wait_queue = NULL;
+    rpmsg_dev->ns_cb = NULL;
+    rpmsg_dev->ns_cb_data = NULL;
+
+    // ring the same doorbell as for new rpmsgs when giving back buffers peer waits for
+    for (uint8_t lane = 0; lane < lane_num; lane++) {
+        esp_amp_queue_free_notify_enable(rpmsg_dev->lane_rx_queue[lane], rpmsg_dev->tx_queue->notify_fc);
+    }
 }
 
 #if IS_MAIN_CORE
-int esp_amp_rpmsg_main_init_by_id(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id)
+int esp_amp_rpmsg_main_init_lanes(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], uint8_t lane_num, uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id)
 {
     // force to ceil the queue length to power of 2
     uint16_t aligned_queue_len = get_power_len(queue_len);
-    // force to align the queue item size with word boundary
-    uint16_t aligned_queue_item_size = get_aligned_size(queue_item_size);
+    // force to align the queue item size with word (or cache line) boundary
+    uint16_t aligned_queue_item_size = get_queue_item_size(queue_item_size);
 
-    if (aligned_queue_len == 0 || aligned_queue_item_size == 0) {
+    if (lane_num == 0 || lane_num > ESP_AMP_RPMSG_MAX_LANES || aligned_queue_len == 0 || aligned_queue_item_size == 0) {
         return -1;
     }
 
     esp_amp_queue_cb_t tx_notify = notify ? __esp_amp_rpmsg_tx_notify : NULL;
     esp_amp_queue_cb_t rx_callback = poll ? NULL : __esp_amp_rpmsg_rx_callback;
 
-    size_t queue_shm_size = 2 * (sizeof(esp_amp_queue_conf_t) + sizeof(esp_amp_queue_desc_t) * aligned_queue_len + aligned_queue_item_size * aligned_queue_len);
-    // alloc fixed-size buffer for TX/RX Virtqueue
-    uint8_t* vq_buffer = (uint8_t*)(esp_amp_sys_info_alloc(sysinfo_id, queue_shm_size));
+    // TX and RX Virtqueue of each lane
+    uint32_t vq_num = 2 * lane_num;
+    size_t queue_ctrl_size = sizeof(esp_amp_rpmsg_shm_t) + vq_num * (sizeof(esp_amp_queue_conf_t) + sizeof(esp_amp_queue_desc_t) * aligned_queue_len);
+    size_t queue_data_size = vq_num * aligned_queue_item_size * aligned_queue_len;
+    // alloc fixed-size buffer for all Virtqueues
+    void* vq_data_buffer;
+    uint32_t vq_data_caps = 0;
+    uint8_t* vq_buffer = (uint8_t*)(alloc_queue_shm(sysinfo_id, queue_ctrl_size, queue_data_size, &vq_data_buffer, &vq_data_caps));
     if (vq_buffer == NULL) {
         // reserve memory not enough or corresponding sys_info already occupied
         return -1;
     }
 
-    esp_amp_queue_conf_t* vq_tx_confg = (esp_amp_queue_conf_t*)(vq_buffer);
-    vq_buffer += sizeof(esp_amp_queue_conf_t);
-    esp_amp_queue_conf_t* vq_rx_confg = (esp_amp_queue_conf_t*)(vq_buffer);
-    vq_buffer += sizeof(esp_amp_queue_conf_t);
-    esp_amp_queue_desc_t* vq_tx_desc = (esp_amp_queue_desc_t*)(vq_buffer);
-    vq_buffer += sizeof(esp_amp_queue_desc_t) * aligned_queue_len;
-    esp_amp_queue_desc_t* vq_rx_desc = (esp_amp_queue_desc_t*)(vq_buffer);
-    vq_buffer += sizeof(esp_amp_queue_desc_t) * aligned_queue_len;
-    void* vq_tx_data_buffer = (void*)(vq_buffer);
-    vq_buffer += aligned_queue_item_size * aligned_queue_len;
-    void* vq_rx_data_buffer = (void*)(vq_buffer);
-
-    // initialize the queue config
-    esp_amp_queue_init_buffer(vq_tx_confg, aligned_queue_len, aligned_queue_item_size, vq_tx_desc, vq_tx_data_buffer);
-    esp_amp_queue_init_buffer(vq_rx_confg, aligned_queue_len, aligned_queue_item_size, vq_rx_desc, vq_rx_data_buffer);
-    // initialize the local queue structure
-    esp_amp_queue_create(&rpmsg_vqueue[0], vq_tx_confg, tx_notify, (void*)(rpmsg_dev), true);
-    esp_amp_queue_create(&rpmsg_vqueue[1], vq_rx_confg, rx_callback, (void*)(rpmsg_dev), false);
+    // configs of all Virtqueues go first, so subcore finds them without knowing queue length
+    esp_amp_rpmsg_shm_t* rpmsg_shm = (esp_amp_rpmsg_shm_t*)(vq_buffer);
+    rpmsg_shm->lane_num = lane_num;
+    rpmsg_shm->reserved = 0;
+    esp_amp_queue_conf_t* vq_confg = rpmsg_shm->vq_conf;
+    esp_amp_queue_desc_t* vq_desc = (esp_amp_queue_desc_t*)(&vq_confg[vq_num]);
+    uint8_t* vq_data = (uint8_t*)vq_data_buffer;
+
+    for (uint32_t i = 0; i < vq_num; i++) {
+        // initialize the queue config
+        esp_amp_queue_init_buffer(&vq_confg[i], aligned_queue_len, aligned_queue_item_size, vq_desc + i * aligned_queue_len, vq_data + i * aligned_queue_item_size * aligned_queue_len);
+        vq_confg[i].buffer_caps = vq_data_caps;
+        // initialize the local queue structure, maincore sends on the first Virtqueue of each lane
+        bool is_tx = (i & 1) == 0;
+        esp_amp_queue_create(&rpmsg_vqueue[i], &vq_confg[i], is_tx ? tx_notify : rx_callback, (void*)(rpmsg_dev), is_tx);
+    }
 
-    __esp_amp_rpmsg_dev_init(rpmsg_dev, rpmsg_vqueue);
+    __esp_amp_rpmsg_dev_init(rpmsg_dev, rpmsg_vqueue, lane_num);
 
     return 0;
 }
 
+int esp_amp_rpmsg_main_init_by_id(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id)
+{
+    return esp_amp_rpmsg_main_init_lanes(rpmsg_dev, rpmsg_vqueue, 1, queue_len, queue_item_size, notify, poll, sysinfo_id);
+}
+
 int esp_amp_rpmsg_main_init(esp_amp_rpmsg_dev_t* rpmsg_dev, uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll)
 {
     static esp_amp_queue_t vqueue[2];
     return esp_amp_rpmsg_main_init_by_id(rpmsg_dev, vqueue, queue_len, queue_item_size, notify, poll, SYS_INFO_RESERVED_ID_VQUEUE);
 }
-#else
-int esp_amp_rpmsg_sub_init_by_id(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id)
+#endif /* IS_MAIN_CORE */
+
+/* counterpart of esp_amp_rpmsg_main_init_lanes(), also usable on maincore to receive the way subcore does */
+int esp_amp_rpmsg_sub_init_lanes(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], uint8_t lane_num, bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id)
 {
+    if (lane_num == 0 || lane_num > ESP_AMP_RPMSG_MAX_LANES) {
+        return -1;
+    }
+
     uint16_t queue_shm_size;
-    uint8_t* vq_buffer = esp_amp_sys_info_get(sysinfo_id, &queue_shm_size);
+    esp_amp_rpmsg_shm_t* rpmsg_shm = (esp_amp_rpmsg_shm_t*)esp_amp_sys_info_get(sysinfo_id, &queue_shm_size);
 
-    if (vq_buffer == NULL) {
+    if (rpmsg_shm == NULL || queue_shm_size < sizeof(esp_amp_rpmsg_shm_t) + 2 * lane_num * sizeof(esp_amp_queue_conf_t)) {
+        return -1;
+    }
+
+    if (rpmsg_shm->lane_num != lane_num) {
+        // maincore created a different number of lanes, virtqueues would not pair up
         return -1;
     }
 
     esp_amp_queue_cb_t tx_notify = notify ? __esp_amp_rpmsg_tx_notify : NULL;
     esp_amp_queue_cb_t rx_callback = poll ? NULL : __esp_amp_rpmsg_rx_callback;
 
-    // Note: the configuration is different from the queue_main_init, since the main TX is sub RX; main RX is sub TX;
-    esp_amp_queue_conf_t* vq_tx_confg = (esp_amp_queue_conf_t*)(vq_buffer + sizeof(esp_amp_queue_conf_t));
-    esp_amp_queue_conf_t* vq_rx_confg = (esp_amp_queue_conf_t*)(vq_buffer);
-    // initialize the local queue structure
-    esp_amp_queue_create(&rpmsg_vqueue[0], vq_tx_confg, tx_notify, (void*)(rpmsg_dev), true);
-    esp_amp_queue_create(&rpmsg_vqueue[1], vq_rx_confg, rx_callback, (void*)(rpmsg_dev), false);
+    esp_amp_queue_conf_t* vq_confg = rpmsg_shm->vq_conf;
+    for (uint32_t i = 0; i < 2 * lane_num; i++) {
+        // Note: the configuration is different from the queue_main_init, since the main TX is sub RX; main RX is sub TX;
+        bool is_tx = (i & 1) == 0;
+        esp_amp_queue_create(&rpmsg_vqueue[i], &vq_confg[i ^ 1], is_tx ? tx_notify : rx_callback, (void*)(rpmsg_dev), is_tx);
+    }
 
-    __esp_amp_rpmsg_dev_init(rpmsg_dev, rpmsg_vqueue);
+    __esp_amp_rpmsg_dev_init(rpmsg_dev, rpmsg_vqueue, lane_num);
 
     return 0;
 }
 
+int esp_amp_rpmsg_sub_init_by_id(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], bool notify, bool poll, esp_amp_sys_info_id_t sysinfo_id)
+{
+    return esp_amp_rpmsg_sub_init_lanes(rpmsg_dev, rpmsg_vqueue, 1, notify, poll, sysinfo_id);
+}
+
+#if !IS_MAIN_CORE
 int esp_amp_rpmsg_sub_init(esp_amp_rpmsg_dev_t* rpmsg_dev, bool notify, bool poll)
 {
     static esp_amp_queue_t vqueue[2];
@@ -280,17 +885,66 @@ int esp_amp_rpmsg_sub_init(esp_amp_rpmsg_dev_t* rpmsg_dev, bool notify, bool pol
 }
 #endif
 
-void* esp_amp_rpmsg_create_message(esp_amp_rpmsg_dev_t* rpmsg_dev, uint32_t nbytes, uint16_t flags)
+int esp_amp_rpmsg_static_init_lanes(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], void* storage, uint8_t lane_num, uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll)
+{
+    if (storage == NULL || lane_num == 0 || lane_num > ESP_AMP_RPMSG_MAX_LANES) {
+        return -1;
+    }
+
+    esp_amp_queue_cb_t tx_notify = notify ? __esp_amp_rpmsg_tx_notify : NULL;
+    esp_amp_queue_cb_t rx_callback = poll ? NULL : __esp_amp_rpmsg_rx_callback;
+
+    // same layout as ESP_AMP_RPMSG_STATIC_LANES_T: main-to-sub virtqueue followed by sub-to-main virtqueue of each lane
+    uint32_t vq_storage_size = sizeof(esp_amp_queue_conf_t) + (sizeof(esp_amp_queue_desc_t) + queue_item_size) * queue_len;
+    for (uint32_t i = 0; i < 2 * lane_num; i++) {
+        bool is_tx = (i & 1) == 0;
+#if IS_MAIN_CORE
+        uint8_t* vq_storage = (uint8_t*)storage + i * vq_storage_size;
+#else
+        uint8_t* vq_storage = (uint8_t*)storage + (i ^ 1) * vq_storage_size;
+#endif
+        if (esp_amp_queue_static_init(&rpmsg_vqueue[i], vq_storage, queue_len, queue_item_size, is_tx ? tx_notify : rx_callback, (void*)(rpmsg_dev), is_tx) != ESP_OK) {
+            return -1;
+        }
+    }
+
+    __esp_amp_rpmsg_dev_init(rpmsg_dev, rpmsg_vqueue, lane_num);
+
+    return 0;
+}
+
+int esp_amp_rpmsg_static_init(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_queue_t rpmsg_vqueue[], void* storage, uint16_t queue_len, uint16_t queue_item_size, bool notify, bool poll)
+{
+    return esp_amp_rpmsg_static_init_lanes(rpmsg_dev, rpmsg_vqueue, storage, 1, queue_len, queue_item_size, notify, poll);
+}
+
+/**
+ * Allocate a tx buffer. If rpmsgs from `ept` to `dst_addr` are flow-controlled, one credit
+ * is taken together with the buffer, so that a buffer is never handed out without a credit
+ * to send it. `ept` is NULL if the caller sends the buffer by esp_amp_rpmsg_send_nocopy(),
+ * which takes the credit itself.
+ */
+static void* __esp_amp_rpmsg_create(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, uint32_t nbytes, uint16_t flags)
 {
     uint32_t rpmsg_size = nbytes + offsetof(esp_amp_rpmsg_t, msg_data);
-    esp_amp_rpmsg_t* rpmsg;
-    if (rpmsg_size >= (uint32_t)(1) << 16) {
+    esp_amp_rpmsg_t* rpmsg = NULL;
+    esp_amp_queue_t* tx_queue = __esp_amp_rpmsg_lane_tx_queue(rpmsg_dev, flags);
+    if (rpmsg_size >= (uint32_t)(1) << 16 || tx_queue == NULL) {
         return NULL;
     }
 
+    bool credit = ept != NULL && __esp_amp_rpmsg_credit_enabled(ept, dst_addr);
+    int ret = -1;
+
     esp_amp_env_enter_critical();
 
-    int ret = rpmsg_dev->queue_ops.q_tx_alloc(rpmsg_dev->tx_queue, (void**)(&rpmsg), rpmsg_size);
+    if (!credit || ept->tx_credits != 0) {
+        ret = rpmsg_dev->queue_ops.q_tx_alloc(tx_queue, (void**)(&rpmsg), rpmsg_size);
+        if (credit && ret == 0 && rpmsg != NULL) {
+            ept->tx_credits--;
+            flags |= ESP_AMP_RPMSG_DATA_CREDIT_REQ;
+        }
+    }
 
     esp_amp_env_exit_critical();
 
@@ -304,6 +958,94 @@ void* esp_amp_rpmsg_create_message(esp_amp_rpmsg_dev_t* rpmsg_dev, uint32_t nbyt
     return (void*)((uint8_t*)(rpmsg) + offsetof(esp_amp_rpmsg_t, msg_data));
 }
 
+void* esp_amp_rpmsg_create_message(esp_amp_rpmsg_dev_t* rpmsg_dev, uint32_t nbytes, uint16_t flags)
+{
+    // credit is taken by esp_amp_rpmsg_send_nocopy() for buffers allocated by user
+    return __esp_amp_rpmsg_create(rpmsg_dev, NULL, 0, nbytes, flags & ~ESP_AMP_RPMSG_DATA_CREDIT_REQ);
+}
+
+/* time left of `timeout_ms` since `start_ms`, 0 if timeout */
+static uint32_t __esp_amp_rpmsg_time_left(uint32_t start_ms, uint32_t timeout_ms)
+{
+    if (timeout_ms == ESP_AMP_RPMSG_MAX_DELAY) {
+        return ESP_AMP_RPMSG_MAX_DELAY;
+    }
+
+    uint32_t elapsed_ms = esp_amp_platform_get_time_ms() - start_ms;
+    return elapsed_ms >= timeout_ms ? 0 : timeout_ms - elapsed_ms;
+}
+
+/* sleep until doorbell rings or timeout, may return earlier */
+static void __esp_amp_rpmsg_tx_wait(esp_amp_rpmsg_dev_t* rpmsg_dev, uint32_t timeout_ms)
+{
+    if (!rpmsg_dev->tx_doorbell) {
+        // doorbell is not handled on this core, check again later
+        esp_amp_platform_delay_us(RPMSG_TX_RETRY_DELAY_US);
+        return;
+    }
+
+#if !IS_ENV_BM
+    uint8_t signal;
+    esp_amp_env_queue_recv(rpmsg_dev->tx_wait_queue, &signal, timeout_ms);
+#else
+    if (timeout_ms != ESP_AMP_RPMSG_MAX_DELAY) {
+        // no timer interrupt to bound the stall, check again later
+        esp_amp_platform_delay_us(RPMSG_TX_RETRY_DELAY_US);
+        return;
+    }
+
+    // pending doorbell wakes up the core even with interrupt disabled, handled after exiting critical section
+    esp_amp_env_enter_critical();
+    if (!rpmsg_dev->tx_space) {
+        esp_amp_platform_wait_for_intr();
+    }
+    esp_amp_env_exit_critical();
+#endif
+}
+
+/* wait for a tx buffer, and for a credit if `ept` is given, see __esp_amp_rpmsg_create() */
+static void* __esp_amp_rpmsg_create_timeout(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, uint32_t nbytes, uint16_t flags, uint32_t timeout_ms)
+{
+    void* msg_data = __esp_amp_rpmsg_create(rpmsg_dev, ept, dst_addr, nbytes, flags);
+    esp_amp_queue_t* tx_queue = __esp_amp_rpmsg_lane_tx_queue(rpmsg_dev, flags);
+    if (msg_data != NULL || timeout_ms == 0 || tx_queue == NULL || nbytes > esp_amp_rpmsg_get_max_size(rpmsg_dev) || esp_amp_env_in_isr()) {
+        return msg_data;
+    }
+
+    uint32_t start_ms = esp_amp_platform_get_time_ms();
+
+    esp_amp_env_enter_critical();
+    rpmsg_dev->tx_waiting++;
+    esp_amp_env_exit_critical();
+
+    while (1) {
+        rpmsg_dev->tx_space = false;
+        // peer rings doorbell when freeing a buffer or returning credits after this point, so check once more before sleeping
+        esp_amp_queue_request_free_notify(tx_queue);
+        msg_data = __esp_amp_rpmsg_create(rpmsg_dev, ept, dst_addr, nbytes, flags);
+        if (msg_data != NULL) {
+            break;
+        }
+
+        uint32_t left_ms = __esp_amp_rpmsg_time_left(start_ms, timeout_ms);
+        if (left_ms == 0) {
+            break;
+        }
+        __esp_amp_rpmsg_tx_wait(rpmsg_dev, left_ms);
+    }
+
+    esp_amp_env_enter_critical();
+    rpmsg_dev->tx_waiting--;
+    esp_amp_env_exit_critical();
+
+    return msg_data;
+}
+
+void* esp_amp_rpmsg_create_message_timeout(esp_amp_rpmsg_dev_t* rpmsg_dev, uint32_t nbytes, uint16_t flags, uint32_t timeout_ms)
+{
+    return __esp_amp_rpmsg_create_timeout(rpmsg_dev, NULL, 0, nbytes, flags & ~ESP_AMP_RPMSG_DATA_CREDIT_REQ, timeout_ms);
+}
+
 int esp_amp_rpmsg_send(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, void* data, uint16_t data_len)
 {
 
@@ -311,19 +1053,130 @@ int esp_amp_rpmsg_send(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept,
         return -1;
     }
 
-    void* buffer = esp_amp_rpmsg_create_message(rpmsg_dev, data_len, ESP_AMP_RPMSG_DATA_DEFAULT);
+    if (rpmsg_dev->tx_pack_flush_size != 0) {
+        esp_amp_rpmsg_iovec_t iov = { .data = data, .len = data_len };
+        int ret = __esp_amp_rpmsg_pack(rpmsg_dev, ept, dst_addr, &iov, 1, data_len);
+        if (ret != 1) {
+            return ret;
+        }
+    }
+
+    void* buffer = __esp_amp_rpmsg_create(rpmsg_dev, ept, dst_addr, data_len, ESP_AMP_RPMSG_DATA_LANE(ept->lane));
 
     if (buffer == NULL) {
         return -1;
     }
 
-    for (uint16_t i = 0; i < data_len; i++) {
-        ((uint8_t*)(buffer))[i] = ((uint8_t*)(data))[i];
-    }
+    esp_amp_copy(buffer, data, data_len);
 
     return esp_amp_rpmsg_send_nocopy(rpmsg_dev, ept, dst_addr, buffer, data_len);
 }
 
+int esp_amp_rpmsg_sendv(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, const esp_amp_rpmsg_iovec_t* iov, uint16_t iov_cnt)
+{
+    if (iov == NULL) {
+        return -1;
+    }
+
+    uint32_t data_len = 0;
+    for (uint16_t i = 0; i < iov_cnt; i++) {
+        if (iov[i].data == NULL && iov[i].len != 0) {
+            return -1;
+        }
+        data_len += iov[i].len;
+    }
+
+    if (data_len == 0 || data_len > UINT16_MAX) {
+        return -1;
+    }
+
+    if (rpmsg_dev->tx_pack_flush_size != 0) {
+        int ret = __esp_amp_rpmsg_pack(rpmsg_dev, ept, dst_addr, iov, iov_cnt, (uint16_t)data_len);
+        if (ret != 1) {
+            return ret;
+        }
+    }
+
+    uint8_t* buffer = (uint8_t*)__esp_amp_rpmsg_create(rpmsg_dev, ept, dst_addr, data_len, ESP_AMP_RPMSG_DATA_LANE(ept->lane));
+
+    if (buffer == NULL) {
+        return -1;
+    }
+
+    /* gather fragments straight into the tx buffer */
+    uint8_t* pos = buffer;
+    for (uint16_t i = 0; i < iov_cnt; i++) {
+        esp_amp_copy(pos, iov[i].data, iov[i].len);
+        pos += iov[i].len;
+    }
+
+    return esp_amp_rpmsg_send_nocopy(rpmsg_dev, ept, dst_addr, buffer, (uint16_t)data_len);
+}
+
+uint16_t esp_amp_rpmsg_scatter(const void* msg_data, uint16_t data_len, const esp_amp_rpmsg_iovec_t* iov, uint16_t iov_cnt)
+{
+    const uint8_t* pos = (const uint8_t*)msg_data;
+    uint16_t left = data_len;
+
+    if (msg_data == NULL || iov == NULL) {
+        return 0;
+    }
+
+    for (uint16_t i = 0; i < iov_cnt && left > 0; i++) {
+        uint16_t len = iov[i].len < left ? iov[i].len : left;
+        if (iov[i].data != NULL) {
+            esp_amp_copy(iov[i].data, pos, len);
+        }
+        pos += len;
+        left -= len;
+    }
+
+    return data_len - left;
+}
+
+int esp_amp_rpmsg_send_large(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, const void* data, uint32_t data_len, uint32_t timeout_ms)
+{
+    uint16_t max_size = esp_amp_rpmsg_get_max_size(rpmsg_dev);
+
+    if (data == NULL || data_len == 0 || max_size <= sizeof(uint32_t)) {
+        return -1;
+    }
+
+    const uint8_t* pos = (const uint8_t*)data;
+    uint32_t left = data_len;
+    uint32_t start_ms = esp_amp_platform_get_time_ms();
+    uint16_t flags = ESP_AMP_RPMSG_DATA_FRAG | ESP_AMP_RPMSG_DATA_FRAG_FIRST | ESP_AMP_RPMSG_DATA_LANE(ept->lane);
+
+    do {
+        // first fragment carries total length ahead of data
+        uint16_t head_len = (flags & ESP_AMP_RPMSG_DATA_FRAG_FIRST) ? sizeof(uint32_t) : 0;
+        uint16_t chunk_len = left > (uint32_t)(max_size - head_len) ? max_size - head_len : left;
+        if (chunk_len == left) {
+            flags |= ESP_AMP_RPMSG_DATA_FRAG_LAST;
+        }
+
+        // all buffers or credits may be in flight, sleep until receiver gives some back
+        uint8_t* buffer = __esp_amp_rpmsg_create_timeout(rpmsg_dev, ept, dst_addr, head_len + chunk_len, flags, __esp_amp_rpmsg_time_left(start_ms, timeout_ms));
+        if (buffer == NULL) {
+            return -1;
+        }
+
+        if (head_len != 0) {
+            esp_amp_copy(buffer, &data_len, sizeof(uint32_t));
+        }
+        esp_amp_copy(buffer + head_len, pos, chunk_len);
+        if (esp_amp_rpmsg_send_nocopy(rpmsg_dev, ept, dst_addr, buffer, head_len + chunk_len) != 0) {
+            return -1;
+        }
+
+        pos += chunk_len;
+        left -= chunk_len;
+        flags = ESP_AMP_RPMSG_DATA_FRAG | ESP_AMP_RPMSG_DATA_LANE(ept->lane);
+    } while (left > 0);
+
+    return 0;
+}
+
 int esp_amp_rpmsg_send_nocopy(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_t* ept, uint16_t dst_addr, void* data, uint16_t data_len)
 {
     esp_amp_rpmsg_t* rpmsg = (esp_amp_rpmsg_t*)((uint8_t*)(data) - offsetof(esp_amp_rpmsg_t, msg_data));
@@ -333,7 +1186,24 @@ int esp_amp_rpmsg_send_nocopy(esp_amp_rpmsg_dev_t* rpmsg_dev, esp_amp_rpmsg_ept_
 
     esp_amp_env_enter_critical();
 
-    int ret = rpmsg_dev->queue_ops.q_tx(rpmsg_dev->tx_queue, rpmsg, rpmsg_dev->tx_queue->max_item_size);
+    // buffers allocated by esp_amp_rpmsg_send() and its variants already hold a credit
+    if (__esp_amp_rpmsg_credit_enabled(ept, dst_addr) && !(rpmsg->msg_head.data_flags & (ESP_AMP_RPMSG_DATA_CREDIT | ESP_AMP_RPMSG_DATA_CREDIT_REQ))) {
+        if (ept->tx_credits == 0) {
+            // keep the buffer, caller can send it again when credits are returned
+            esp_amp_env_exit_critical();
+            return -1;
+        }
+        ept->tx_credits--;
+        rpmsg->msg_head.data_flags |= ESP_AMP_RPMSG_DATA_CREDIT_REQ;
+    }
+
+    // buffer goes back on the lane it was taken from
+    esp_amp_queue_t* tx_queue = __esp_amp_rpmsg_lane_tx_queue(rpmsg_dev, rpmsg->msg_head.data_flags);
+    if (tx_queue == rpmsg_dev->tx_queue) {
+        // rpmsgs packed earlier go first, other lanes are not ordered against lane 0
+        __esp_amp_rpmsg_flush(rpmsg_dev);
+    }
+    int ret = tx_queue != NULL ? rpmsg_dev->queue_ops.q_tx(tx_queue, rpmsg, tx_queue->max_item_size) : -1;
 
     esp_amp_env_exit_critical();
 
@@ -344,9 +1214,80 @@ int esp_amp_rpmsg_destroy(esp_amp_rpmsg_dev_t* rpmsg_dev, void* msg_data)
 {
     esp_amp_rpmsg_t* rpmsg = (esp_amp_rpmsg_t*)((uint8_t*)(msg_data) - offsetof(esp_amp_rpmsg_t, msg_data));
 
+    if (rpmsg->msg_head.data_flags & ESP_AMP_RPMSG_DATA_PACKED_MEMBER) {
+        return __esp_amp_rpmsg_release_member(rpmsg_dev, rpmsg);
+    }
+
+    // buffer may be reused by sender as soon as it is freed
+    bool credit_req = (rpmsg->msg_head.data_flags & ESP_AMP_RPMSG_DATA_CREDIT_REQ) != 0;
+    uint16_t dst_addr = rpmsg->msg_head.dst_addr;
+    uint16_t src_addr = rpmsg->msg_head.src_addr;
+    esp_amp_queue_t* rx_queue = __esp_amp_rpmsg_lane_rx_queue(rpmsg_dev, rpmsg->msg_head.data_flags);
+    if (rx_queue == NULL) {
+        return -1;
+    }
+
+    esp_amp_env_enter_critical();
+
+    int ret = rpmsg_dev->queue_ops.q_rx_free(rx_queue, rpmsg);
+
+    esp_amp_env_exit_critical();
+
+    if (credit_req && ret == 0) {
+        __esp_amp_rpmsg_return_credit(rpmsg_dev, dst_addr, src_addr);
+    }
+
+    return ret;
+}
+
+int esp_amp_rpmsg_set_credit(esp_amp_rpmsg_ept_t* ept, uint16_t peer_addr, uint16_t window, esp_amp_ept_credit_cb_t credit_cb, void* credit_cb_data)
+{
+    if (ept == NULL) {
+        return -1;
+    }
+
+    esp_amp_env_enter_critical();
+
+    ept->credit_peer_addr = peer_addr;
+    ept->credit_window = window;
+    ept->tx_credits = window;
+    ept->rx_consumed = 0;
+    ept->credit_cb = credit_cb;
+    ept->credit_cb_data = credit_cb_data;
+
+    esp_amp_env_exit_critical();
+
+    return 0;
+}
+
+uint16_t esp_amp_rpmsg_get_credit(esp_amp_rpmsg_ept_t* ept)
+{
+    if (ept->credit_window == 0) {
+        return UINT16_MAX;
+    }
+    return ept->tx_credits;
+}
+
+int esp_amp_rpmsg_set_coalescing(esp_amp_rpmsg_dev_t* rpmsg_dev, uint16_t flush_size, uint32_t flush_timeout_ms)
+{
+    uint16_t max_size = esp_amp_rpmsg_get_max_size(rpmsg_dev);
+
+    esp_amp_env_enter_critical();
+
+    int ret = __esp_amp_rpmsg_flush(rpmsg_dev);
+    rpmsg_dev->tx_pack_flush_size = flush_size > max_size ? max_size : flush_size;
+    rpmsg_dev->tx_pack_timeout_ms = flush_timeout_ms;
+
+    esp_amp_env_exit_critical();
+
+    return ret;
+}
+
+int esp_amp_rpmsg_flush(esp_amp_rpmsg_dev_t* rpmsg_dev)
+{
     esp_amp_env_enter_critical();
 
-    int ret = rpmsg_dev->queue_ops.q_rx_free(rpmsg_dev->rx_queue, rpmsg);
+    int ret = __esp_amp_rpmsg_flush(rpmsg_dev);
 
     esp_amp_env_exit_critical();
 
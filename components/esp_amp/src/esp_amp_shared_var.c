@@ -0,0 +1,155 @@
+/*
+* SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "sdkconfig.h"
+#include "string.h"
+#include "esp_attr.h"
+
+#ifdef __cplusplus
+#include <atomic>
+using std::atomic_uint;
+#else
+#include <stdatomic.h>
+#endif
+
+#include "esp_amp_shared_var.h"
+#include "esp_amp_sys_info.h"
+#include "esp_amp_event.h"
+#include "esp_amp_platform.h"
+
+/* maximum number of attempts to read a consistent value */
+#define SHARED_VAR_READ_RETRY_MAX 32
+/* delay before retrying starts from 1us and doubles up to this, so that a steady writer is not hit every time */
+#define SHARED_VAR_READ_BACKOFF_MAX_US 32
+
+typedef struct {
+    atomic_uint seq;    /* odd while writer is updating data */
+    uint16_t size;      /* size of data in byte */
+    uint16_t reserved;
+    uint32_t data[0];   /* keep data word-aligned */
+} esp_amp_shared_var_shm_t;
+
+#if IS_MAIN_CORE
+int esp_amp_shared_var_main_init(esp_amp_shared_var_t* var, uint16_t size, esp_amp_sys_info_id_t sysinfo_id)
+{
+    /* size of sys info block is 16-bit, header and data must fit into it */
+    if (var == NULL || size == 0 || size > UINT16_MAX - sizeof(esp_amp_shared_var_shm_t)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_amp_shared_var_shm_t* shm = (esp_amp_shared_var_shm_t*)esp_amp_sys_info_alloc(sysinfo_id, sizeof(esp_amp_shared_var_shm_t) + size);
+    if (shm == NULL) {
+        // reserve memory not enough or corresponding sys_info already occupied
+        return ESP_ERR_NO_MEM;
+    }
+
+    atomic_init(&shm->seq, 0);
+    shm->size = size;
+    shm->reserved = 0;
+    memset(shm->data, 0, size);
+
+    var->shm = shm;
+    var->size = size;
+    var->notify_id = 0;
+    var->notify_mask = 0;
+    return ESP_OK;
+}
+#endif
+
+int esp_amp_shared_var_sub_init(esp_amp_shared_var_t* var, esp_amp_sys_info_id_t sysinfo_id)
+{
+    if (var == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_amp_shared_var_shm_t* shm = (esp_amp_shared_var_shm_t*)esp_amp_sys_info_get(sysinfo_id, NULL);
+    if (shm == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    var->shm = shm;
+    var->size = shm->size;
+    var->notify_id = 0;
+    var->notify_mask = 0;
+    return ESP_OK;
+}
+
+void esp_amp_shared_var_set_notify(esp_amp_shared_var_t* var, uint16_t event_id, uint32_t bit_mask)
+{
+    var->notify_id = event_id;
+    var->notify_mask = bit_mask;
+}
+
+int IRAM_ATTR esp_amp_shared_var_write(esp_amp_shared_var_t* var, const void* data, uint16_t size)
+{
+    esp_amp_shared_var_shm_t* shm = (esp_amp_shared_var_shm_t*)var->shm;
+    if (size != var->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    /* single writer: no need for atomic read-modify-write */
+    uint32_t seq = atomic_load_explicit(&shm->seq, memory_order_relaxed);
+    atomic_store_explicit(&shm->seq, seq + 1, memory_order_relaxed);
+    // make sure readers see the odd sequence number before any byte of data changes
+    esp_amp_platform_memory_barrier();
+
+    memcpy(shm->data, data, size);
+
+    // make sure all data is written before publishing the even sequence number
+    esp_amp_platform_memory_barrier();
+    atomic_store_explicit(&shm->seq, seq + 2, memory_order_relaxed);
+
+    if (var->notify_mask != 0) {
+        esp_amp_event_notify_by_id(var->notify_id, var->notify_mask);
+    }
+    return ESP_OK;
+}
+
+int IRAM_ATTR esp_amp_shared_var_read(esp_amp_shared_var_t* var, void* data, uint16_t size, uint32_t* seq)
+{
+    esp_amp_shared_var_shm_t* shm = (esp_amp_shared_var_shm_t*)var->shm;
+    if (size != var->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint32_t backoff_us = 1;
+    for (int retry = 0; retry < SHARED_VAR_READ_RETRY_MAX; retry++) {
+        if (retry != 0) {
+            esp_amp_platform_delay_us(backoff_us);
+            if (backoff_us < SHARED_VAR_READ_BACKOFF_MAX_US) {
+                backoff_us <<= 1;
+            }
+        }
+
+        uint32_t seq_begin = atomic_load_explicit(&shm->seq, memory_order_relaxed);
+        if (seq_begin & 1) {
+            // writer is updating data
+            continue;
+        }
+        esp_amp_platform_memory_barrier();
+
+        memcpy(data, shm->data, size);
+
+        // make sure data is copied before checking the sequence number again
+        esp_amp_platform_memory_barrier();
+        uint32_t seq_end = atomic_load_explicit(&shm->seq, memory_order_relaxed);
+        if (seq_begin == seq_end) {
+            if (seq != NULL) {
+                *seq = seq_end;
+            }
+            return ESP_OK;
+        }
+        // torn read, value changed while copying
+    }
+
+    return ESP_ERR_TIMEOUT;
+}
+
+uint32_t IRAM_ATTR esp_amp_shared_var_get_seq(esp_amp_shared_var_t* var)
+{
+    esp_amp_shared_var_shm_t* shm = (esp_amp_shared_var_shm_t*)var->shm;
+    return atomic_load_explicit(&shm->seq, memory_order_relaxed);
+}
@@ -0,0 +1,324 @@
+/*
+* SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "sdkconfig.h"
+#include "stdbool.h"
+
+#include "esp_amp_shm_heap_priv.h"
+
+#if IS_MAIN_CORE
+
+/*
+ * Each block starts with a header. `prev_phys` is only valid if the previous block
+ * is free. Free list pointers overlap the payload of free blocks. The heap ends with
+ * a zero-sized used sentinel block so that merging never walks out of the region.
+ */
+struct shm_heap_block_t {
+    shm_heap_block_t *prev_phys;
+    uint32_t size;                  /* payload size | flags */
+    shm_heap_block_t *next_free;
+    shm_heap_block_t *prev_free;
+};
+
+#define BLOCK_FREE              0x1
+#define BLOCK_PREV_FREE         0x2
+#define BLOCK_FLAGS             (BLOCK_FREE | BLOCK_PREV_FREE)
+
+#define BLOCK_HEADER_OVERHEAD   offsetof(shm_heap_block_t, next_free)
+#define BLOCK_SIZE_MIN          (sizeof(shm_heap_block_t) - BLOCK_HEADER_OVERHEAD)
+#define BLOCK_SIZE_MAX          ((1u << SHM_HEAP_FL_MAX) - 1)
+#define SMALL_BLOCK_SIZE        (1u << SHM_HEAP_FL_SHIFT)
+
+static inline int fls_u32(uint32_t x)
+{
+    return 31 - __builtin_clz(x);
+}
+
+static inline uint32_t block_size(const shm_heap_block_t *block)
+{
+    return block->size & ~BLOCK_FLAGS;
+}
+
+static inline void block_set_size(shm_heap_block_t *block, uint32_t size)
+{
+    block->size = size | (block->size & BLOCK_FLAGS);
+}
+
+static inline bool block_is_free(const shm_heap_block_t *block)
+{
+    return block->size & BLOCK_FREE;
+}
+
+static inline void *block_to_ptr(shm_heap_block_t *block)
+{
+    return (uint8_t *)block + BLOCK_HEADER_OVERHEAD;
+}
+
+static inline shm_heap_block_t *block_from_ptr(void *ptr)
+{
+    return (shm_heap_block_t *)((uint8_t *)ptr - BLOCK_HEADER_OVERHEAD);
+}
+
+static inline shm_heap_block_t *block_next(shm_heap_block_t *block)
+{
+    return (shm_heap_block_t *)((uint8_t *)block_to_ptr(block) + block_size(block));
+}
+
+/* mark block free and tell next physical block about it */
+static inline void block_mark_free(shm_heap_block_t *block)
+{
+    shm_heap_block_t *next = block_next(block);
+    next->prev_phys = block;
+    next->size |= BLOCK_PREV_FREE;
+    block->size |= BLOCK_FREE;
+}
+
+static inline void block_mark_used(shm_heap_block_t *block)
+{
+    block_next(block)->size &= ~BLOCK_PREV_FREE;
+    block->size &= ~BLOCK_FREE;
+}
+
+static void mapping_insert(uint32_t size, int *fl, int *sl)
+{
+    if (size < SMALL_BLOCK_SIZE) {
+        *fl = 0;
+        *sl = size / (SMALL_BLOCK_SIZE / SHM_HEAP_SL_COUNT);
+    } else {
+        int f = fls_u32(size);
+        *sl = (size >> (f - SHM_HEAP_SL_LOG2)) ^ SHM_HEAP_SL_COUNT;
+        *fl = f - SHM_HEAP_FL_SHIFT + 1;
+    }
+}
+
+/* round size up to the next list so that any block found there is large enough */
+static void mapping_search(uint32_t size, int *fl, int *sl)
+{
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += (1u << (fls_u32(size) - SHM_HEAP_SL_LOG2)) - 1;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+static shm_heap_block_t *search_suitable_block(esp_amp_shm_heap_t *heap, int *fl, int *sl)
+{
+    if (*fl >= SHM_HEAP_FL_COUNT) {
+        return NULL;
+    }
+
+    uint32_t sl_map = heap->sl_bitmap[*fl] & (~0u << *sl);
+    if (sl_map == 0) {
+        uint32_t fl_map = (*fl + 1 < 32) ? heap->fl_bitmap & (~0u << (*fl + 1)) : 0;
+        if (fl_map == 0) {
+            return NULL;
+        }
+        *fl = __builtin_ctz(fl_map);
+        sl_map = heap->sl_bitmap[*fl];
+    }
+    *sl = __builtin_ctz(sl_map);
+    return heap->blocks[*fl][*sl];
+}
+
+static void remove_free_block(esp_amp_shm_heap_t *heap, shm_heap_block_t *block, int fl, int sl)
+{
+    shm_heap_block_t *prev = block->prev_free;
+    shm_heap_block_t *next = block->next_free;
+    if (next != NULL) {
+        next->prev_free = prev;
+    }
+    if (prev != NULL) {
+        prev->next_free = next;
+    }
+
+    if (heap->blocks[fl][sl] == block) {
+        heap->blocks[fl][sl] = next;
+        if (next == NULL) {
+            heap->sl_bitmap[fl] &= ~(1u << sl);
+            if (heap->sl_bitmap[fl] == 0) {
+                heap->fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+}
+
+static void insert_free_block(esp_amp_shm_heap_t *heap, shm_heap_block_t *block, int fl, int sl)
+{
+    shm_heap_block_t *head = heap->blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head != NULL) {
+        head->prev_free = block;
+    }
+    heap->blocks[fl][sl] = block;
+    heap->fl_bitmap |= (1u << fl);
+    heap->sl_bitmap[fl] |= (1u << sl);
+}
+
+static void block_remove(esp_amp_shm_heap_t *heap, shm_heap_block_t *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    remove_free_block(heap, block, fl, sl);
+}
+
+static void block_insert(esp_amp_shm_heap_t *heap, shm_heap_block_t *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    insert_free_block(heap, block, fl, sl);
+}
+
+/* absorb `next` into `block`, both are adjacent */
+static shm_heap_block_t *block_absorb(shm_heap_block_t *block, shm_heap_block_t *next)
+{
+    block_set_size(block, block_size(block) + block_size(next) + BLOCK_HEADER_OVERHEAD);
+    block_next(block)->prev_phys = block;
+    return block;
+}
+
+int esp_amp_shm_heap_init(esp_amp_shm_heap_t *heap, void *start, uint32_t size)
+{
+    uint8_t *aligned_start = (uint8_t *)(((uintptr_t)start + SHM_HEAP_ALIGN - 1) & ~(uintptr_t)(SHM_HEAP_ALIGN - 1));
+    uint32_t lost = aligned_start - (uint8_t *)start;
+    if (size < lost + 2 * BLOCK_HEADER_OVERHEAD + BLOCK_SIZE_MIN) {
+        return -1;
+    }
+    /* one free block spanning the region, followed by the sentinel header */
+    uint32_t block_bytes = (size - lost - 2 * BLOCK_HEADER_OVERHEAD) & ~(SHM_HEAP_ALIGN - 1);
+    if (block_bytes > BLOCK_SIZE_MAX) {
+        return -1;
+    }
+
+    heap->fl_bitmap = 0;
+    for (int i = 0; i < SHM_HEAP_FL_COUNT; i++) {
+        heap->sl_bitmap[i] = 0;
+        for (int j = 0; j < SHM_HEAP_SL_COUNT; j++) {
+            heap->blocks[i][j] = NULL;
+        }
+    }
+    heap->start = aligned_start;
+    heap->size = block_bytes;
+    heap->used = 0;
+    heap->max_used = 0;
+
+    shm_heap_block_t *block = (shm_heap_block_t *)aligned_start;
+    block->prev_phys = NULL;
+    block->size = block_bytes;
+
+    shm_heap_block_t *sentinel = block_next(block);
+    sentinel->prev_phys = block;
+    sentinel->size = 0;
+
+    block_mark_free(block);
+    block_insert(heap, block);
+    return 0;
+}
+
+void *esp_amp_shm_heap_alloc(esp_amp_shm_heap_t *heap, uint32_t size)
+{
+    if (size == 0 || size > BLOCK_SIZE_MAX) {
+        return NULL;
+    }
+
+    uint32_t adjust = (size + SHM_HEAP_ALIGN - 1) & ~(SHM_HEAP_ALIGN - 1);
+    if (adjust < BLOCK_SIZE_MIN) {
+        adjust = BLOCK_SIZE_MIN;
+    }
+
+    int fl, sl;
+    mapping_search(adjust, &fl, &sl);
+    shm_heap_block_t *block = search_suitable_block(heap, &fl, &sl);
+    if (block == NULL) {
+        /* no list guarantees a fit. Blocks sharing the list of requested size may still be
+         * large enough, which matters when the heap is almost exhausted. This walk is the only
+         * part of allocation not bounded in time */
+        mapping_insert(adjust, &fl, &sl);
+        block = heap->blocks[fl][sl];
+        while (block != NULL && block_size(block) < adjust) {
+            block = block->next_free;
+        }
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+    remove_free_block(heap, block, fl, sl);
+
+    /* split off the remainder if it can hold a free block */
+    if (block_size(block) >= adjust + BLOCK_HEADER_OVERHEAD + BLOCK_SIZE_MIN) {
+        shm_heap_block_t *remain = (shm_heap_block_t *)((uint8_t *)block_to_ptr(block) + adjust);
+        remain->size = 0;
+        block_set_size(remain, block_size(block) - adjust - BLOCK_HEADER_OVERHEAD);
+        block_set_size(block, adjust);
+        remain->prev_phys = block;
+        block_mark_free(remain);
+        block_insert(heap, remain);
+    }
+    block_mark_used(block);
+
+    heap->used += block_size(block) + BLOCK_HEADER_OVERHEAD;
+    if (heap->used > heap->max_used) {
+        heap->max_used = heap->used;
+    }
+    return block_to_ptr(block);
+}
+
+void esp_amp_shm_heap_free(esp_amp_shm_heap_t *heap, void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    shm_heap_block_t *block = block_from_ptr(ptr);
+    heap->used -= block_size(block) + BLOCK_HEADER_OVERHEAD;
+
+    block_mark_free(block);
+
+    /* merge with previous block */
+    if (block->size & BLOCK_PREV_FREE) {
+        shm_heap_block_t *prev = block->prev_phys;
+        block_remove(heap, prev);
+        block = block_absorb(prev, block);
+    }
+
+    /* merge with next block */
+    shm_heap_block_t *next = block_next(block);
+    if (block_is_free(next)) {
+        block_remove(heap, next);
+        block = block_absorb(block, next);
+    }
+
+    block_mark_free(block);
+    block_insert(heap, block);
+}
+
+void esp_amp_shm_heap_get_stats(esp_amp_shm_heap_t *heap, uint32_t *total, uint32_t *free, uint32_t *largest_free, uint32_t *max_used)
+{
+    if (total != NULL) {
+        *total = heap->size + BLOCK_HEADER_OVERHEAD;
+    }
+    if (free != NULL) {
+        *free = heap->size + BLOCK_HEADER_OVERHEAD - heap->used;
+    }
+    if (max_used != NULL) {
+        *max_used = heap->max_used;
+    }
+    if (largest_free != NULL) {
+        /* largest block lives in the highest non-empty list */
+        uint32_t largest = 0;
+        if (heap->fl_bitmap != 0) {
+            int fl = fls_u32(heap->fl_bitmap);
+            int sl = fls_u32(heap->sl_bitmap[fl]);
+            for (shm_heap_block_t *block = heap->blocks[fl][sl]; block != NULL; block = block->next_free) {
+                if (block_size(block) > largest) {
+                    largest = block_size(block);
+                }
+            }
+        }
+        *largest_free = largest;
+    }
+}
+
+#endif /* IS_MAIN_CORE */
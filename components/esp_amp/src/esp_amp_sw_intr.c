@@ -19,30 +19,55 @@
 
 static const DRAM_ATTR char TAG[] = "sw_intr";
 
+/* handler entries are allocated from this pool and linked into per-id chains */
 static sw_intr_handler_tbl_t sw_intr_handlers[ESP_AMP_SW_INTR_HANDLER_TABLE_LEN];
+static sw_intr_handler_tbl_t *sw_intr_chains[SW_INTR_ID_MAX + 1];
+static sw_intr_handler_tbl_t *sw_intr_free_list;
+static int sw_intr_handlers_used;
+
+/* EVENT and PANIC are latency-critical, others are dispatched after them */
+static uint32_t sw_intr_prio_mask[SW_INTR_PRIO_LOW + 1] = {
+    [SW_INTR_PRIO_HIGH] = BIT(SW_INTR_RESERVED_ID_EVENT) | BIT(SW_INTR_RESERVED_ID_PANIC),
+    [SW_INTR_PRIO_NORMAL] = (uint32_t)~(BIT(SW_INTR_RESERVED_ID_EVENT) | BIT(SW_INTR_RESERVED_ID_PANIC)),
+    [SW_INTR_PRIO_LOW] = 0,
+};
 static esp_amp_sw_intr_st_t *s_sw_intr_st = (esp_amp_sw_intr_st_t *)ESP_AMP_SW_INTR_BIT_ADDR;
 
+#if CONFIG_ESP_AMP_SW_INTR_COALESCE
+static atomic_uint s_sw_intr_coalesced_cnt;
+#if CONFIG_ESP_AMP_SW_INTR_COALESCE_REFRESH_MS
+static uint32_t s_sw_intr_last_raise_ms;
+#endif
+#endif
+
 int esp_amp_sw_intr_add_handler(esp_amp_sw_intr_id_t intr_id, esp_amp_sw_intr_handler_t handler, void *arg)
 {
     assert(intr_id <= SW_INTR_ID_MAX);
 
     int ret = 0;
-    /* find an available slot */
-    int avail_slot = ESP_AMP_SW_INTR_HANDLER_TABLE_LEN;
+    sw_intr_handler_tbl_t *entry = NULL;
 
     esp_amp_env_enter_critical();
-    for (int i = 0; i < ESP_AMP_SW_INTR_HANDLER_TABLE_LEN; i++) {
-        if (sw_intr_handlers[i].handler == NULL) {
-            avail_slot = i;
-            break;
-        }
+    /* reuse a deleted entry first, then take a never-used one */
+    if (sw_intr_free_list != NULL) {
+        entry = sw_intr_free_list;
+        sw_intr_free_list = entry->next;
+    } else if (sw_intr_handlers_used < ESP_AMP_SW_INTR_HANDLER_TABLE_LEN) {
+        entry = &sw_intr_handlers[sw_intr_handlers_used++];
     }
 
-    /* add handler to this slot */
-    if (avail_slot != ESP_AMP_SW_INTR_HANDLER_TABLE_LEN) {
-        sw_intr_handlers[avail_slot].intr_id = intr_id;
-        sw_intr_handlers[avail_slot].handler = handler;
-        sw_intr_handlers[avail_slot].arg = arg;
+    /* append to the chain so that handlers of the same id run in registration order */
+    if (entry != NULL) {
+        entry->intr_id = intr_id;
+        entry->handler = handler;
+        entry->arg = arg;
+        entry->next = NULL;
+
+        sw_intr_handler_tbl_t **tail = &sw_intr_chains[intr_id];
+        while (*tail != NULL) {
+            tail = &(*tail)->next;
+        }
+        *tail = entry;
     } else {
         ret = -1;
     }
@@ -55,14 +80,50 @@ void esp_amp_sw_intr_delete_handler(esp_amp_sw_intr_id_t intr_id, esp_amp_sw_int
     assert(intr_id <= SW_INTR_ID_MAX);
 
     esp_amp_env_enter_critical();
-    for (int i = 0; i < ESP_AMP_SW_INTR_HANDLER_TABLE_LEN; i++) {
-        if (sw_intr_handlers[i].intr_id == intr_id && sw_intr_handlers[i].handler == handler) {
-            sw_intr_handlers[i].handler = NULL;
+    sw_intr_handler_tbl_t **prev = &sw_intr_chains[intr_id];
+    while (*prev != NULL) {
+        sw_intr_handler_tbl_t *entry = *prev;
+        if (entry->handler == handler) {
+            *prev = entry->next;
+            entry->handler = NULL;
+            entry->next = sw_intr_free_list;
+            sw_intr_free_list = entry;
+        } else {
+            prev = &entry->next;
         }
     }
     esp_amp_env_exit_critical();
 }
 
+int esp_amp_sw_intr_set_priority(esp_amp_sw_intr_id_t intr_id, esp_amp_sw_intr_prio_t prio)
+{
+    if ((int)intr_id > (int)SW_INTR_ID_MAX || (int)prio < (int)SW_INTR_PRIO_HIGH || (int)prio > (int)SW_INTR_PRIO_LOW) {
+        return -1;
+    }
+
+    esp_amp_env_enter_critical();
+    for (int i = SW_INTR_PRIO_HIGH; i <= SW_INTR_PRIO_LOW; i++) {
+        sw_intr_prio_mask[i] &= ~BIT(intr_id);
+    }
+    sw_intr_prio_mask[prio] |= BIT(intr_id);
+    esp_amp_env_exit_critical();
+    return 0;
+}
+
+int esp_amp_sw_intr_get_priority(esp_amp_sw_intr_id_t intr_id)
+{
+    if ((int)intr_id > (int)SW_INTR_ID_MAX) {
+        return -1;
+    }
+
+    for (int i = SW_INTR_PRIO_HIGH; i < SW_INTR_PRIO_LOW; i++) {
+        if (sw_intr_prio_mask[i] & BIT(intr_id)) {
+            return i;
+        }
+    }
+    return SW_INTR_PRIO_LOW;
+}
+
 void esp_amp_sw_intr_trigger(esp_amp_sw_intr_id_t intr_id)
 {
     assert((int)intr_id <= (int)SW_INTR_ID_MAX);
@@ -71,20 +132,49 @@ void esp_amp_sw_intr_trigger(esp_amp_sw_intr_id_t intr_id)
     assert(s_sw_intr_st != NULL);
 
 #if IS_MAIN_CORE
-    atomic_fetch_or(&(s_sw_intr_st->sub_core_sw_intr_st), BIT(intr_id));
+    uint32_t prev = esp_amp_shm_bits_set(&(s_sw_intr_st->sub_core_sw_intr_st), BIT(intr_id));
 #else
-    atomic_fetch_or(&(s_sw_intr_st->main_core_sw_intr_st), BIT(intr_id));
+    uint32_t prev = esp_amp_shm_bits_set(&(s_sw_intr_st->main_core_sw_intr_st), BIT(intr_id));
+#endif
+
+#if CONFIG_ESP_AMP_SW_INTR_COALESCE
+    /* peer has not cleared its pending bits yet, the interrupt raised earlier will pick up this one */
+    if (prev != 0) {
+#if CONFIG_ESP_AMP_SW_INTR_COALESCE_REFRESH_MS
+        if (esp_amp_platform_get_time_ms() - s_sw_intr_last_raise_ms < CONFIG_ESP_AMP_SW_INTR_COALESCE_REFRESH_MS) {
+            atomic_fetch_add(&s_sw_intr_coalesced_cnt, 1);
+            return;
+        }
+#else
+        atomic_fetch_add(&s_sw_intr_coalesced_cnt, 1);
+        return;
+#endif
+    }
+#if CONFIG_ESP_AMP_SW_INTR_COALESCE_REFRESH_MS
+    s_sw_intr_last_raise_ms = esp_amp_platform_get_time_ms();
+#endif
+#else
+    (void)prev;
 #endif
     esp_amp_platform_sw_intr_trigger();
 }
 
+uint32_t esp_amp_sw_intr_get_coalesced_count(void)
+{
+#if CONFIG_ESP_AMP_SW_INTR_COALESCE
+    return atomic_load(&s_sw_intr_coalesced_cnt);
+#else
+    return 0;
+#endif
+}
+
 void esp_amp_sw_intr_handler_dump(void)
 {
     ESP_AMP_LOGI("", "=== SW INTR TABLE[%d] ===", ESP_AMP_SW_INTR_HANDLER_TABLE_LEN);
-    ESP_AMP_LOGI("", "ID\t\tHANDLER");
-    for (int i = 0; i < ESP_AMP_SW_INTR_HANDLER_TABLE_LEN; i++) {
-        if (sw_intr_handlers[i].handler) {
-            ESP_AMP_LOGI("", "%d\t\t%p", sw_intr_handlers[i].intr_id, sw_intr_handlers[i].handler);
+    ESP_AMP_LOGI("", "ID\t\tPRIO\t\tHANDLER");
+    for (int i = 0; i <= SW_INTR_ID_MAX; i++) {
+        for (sw_intr_handler_tbl_t *entry = sw_intr_chains[i]; entry != NULL; entry = entry->next) {
+            ESP_AMP_LOGI("", "%d\t\t%d\t\t%p", entry->intr_id, esp_amp_sw_intr_get_priority(entry->intr_id), entry->handler);
         }
     }
     ESP_AMP_LOGI("", "END\n");
@@ -97,8 +187,12 @@ int esp_amp_sw_intr_init(void)
     }
 
 #if IS_MAIN_CORE
-    atomic_init(&s_sw_intr_st->main_core_sw_intr_st, 0);
-    atomic_init(&s_sw_intr_st->sub_core_sw_intr_st, 0);
+    esp_amp_shm_bits_init(&s_sw_intr_st->main_core_sw_intr_st);
+    esp_amp_shm_bits_init(&s_sw_intr_st->sub_core_sw_intr_st);
+#else
+    /* triggers issued before subcore is up have no handler to serve them. Drop them so that
+     * pending bitmap is empty and the next trigger from maincore raises the interrupt again */
+    esp_amp_shm_bits_take(&s_sw_intr_st->sub_core_sw_intr_st, UINT32_MAX);
 #endif
 
     int ret = esp_amp_platform_sw_intr_install();
@@ -111,46 +205,64 @@ int esp_amp_sw_intr_init(void)
     return ret;
 }
 
+static inline int sw_intr_run_handlers(int intr_id)
+{
+    int need_yield = 0;
+    sw_intr_handler_tbl_t *next;
+    for (sw_intr_handler_tbl_t *entry = sw_intr_chains[intr_id]; entry != NULL; entry = next) {
+        /* handler may delete itself, which moves its entry to free list */
+        next = entry->next;
+        esp_amp_sw_intr_handler_t handler = entry->handler;
+        if (handler == NULL || entry->intr_id != intr_id) {
+            continue;
+        }
+        ESP_AMP_DRAM_LOGD(TAG, "executing handler(%p)", handler);
+        need_yield |= handler(entry->arg);
+    }
+    return need_yield;
+}
+
 void esp_amp_sw_intr_handler(void)
 {
-#if !IS_ENV_BM
-    bool need_yield = false;
-#endif
-    int unprocessed = 0;
+    int need_yield = 0;
 
 #if IS_MAIN_CORE
+    esp_amp_shm_bits_t *local_st = &s_sw_intr_st->main_core_sw_intr_st;
     ESP_AMP_DRAM_LOGD(TAG, "Received software interrupt from subcore\n");
-    while (!atomic_compare_exchange_weak(&s_sw_intr_st->main_core_sw_intr_st, &unprocessed, 0));
 #else
+    esp_amp_shm_bits_t *local_st = &s_sw_intr_st->sub_core_sw_intr_st;
     ESP_AMP_DRAM_LOGD(TAG, "Received software interrupt from maincore\n");
-    while (!atomic_compare_exchange_weak(&s_sw_intr_st->sub_core_sw_intr_st, &unprocessed, 0));
 #endif
+    uint32_t unprocessed = esp_amp_shm_bits_take(local_st, UINT32_MAX);
     ESP_AMP_DRAM_LOGD(TAG, "sw_intr_st at %p, unprocessed=0x%x\n", s_sw_intr_st, (unsigned)unprocessed);
 
     while (unprocessed) {
-        for (int i = 0; i < ESP_AMP_SW_INTR_HANDLER_TABLE_LEN; i++) {
-            /* intr_id matches unprocessed bit */
-            if (unprocessed & BIT(sw_intr_handlers[i].intr_id)) {
-                if (sw_intr_handlers[i].handler) {
-                    ESP_AMP_DRAM_LOGD(TAG, "executing handler(%p)", sw_intr_handlers[i].handler);
-#if !IS_ENV_BM
-                    need_yield |= sw_intr_handlers[i].handler(sw_intr_handlers[i].arg);
-#else
-                    sw_intr_handlers[i].handler(sw_intr_handlers[i].arg);
-#endif
+        /* dispatch by priority class, lowest id first within a class */
+        for (int prio = SW_INTR_PRIO_HIGH; prio <= SW_INTR_PRIO_LOW; prio++) {
+            uint32_t pending = unprocessed & sw_intr_prio_mask[prio];
+            while (pending) {
+                int intr_id = __builtin_ctz(pending);
+                pending &= pending - 1;
+                need_yield |= sw_intr_run_handlers(intr_id);
+
+                /* high priority ids arriving meanwhile go ahead of remaining lower priority ones */
+                if (prio != SW_INTR_PRIO_HIGH && (esp_amp_shm_bits_get(local_st) & sw_intr_prio_mask[SW_INTR_PRIO_HIGH])) {
+                    uint32_t high = esp_amp_shm_bits_take(local_st, sw_intr_prio_mask[SW_INTR_PRIO_HIGH]) & sw_intr_prio_mask[SW_INTR_PRIO_HIGH];
+                    while (high) {
+                        int high_id = __builtin_ctz(high);
+                        high &= high - 1;
+                        need_yield |= sw_intr_run_handlers(high_id);
+                    }
                 }
             }
         }
         /* clear all interrupt bit */
-        unprocessed = 0;
-#if IS_MAIN_CORE
-        while (!atomic_compare_exchange_weak(&s_sw_intr_st->main_core_sw_intr_st, &unprocessed, 0));
-#else
-        while (!atomic_compare_exchange_weak(&s_sw_intr_st->sub_core_sw_intr_st, &unprocessed, 0));
-#endif
+        unprocessed = esp_amp_shm_bits_take(local_st, UINT32_MAX);
     }
 
 #if !IS_ENV_BM
     portYIELD_FROM_ISR(need_yield);
+#else
+    (void)need_yield; /* return value of handlers is ignored in baremetal */
 #endif
 }
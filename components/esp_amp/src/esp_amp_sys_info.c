@@ -14,97 +14,345 @@
 #include "esp_amp_sys_info.h"
 #include "esp_amp_log.h"
 #include "esp_amp_mem_priv.h"
+#include "esp_amp_platform.h"
+#include "esp_amp_shm_heap_priv.h"
+#include "esp_amp_sys_info_priv.h"
 
 #define TAG "sys_info"
 
 #define ESP_AMP_SYS_INFO_ID_MAX 0xffff
 
-#if IS_MAIN_CORE
-SOC_RESERVE_MEMORY_REGION(ESP_AMP_SHARED_MEM_START, ESP_AMP_SHARED_MEM_END, esp_amp_shared_mem);
+/* directory is an open-addressing hash table with linear probing */
+#define ESP_AMP_SYS_INFO_DIR_LEN CONFIG_ESP_AMP_SYS_INFO_DIR_LEN
+#define ESP_AMP_SYS_INFO_DIR_EMPTY ESP_AMP_SYS_INFO_ID_MAX
+#define ESP_AMP_SYS_INFO_DIR_DELETED (ESP_AMP_SYS_INFO_ID_MAX - 1)
+
+/* default control region, optional bulk region and user-registered regions */
+#define ESP_AMP_SYS_INFO_REGION_MAX 4
+
+_Static_assert((ESP_AMP_SYS_INFO_DIR_LEN & (ESP_AMP_SYS_INFO_DIR_LEN - 1)) == 0, "CONFIG_ESP_AMP_SYS_INFO_DIR_LEN must be power of 2");
+
+#if IS_MAIN_CORE && (CONFIG_ESP_AMP_SHARED_MEM_IN_HP || ESP_AMP_SHARED_MEM_BULK_SIZE)
+/* control region in LP RAM is part of LP core reserved memory and needs no reservation */
+SOC_RESERVE_MEMORY_REGION(ESP_AMP_SHARED_MEM_BULK_START, ESP_AMP_HP_MEM_END, esp_amp_shared_mem);
 #endif
 
-typedef struct sys_info_header_t {
+typedef struct {
     uint16_t info_id;
-    uint16_t size;                  /* original size in byte */
-    struct sys_info_header_t* next; /* offset related to buffer */
-} sys_info_header_t;
+    uint8_t region;                 /* index of region the data is allocated from */
+    uint8_t pad;                    /* words between start of heap block and addr, for cache line alignment */
+    uint32_t size;                  /* original size in byte */
+    void *addr;                     /* start address of sys info data */
+    void *buf_block;                /* heap block of secondary buffer freed with the entry, NULL if none */
+} sys_info_dir_entry_t;
+
+typedef struct {
+    uint16_t used;                  /* number of occupied directory entries */
+    uint16_t region_num;            /* number of registered regions */
+    uint32_t region_caps[ESP_AMP_SYS_INFO_REGION_MAX];
+    sys_info_dir_entry_t entry[ESP_AMP_SYS_INFO_DIR_LEN];
+} sys_info_dir_t;
+
+_Static_assert(ESP_AMP_RESERVED_SHARED_MEM_SIZE + ESP_AMP_SHARED_MEM_STATIC_SIZE + sizeof(sys_info_dir_t) < CONFIG_ESP_AMP_SHARED_MEM_SIZE,
+               "CONFIG_ESP_AMP_SHARED_MEM_STATIC_SIZE leaves no room for sys info in shared memory");
+
+static sys_info_dir_t* const s_esp_amp_sys_info = (sys_info_dir_t *)ESP_AMP_SHARED_MEM_POOL_START;
 
-static sys_info_header_t* const s_esp_amp_sys_info = (sys_info_header_t *)ESP_AMP_SHARED_MEM_POOL_START;
+uint8_t* const esp_amp_sys_info_static_mem = (uint8_t *)ESP_AMP_SHARED_MEM_STATIC_START;
 
 #if IS_MAIN_CORE
-static uint16_t get_size_word(uint16_t size)
+/* memory blocks of each region are managed by maincore only */
+static esp_amp_shm_heap_t s_esp_amp_sys_info_heap[ESP_AMP_SYS_INFO_REGION_MAX];
+#endif
+
+static inline uint32_t sys_info_hash(uint16_t info_id)
+{
+    /* Fibonacci hashing spreads both small user ids and 0xffxx reserved ids */
+    return ((uint32_t)info_id * 0x9e3779b1u) >> 16;
+}
+
+static sys_info_dir_entry_t * IRAM_ATTR sys_info_find(uint16_t info_id)
 {
-    uint16_t size_in_word = size >> 2;
-    if (size & 0x3) {
-        size_in_word += 1;
+    /* sentinels would match empty or deleted slots */
+    if (info_id == ESP_AMP_SYS_INFO_DIR_EMPTY || info_id == ESP_AMP_SYS_INFO_DIR_DELETED) {
+        return NULL;
     }
-    return size_in_word;
+
+    uint32_t idx = sys_info_hash(info_id);
+    for (int i = 0; i < ESP_AMP_SYS_INFO_DIR_LEN; i++, idx++) {
+        sys_info_dir_entry_t *entry = &s_esp_amp_sys_info->entry[idx & (ESP_AMP_SYS_INFO_DIR_LEN - 1)];
+        uint16_t entry_id = entry->info_id;
+        if (entry_id == info_id) {
+            /* info_id is published after size and addr */
+            esp_amp_platform_memory_barrier();
+            return entry;
+        }
+        if (entry_id == ESP_AMP_SYS_INFO_DIR_EMPTY) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+void * IRAM_ATTR esp_amp_sys_info_get_with_caps(uint16_t info_id, uint32_t *size, uint32_t *caps)
+{
+    sys_info_dir_entry_t *entry = sys_info_find(info_id);
+    if (entry == NULL) {
+        ESP_AMP_LOGE(TAG, "INFO_ID(0x%x) not found", info_id);
+        return NULL;
+    }
+
+    if (size != NULL) {
+        *size = entry->size;
+    }
+    if (caps != NULL) {
+        *caps = s_esp_amp_sys_info->region_caps[entry->region];
+    }
+    return entry->addr;
 }
-#endif /* IS_MAIN_CORE */
 
 void * IRAM_ATTR esp_amp_sys_info_get(uint16_t info_id, uint16_t *size)
 {
-    sys_info_header_t *sys_info_entry = s_esp_amp_sys_info->next;
-    while (sys_info_entry != NULL) {
-        if (sys_info_entry->info_id == info_id) {
-            if (size != NULL) {
-                *size = sys_info_entry->size;
-            }
+    uint32_t size_u32 = 0;
+    void *buffer = esp_amp_sys_info_get_with_caps(info_id, &size_u32, NULL);
+    if (buffer != NULL && size != NULL) {
+        *size = size_u32 > UINT16_MAX ? UINT16_MAX : size_u32;
+    }
+    return buffer;
+}
 
-            void* buffer = (void*)((uint8_t*)(sys_info_entry) + sizeof(sys_info_header_t));
+#if IS_MAIN_CORE
+static int sys_info_region_add(void *start, uint32_t size, uint32_t caps)
+{
+    int region = s_esp_amp_sys_info->region_num;
+    if (region >= ESP_AMP_SYS_INFO_REGION_MAX) {
+        ESP_AMP_LOGE(TAG, "No free region slot");
+        return -1;
+    }
+    if (esp_amp_shm_heap_init(&s_esp_amp_sys_info_heap[region], start, size) != 0) {
+        ESP_AMP_LOGE(TAG, "Invalid region (%p, 0x%x)", start, (unsigned)size);
+        return -1;
+    }
+    s_esp_amp_sys_info->region_caps[region] = caps;
+    s_esp_amp_sys_info->region_num++;
+    ESP_AMP_LOGI(TAG, "Shared memory region %d: addr=%p, len=0x%x, caps=0x%x", region, start, (unsigned)size, (unsigned)caps);
+    return 0;
+}
 
-            ESP_AMP_LOGD(TAG, "get info:%x, size:0x%x, addr:%p", sys_info_entry->info_id, sys_info_entry->size, buffer);
+int esp_amp_sys_info_add_region(void *start, uint32_t size, uint32_t caps)
+{
+    if (start == NULL || size == 0) {
+        return -1;
+    }
 
-            return buffer;
+    /* reject overlap with registered regions */
+    for (int i = 0; i < s_esp_amp_sys_info->region_num; i++) {
+        esp_amp_shm_heap_t *heap = &s_esp_amp_sys_info_heap[i];
+        if ((uint8_t *)start < heap->start + heap->size && (uint8_t *)start + size > heap->start) {
+            ESP_AMP_LOGE(TAG, "Region (%p, 0x%x) overlaps region %d", start, (unsigned)size, i);
+            return -1;
         }
-
-        sys_info_entry = sys_info_entry->next;
     }
+    return sys_info_region_add(start, size, caps);
+}
+
+/* first region providing all requested caps and enough space wins. Blocks in cached regions are
+ * padded to whole cache lines, so that cache maintenance on one block never touches another */
+static void *sys_info_region_alloc(uint32_t size, uint32_t caps, int *region_out, uint8_t *pad_out)
+{
+    for (int region = 0; region < s_esp_amp_sys_info->region_num; region++) {
+        uint32_t region_caps = s_esp_amp_sys_info->region_caps[region];
+        if ((region_caps & caps) != caps) {
+            continue;
+        }
 
-    ESP_AMP_LOGE(TAG, "INFO_ID(0x%x) not found", info_id);
+        uint32_t pad = 0;
+        uint8_t *block;
+        if (region_caps & ESP_AMP_SYS_INFO_CAP_CACHED) {
+            const uint32_t line = ESP_AMP_PLATFORM_CACHE_LINE_SIZE;
+            block = esp_amp_shm_heap_alloc(&s_esp_amp_sys_info_heap[region], ((size + line - 1) & ~(line - 1)) + line - sizeof(uint32_t));
+            if (block != NULL) {
+                pad = (line - ((uintptr_t)block & (line - 1))) & (line - 1);
+            }
+        } else {
+            block = esp_amp_shm_heap_alloc(&s_esp_amp_sys_info_heap[region], size);
+        }
+
+        if (block != NULL) {
+            *region_out = region;
+            *pad_out = pad / sizeof(uint32_t);
+            return block + pad;
+        }
+    }
     return NULL;
 }
 
-#if IS_MAIN_CORE
-void* esp_amp_sys_info_alloc(uint16_t info_id, uint16_t size)
+void *esp_amp_sys_info_alloc_buffer(uint16_t info_id, uint32_t size, uint32_t caps, uint32_t *region_caps)
 {
-    sys_info_header_t *sys_info_entry = s_esp_amp_sys_info;
+    sys_info_dir_entry_t *entry = sys_info_find(info_id);
+    if (entry == NULL || entry->buf_block != NULL) {
+        ESP_AMP_LOGE(TAG, "INFO_ID(0x%x) not found or already has a buffer", info_id);
+        return NULL;
+    }
+
+    int region;
+    uint8_t pad;
+    uint8_t *buffer = sys_info_region_alloc(size, caps, &region, &pad);
+    if (buffer == NULL) {
+        ESP_AMP_LOGE(TAG, "No space in buffer with caps 0x%x", (unsigned)caps);
+        return NULL;
+    }
+    entry->buf_block = buffer - pad * sizeof(uint32_t);
+    if (region_caps != NULL) {
+        *region_caps = s_esp_amp_sys_info->region_caps[region];
+    }
+    return buffer;
+}
+
+void* esp_amp_sys_info_alloc_with_caps(uint16_t info_id, uint32_t size, uint32_t caps)
+{
+    if (info_id == ESP_AMP_SYS_INFO_DIR_EMPTY || info_id == ESP_AMP_SYS_INFO_DIR_DELETED) {
+        ESP_AMP_LOGE(TAG, "Info id(%x) is invalid", info_id);
+        return NULL;
+    }
 
-    while (sys_info_entry->next != NULL) {
-        if (sys_info_entry->next->info_id == info_id) {
+    /* find the slot, rejecting duplicate id on the way. Deleted slots can be reused */
+    sys_info_dir_entry_t *entry = NULL;
+    uint32_t idx = sys_info_hash(info_id);
+    for (int i = 0; i < ESP_AMP_SYS_INFO_DIR_LEN; i++, idx++) {
+        sys_info_dir_entry_t *probe = &s_esp_amp_sys_info->entry[idx & (ESP_AMP_SYS_INFO_DIR_LEN - 1)];
+        if (probe->info_id == info_id) {
             ESP_AMP_LOGE(TAG, "Info id(%x) already exist", info_id);
             return NULL;
         }
-        sys_info_entry = sys_info_entry->next;
+        if (probe->info_id == ESP_AMP_SYS_INFO_DIR_DELETED && entry == NULL) {
+            entry = probe;
+        }
+        if (probe->info_id == ESP_AMP_SYS_INFO_DIR_EMPTY) {
+            if (entry == NULL) {
+                entry = probe;
+            }
+            break;
+        }
     }
 
-    void* next_sys_info_entry_start = (uint8_t*)(sys_info_entry) + sizeof(sys_info_header_t) + 4 * get_size_word(sys_info_entry->size);
-    void* next_sys_info_entry_end = (uint8_t*)(next_sys_info_entry_start) + sizeof(sys_info_header_t) + 4 * get_size_word(size);
-    void* buffer = (void*)((uint8_t*)(next_sys_info_entry_start) + sizeof(sys_info_header_t));
+    if (entry == NULL) {
+        ESP_AMP_LOGE(TAG, "No free entry in sys info directory");
+        return NULL;
+    }
 
-    if (next_sys_info_entry_end > (void *)ESP_AMP_SHARED_MEM_END) {
-        ESP_AMP_LOGE(TAG, "No space in buffer");
+    int region;
+    uint8_t pad;
+    void *buffer = sys_info_region_alloc(size, caps, &region, &pad);
+    if (buffer == NULL) {
+        ESP_AMP_LOGE(TAG, "No space in buffer with caps 0x%x", (unsigned)caps);
         return NULL;
     }
 
-    ESP_AMP_LOGD(TAG, "alloc info:%x, size:0x%x, addr:%p", info_id, size, buffer);
+    ESP_AMP_LOGD(TAG, "alloc info:%x, size:0x%x, addr:%p, region:%d", info_id, (unsigned)size, buffer, region);
 
-    sys_info_entry->next = next_sys_info_entry_start;
-    sys_info_entry->next->next = NULL;
-    sys_info_entry->next->info_id = info_id;
-    sys_info_entry->next->size = size;
+    s_esp_amp_sys_info->used++;
+    entry->region = region;
+    entry->pad = pad;
+    entry->size = size;
+    entry->addr = buffer;
+    entry->buf_block = NULL;
+    /* make the entry visible only after it is complete */
+    esp_amp_platform_memory_barrier();
+    entry->info_id = info_id;
 
     return buffer;
 }
 
+void* esp_amp_sys_info_alloc(uint16_t info_id, uint16_t size)
+{
+    return esp_amp_sys_info_alloc_with_caps(info_id, size, ESP_AMP_SYS_INFO_CAP_CONTROL);
+}
+
+int esp_amp_sys_info_free(uint16_t info_id)
+{
+    sys_info_dir_entry_t *entry = sys_info_find(info_id);
+    if (entry == NULL) {
+        ESP_AMP_LOGE(TAG, "INFO_ID(0x%x) not found", info_id);
+        return -1;
+    }
+
+    ESP_AMP_LOGD(TAG, "free info:%x, size:0x%x, addr:%p", info_id, (unsigned)entry->size, entry->addr);
+
+    /* keep the slot as tombstone so that lookup of other ids can probe past it */
+    entry->info_id = ESP_AMP_SYS_INFO_DIR_DELETED;
+    esp_amp_platform_memory_barrier();
+    esp_amp_shm_heap_free(&s_esp_amp_sys_info_heap[entry->region], (uint32_t *)entry->addr - entry->pad);
+    if (entry->buf_block != NULL) {
+        for (int region = 0; region < s_esp_amp_sys_info->region_num; region++) {
+            if (esp_amp_shm_heap_contains(&s_esp_amp_sys_info_heap[region], entry->buf_block)) {
+                esp_amp_shm_heap_free(&s_esp_amp_sys_info_heap[region], entry->buf_block);
+                break;
+            }
+        }
+        entry->buf_block = NULL;
+    }
+    entry->addr = NULL;
+    entry->pad = 0;
+    entry->size = 0;
+    s_esp_amp_sys_info->used--;
+    return 0;
+}
+
+void esp_amp_sys_info_get_mem_info_with_caps(uint32_t caps, esp_amp_sys_info_mem_info_t *info)
+{
+    info->total = 0;
+    info->free = 0;
+    info->largest_free_block = 0;
+    info->max_used = 0;
+
+    for (int region = 0; region < s_esp_amp_sys_info->region_num; region++) {
+        if ((s_esp_amp_sys_info->region_caps[region] & caps) != caps) {
+            continue;
+        }
+        uint32_t total, free, largest, max_used;
+        esp_amp_shm_heap_get_stats(&s_esp_amp_sys_info_heap[region], &total, &free, &largest, &max_used);
+        info->total += total;
+        info->free += free;
+        info->max_used += max_used;
+        if (largest > info->largest_free_block) {
+            info->largest_free_block = largest;
+        }
+    }
+}
+
+void esp_amp_sys_info_get_mem_info(esp_amp_sys_info_mem_info_t *info)
+{
+    esp_amp_sys_info_get_mem_info_with_caps(ESP_AMP_SYS_INFO_CAP_CONTROL, info);
+}
+
 #endif /* IS_MAIN_CORE */
 
 int esp_amp_sys_info_init(void)
 {
 #if IS_MAIN_CORE
-    s_esp_amp_sys_info->info_id = ESP_AMP_SYS_INFO_ID_MAX;
-    s_esp_amp_sys_info->size = 0;
-    s_esp_amp_sys_info->next = NULL;
+    for (int i = 0; i < ESP_AMP_SYS_INFO_DIR_LEN; i++) {
+        s_esp_amp_sys_info->entry[i].info_id = ESP_AMP_SYS_INFO_DIR_EMPTY;
+        s_esp_amp_sys_info->entry[i].region = 0;
+        s_esp_amp_sys_info->entry[i].pad = 0;
+        s_esp_amp_sys_info->entry[i].size = 0;
+        s_esp_amp_sys_info->entry[i].addr = NULL;
+        s_esp_amp_sys_info->entry[i].buf_block = NULL;
+    }
+    s_esp_amp_sys_info->used = 0;
+    s_esp_amp_sys_info->region_num = 0;
+
+    /* control region: remainder of shared memory pool after the directory */
+    uint8_t *heap_start = (uint8_t *)s_esp_amp_sys_info + sizeof(sys_info_dir_t);
+    if (sys_info_region_add(heap_start, (uint8_t *)ESP_AMP_SHARED_MEM_END - heap_start, ESP_AMP_SHARED_MEM_CAPS) != 0) {
+        return -1;
+    }
+
+#if ESP_AMP_SHARED_MEM_BULK_SIZE
+    if (sys_info_region_add((void *)ESP_AMP_SHARED_MEM_BULK_START, ESP_AMP_SHARED_MEM_BULK_SIZE, ESP_AMP_SYS_INFO_CAP_BULK | ESP_AMP_SYS_INFO_CAP_ATOMIC) != 0) {
+        return -1;
+    }
+#endif
 #endif /* IS_MAIN_CORE */
     ESP_AMP_LOGI(TAG, "ESP-AMP shared memory: addr=%p, len=%p", s_esp_amp_sys_info, (void *)ESP_AMP_SHARED_MEM_POOL_SIZE);
     return 0;
@@ -112,12 +360,13 @@ int esp_amp_sys_info_init(void)
 
 void esp_amp_sys_info_dump(void)
 {
-    ESP_AMP_LOGI("", "====== SYS INFO(%p) ======", s_esp_amp_sys_info);
-    ESP_AMP_LOGI("", "ID\t\tSIZE\tADDR");
-    sys_info_header_t *sys_info_entry = s_esp_amp_sys_info->next;
-    while (sys_info_entry != NULL) {
-        ESP_AMP_LOGI("", "0x%08x\t0x%u\t%p", sys_info_entry->info_id, sys_info_entry->size, (void*)((uint8_t*)(s_esp_amp_sys_info) + sizeof(sys_info_header_t)));
-        sys_info_entry = sys_info_entry->next;
+    ESP_AMP_LOGI("", "====== SYS INFO(%p) %d/%d ======", s_esp_amp_sys_info, s_esp_amp_sys_info->used, ESP_AMP_SYS_INFO_DIR_LEN);
+    ESP_AMP_LOGI("", "ID\t\tSIZE\tREGION\tADDR");
+    for (int i = 0; i < ESP_AMP_SYS_INFO_DIR_LEN; i++) {
+        sys_info_dir_entry_t *entry = &s_esp_amp_sys_info->entry[i];
+        if (entry->info_id != ESP_AMP_SYS_INFO_DIR_EMPTY && entry->info_id != ESP_AMP_SYS_INFO_DIR_DELETED) {
+            ESP_AMP_LOGI("", "0x%08x\t0x%x\t%d\t%p", entry->info_id, (unsigned)entry->size, entry->region, entry->addr);
+        }
     }
     ESP_AMP_LOGI("", "END\n");
 }
@@ -0,0 +1,141 @@
+/*
+* SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "sdkconfig.h"
+#include "string.h"
+#include "esp_attr.h"
+
+#ifdef __cplusplus
+#include <atomic>
+using std::atomic_uint;
+#else
+#include <stdatomic.h>
+#endif
+
+#include "esp_amp_triple_buf.h"
+#include "esp_amp_sys_info.h"
+#include "esp_amp_platform.h"
+
+/* state word layout: bit[1:0] index of middle slot, bit[2] middle slot holds data not yet acquired */
+#define TRIPLE_BUF_IDX_MASK     0x3
+#define TRIPLE_BUF_FRESH        0x4
+
+/* initial slot assignment */
+#define TRIPLE_BUF_INIT_BACK    0
+#define TRIPLE_BUF_INIT_MIDDLE  1
+#define TRIPLE_BUF_INIT_FRONT   2
+
+#define TRIPLE_BUF_SLOT_ALIGN   4
+
+typedef struct {
+    atomic_uint state;
+    uint16_t slot_size;
+    uint16_t reserved;
+    uint32_t slots[0];  /* keep slots word-aligned */
+} esp_amp_triple_buf_shm_t;
+
+static void triple_buf_bind(esp_amp_triple_buf_t* tb, esp_amp_triple_buf_shm_t* shm, bool is_producer)
+{
+    tb->shm = shm;
+    tb->slots = (uint8_t*)shm->slots;
+    tb->slot_size = shm->slot_size;
+    tb->producer = is_producer;
+    tb->local_idx = is_producer ? TRIPLE_BUF_INIT_BACK : TRIPLE_BUF_INIT_FRONT;
+}
+
+#if IS_MAIN_CORE
+int esp_amp_triple_buf_main_init(esp_amp_triple_buf_t* tb, uint16_t slot_size, bool is_producer, esp_amp_sys_info_id_t sysinfo_id)
+{
+    if (tb == NULL || slot_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t aligned_size = (slot_size + TRIPLE_BUF_SLOT_ALIGN - 1) & ~(TRIPLE_BUF_SLOT_ALIGN - 1);
+    if (aligned_size > UINT16_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_amp_triple_buf_shm_t* shm = (esp_amp_triple_buf_shm_t*)esp_amp_sys_info_alloc_with_caps(sysinfo_id, sizeof(esp_amp_triple_buf_shm_t) + 3 * aligned_size, ESP_AMP_SYS_INFO_CAP_ATOMIC);
+    if (shm == NULL) {
+        // reserve memory not enough or corresponding sys_info already occupied
+        return ESP_ERR_NO_MEM;
+    }
+
+    shm->slot_size = (uint16_t)aligned_size;
+    shm->reserved = 0;
+    memset(shm->slots, 0, 3 * aligned_size);
+    esp_amp_platform_memory_barrier();
+    atomic_init(&shm->state, TRIPLE_BUF_INIT_MIDDLE);
+
+    triple_buf_bind(tb, shm, is_producer);
+    return ESP_OK;
+}
+#endif
+
+int esp_amp_triple_buf_sub_init(esp_amp_triple_buf_t* tb, bool is_producer, esp_amp_sys_info_id_t sysinfo_id)
+{
+    if (tb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_amp_triple_buf_shm_t* shm = (esp_amp_triple_buf_shm_t*)esp_amp_sys_info_get(sysinfo_id, NULL);
+    if (shm == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    triple_buf_bind(tb, shm, is_producer);
+    return ESP_OK;
+}
+
+void* IRAM_ATTR esp_amp_triple_buf_get_write_buf(esp_amp_triple_buf_t* tb)
+{
+    if (!tb->producer) {
+        return NULL;
+    }
+    return tb->slots + tb->local_idx * tb->slot_size;
+}
+
+int IRAM_ATTR esp_amp_triple_buf_publish(esp_amp_triple_buf_t* tb)
+{
+    esp_amp_triple_buf_shm_t* shm = (esp_amp_triple_buf_shm_t*)tb->shm;
+    if (!tb->producer) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // make sure data in back slot is written before it is handed over
+    esp_amp_platform_memory_barrier();
+
+    /* swap back slot with middle slot and mark middle slot fresh */
+    uint32_t prev = atomic_exchange(&shm->state, tb->local_idx | TRIPLE_BUF_FRESH);
+    tb->local_idx = prev & TRIPLE_BUF_IDX_MASK;
+    return ESP_OK;
+}
+
+int IRAM_ATTR esp_amp_triple_buf_acquire(esp_amp_triple_buf_t* tb, void** buffer)
+{
+    esp_amp_triple_buf_shm_t* shm = (esp_amp_triple_buf_shm_t*)tb->shm;
+    if (tb->producer) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int ret = ESP_ERR_NOT_FOUND;
+    if (atomic_load(&shm->state) & TRIPLE_BUF_FRESH) {
+        /* swap front slot with middle slot. only producer sets fresh bit, so it cannot be cleared in between */
+        uint32_t prev = atomic_exchange(&shm->state, tb->local_idx);
+        tb->local_idx = prev & TRIPLE_BUF_IDX_MASK;
+        // make sure data in front slot is read after it is handed over
+        esp_amp_platform_memory_barrier();
+        ret = ESP_OK;
+    }
+
+    *buffer = tb->slots + tb->local_idx * tb->slot_size;
+    return ret;
+}
+
+uint16_t esp_amp_triple_buf_get_slot_size(esp_amp_triple_buf_t* tb)
+{
+    return tb->slot_size;
+}
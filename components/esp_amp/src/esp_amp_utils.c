@@ -5,8 +5,12 @@
  */
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include "sdkconfig.h"
+#include "esp_amp_sys_info.h"
+#include "esp_amp_platform.h"
+#include "esp_amp_sys_info_priv.h"
 
 #if IS_MAIN_CORE
 uint16_t get_aligned_size(uint16_t size)
@@ -30,4 +34,46 @@ uint16_t get_power_len(uint16_t len)
     len -= 1;
     return 1 << ((sizeof(unsigned int) << 3) - (__builtin_clz((unsigned int)(len))));
 }
+
+uint16_t get_queue_item_size(uint16_t size)
+{
+#if CONFIG_ESP_AMP_QUEUE_BUF_IN_BULK
+    /* buffers in bulk region may be cached, never let two buffers share one cache line */
+    uint32_t line = ESP_AMP_PLATFORM_CACHE_LINE_SIZE;
+    uint32_t aligned = ((uint32_t)size + line - 1) & ~(line - 1);
+    return aligned > UINT16_MAX ? 0 : aligned;
+#else
+    return get_aligned_size(size);
+#endif
+}
+
+/*
+ * Allocate shared memory of virtqueues: control part (configs and descriptors) is allocated
+ * under `sysinfo_id` from control region, so that it is never cached. Data buffers either
+ * follow the control part, or come from bulk region with CONFIG_ESP_AMP_QUEUE_BUF_IN_BULK,
+ * attached to the same entry so that freeing `sysinfo_id` releases both.
+ */
+void *alloc_queue_shm(uint16_t sysinfo_id, uint32_t ctrl_size, uint32_t buf_size, void **buf, uint32_t *buf_caps)
+{
+#if CONFIG_ESP_AMP_QUEUE_BUF_IN_BULK
+    void *ctrl = esp_amp_sys_info_alloc_with_caps(sysinfo_id, ctrl_size, ESP_AMP_SYS_INFO_CAP_CONTROL);
+    if (ctrl == NULL) {
+        return NULL;
+    }
+    *buf = esp_amp_sys_info_alloc_buffer(sysinfo_id, buf_size, ESP_AMP_SYS_INFO_CAP_BULK, buf_caps);
+    if (*buf == NULL) {
+        esp_amp_sys_info_free(sysinfo_id);
+        return NULL;
+    }
+    return ctrl;
+#else
+    uint8_t *ctrl = (uint8_t *)esp_amp_sys_info_alloc_with_caps(sysinfo_id, ctrl_size + buf_size, ESP_AMP_SYS_INFO_CAP_CONTROL);
+    if (ctrl == NULL) {
+        return NULL;
+    }
+    esp_amp_sys_info_get_with_caps(sysinfo_id, NULL, buf_caps);
+    *buf = ctrl + ctrl_size;
+    return ctrl;
+#endif
+}
 #endif /* IS_MAIN_CORE */
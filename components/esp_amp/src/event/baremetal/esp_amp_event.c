@@ -11,29 +11,17 @@
 #include "esp_amp_platform.h"
 #include "esp_amp_event.h"
 #include "esp_amp_log.h"
-
-#ifdef __cplusplus
-#include <atomic>
-using std::atomic_int;
-#else
-#include <stdatomic.h>
-#endif
+#include "esp_amp_shm_bits_priv.h"
 
 #define TAG "event"
 
-typedef struct {
-    uint16_t sysinfo_id;
-    void *event_group;
-    atomic_int *event_bits;
-} esp_amp_event_t;
-
 uint32_t esp_amp_event_notify_by_id(uint16_t sysinfo_id, uint32_t bit_mask)
 {
     uint16_t event_bits_size = 0;
-    atomic_int *event_bits = (atomic_int *)esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
-    assert(event_bits != NULL && event_bits_size == sizeof(atomic_int));
+    esp_amp_shm_bits_t *event_bits = (esp_amp_shm_bits_t *)esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
+    assert(event_bits != NULL && event_bits_size == sizeof(esp_amp_shm_bits_t));
 
-    uint32_t ret_val = atomic_fetch_or_explicit(event_bits, bit_mask, memory_order_seq_cst);
+    uint32_t ret_val = esp_amp_shm_bits_set(event_bits, bit_mask);
     ESP_AMP_LOGD(TAG, "notify event(%p) %p", event_bits, (void *)bit_mask);
     esp_amp_sw_intr_trigger(SW_INTR_RESERVED_ID_EVENT);
     return ret_val;
@@ -41,57 +29,38 @@ uint32_t esp_amp_event_notify_by_id(uint16_t sysinfo_id, uint32_t bit_mask)
 
 uint32_t esp_amp_event_wait_by_id(uint16_t sysinfo_id, uint32_t bit_mask, bool clear_on_exit, bool wait_for_all, uint32_t timeout_ms)
 {
-    int ret = 0;
+    uint32_t ret = 0;
     uint32_t cur_time = esp_amp_platform_get_time_ms();
-    uint32_t expected = bit_mask;
-    uint32_t desired = 0;
-    if (clear_on_exit == false) {
-        desired = expected; /* clear all expected event bit */
-    }
 
     uint16_t event_bits_size = 0;
-    atomic_int *event_bits = esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
-    assert(event_bits != NULL && event_bits_size == sizeof(atomic_int));
-
-    if (wait_for_all) { /* wait for all */
-        while (!atomic_compare_exchange_weak(event_bits, &expected, desired)) {
-            uint32_t actual = expected;
-            /* after cmp&exchg, expect := actual */
-            expected |= bit_mask; /* we expect event bit set */
-
-            if (clear_on_exit == true) {
-                desired = expected & ~bit_mask; /* clear all expected event bit */
-            } else {
-                desired = expected; /* keep all expected event bit unchanged */
-            }
-
-            /* if not all expected event bit set, don't wait */
-            if ((actual & bit_mask) != bit_mask) {
-                /* if timeout */
-                if (esp_amp_platform_get_time_ms() - cur_time > timeout_ms) {
-                    /* expected := actual, otherwise retval will always contain bit_mask set */
-                    expected = actual;
-                    break;
+    esp_amp_shm_bits_t *event_bits = esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
+    assert(event_bits != NULL && event_bits_size == sizeof(esp_amp_shm_bits_t));
+
+    while (1) {
+        if (wait_for_all) {
+            /* bits are only cleared by this core, so they stay set between get and take */
+            ret = esp_amp_shm_bits_get(event_bits);
+            if ((ret & bit_mask) == bit_mask) {
+                if (clear_on_exit) {
+                    ret = esp_amp_shm_bits_take(event_bits, bit_mask); /* clear all expected event bit */
                 }
+                break;
             }
-            /* if all expected event bit set, rerun cmp&exchg to write back */
-            /* this may fail several times, due to modification from other core */
-            /* up to 32 times (32-bit to set), it will succeed */
-        }
-        ret = expected;
-    } else { /* wait for any */
-        do {
-            if (clear_on_exit == true) {
-                ret = atomic_fetch_and(event_bits, ~bit_mask); /* clear any expected event bit */
+        } else {
+            if (clear_on_exit) {
+                ret = esp_amp_shm_bits_take(event_bits, bit_mask); /* clear any expected event bit */
             } else {
-                ret = atomic_load(event_bits);
+                ret = esp_amp_shm_bits_get(event_bits);
             }
-
-            /* if timeout */
-            if (esp_amp_platform_get_time_ms() - cur_time > timeout_ms) {
+            if (ret & bit_mask) {
                 break;
             }
-        } while ((ret & bit_mask) == 0);
+        }
+
+        /* if timeout */
+        if (esp_amp_platform_get_time_ms() - cur_time > timeout_ms) {
+            break;
+        }
     }
     return ret;
 }
@@ -99,22 +68,17 @@ uint32_t esp_amp_event_wait_by_id(uint16_t sysinfo_id, uint32_t bit_mask, bool c
 uint32_t esp_amp_event_clear_by_id(uint16_t sysinfo_id, uint32_t bit_mask)
 {
     uint16_t event_bits_size = 0;
-    atomic_int *event_bits = esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
-    assert(event_bits != NULL && event_bits_size == sizeof(atomic_int));
+    esp_amp_shm_bits_t *event_bits = esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
+    assert(event_bits != NULL && event_bits_size == sizeof(esp_amp_shm_bits_t));
 
-    int expected = 0;
-    int desired = 0;
-    while (!atomic_compare_exchange_weak(event_bits, &expected, desired)) {
-        desired = expected & (~bit_mask);
-    }
-    return expected;
+    return esp_amp_shm_bits_take(event_bits, bit_mask);
 }
 
 int esp_amp_event_init(void)
 {
     /* get event bit */
-    atomic_int * main_core_event_bits = (atomic_int *) esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_EVENT_MAIN, NULL);
-    atomic_int * sub_core_event_bits = (atomic_int *) esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_EVENT_SUB, NULL);
+    esp_amp_shm_bits_t * main_core_event_bits = (esp_amp_shm_bits_t *) esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_EVENT_MAIN, NULL);
+    esp_amp_shm_bits_t * sub_core_event_bits = (esp_amp_shm_bits_t *) esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_EVENT_SUB, NULL);
 
     if (main_core_event_bits == NULL || sub_core_event_bits == NULL) {
         ESP_AMP_LOGE(TAG, "Failed to init default event");
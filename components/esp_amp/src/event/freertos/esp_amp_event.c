@@ -8,13 +8,6 @@
 #include "string.h"
 #include "esp_attr.h"
 
-#ifdef __cplusplus
-#include <atomic>
-using std::atomic_int;
-#else
-#include <stdatomic.h>
-#endif
-
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
 #include "freertos/task.h"
@@ -24,6 +17,7 @@ using std::atomic_int;
 #include "esp_amp_log.h"
 #include "esp_amp_sys_info.h"
 #include "esp_amp_event.h"
+#include "esp_amp_shm_bits_priv.h"
 
 static const DRAM_ATTR char TAG[] = "event";
 
@@ -34,7 +28,7 @@ typedef struct {
     uint16_t sysinfo_id;
     uint16_t direction; /* not used for now */
     void *event_handle;
-    atomic_int *event_bits;
+    esp_amp_shm_bits_t *event_bits;
 } esp_amp_event_t;
 
 /**
@@ -62,10 +56,9 @@ static IRAM_ATTR int os_env_event_isr(void *args)
             continue;
         }
 
-        uint32_t unprocessed = 0;
         BaseType_t task_yield = 0;
 
-        while (!atomic_compare_exchange_weak(event_table[i].event_bits, &unprocessed, 0));
+        uint32_t unprocessed = esp_amp_shm_bits_take(event_table[i].event_bits, UINT32_MAX);
         ESP_AMP_DRAM_LOGD(TAG, "got event: sysinfo=%04x, unprocessed=%p", event_table[i].sysinfo_id, (void *)unprocessed);
         xEventGroupSetBitsFromISR(event_table[i].event_handle, unprocessed, &task_yield);
         need_yield |= task_yield;
@@ -78,10 +71,10 @@ static IRAM_ATTR int os_env_event_isr(void *args)
 uint32_t IRAM_ATTR esp_amp_event_notify_by_id(uint16_t sysinfo_id, uint32_t bit_mask)
 {
     uint16_t event_bits_size = 0;
-    atomic_int *event_bits = (atomic_int *)esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
-    assert(event_bits != NULL && event_bits_size == sizeof(atomic_int));
+    esp_amp_shm_bits_t *event_bits = (esp_amp_shm_bits_t *)esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
+    assert(event_bits != NULL && event_bits_size == sizeof(esp_amp_shm_bits_t));
 
-    uint32_t ret_val = atomic_fetch_or_explicit(event_bits, bit_mask, memory_order_seq_cst);
+    uint32_t ret_val = esp_amp_shm_bits_set(event_bits, bit_mask);
 
     ESP_AMP_DRAM_LOGD(TAG, "notify event(%p): %p", event_bits, (void *)bit_mask);
     esp_amp_sw_intr_trigger(SW_INTR_RESERVED_ID_EVENT);
@@ -134,8 +127,8 @@ int esp_amp_event_bind_handle(uint16_t sysinfo_id, void *event_handle)
     }
 
     uint16_t event_bits_size = 0;
-    atomic_int *event_bits = esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
-    assert(event_bits != NULL && event_bits_size == sizeof(atomic_int));
+    esp_amp_shm_bits_t *event_bits = esp_amp_sys_info_get(sysinfo_id, &event_bits_size);
+    assert(event_bits != NULL && event_bits_size == sizeof(esp_amp_shm_bits_t));
 
     int idx_dup = ESP_AMP_EVENT_TABLE_LEN;
     int idx_free = ESP_AMP_EVENT_TABLE_LEN;
@@ -164,8 +157,7 @@ int esp_amp_event_bind_handle(uint16_t sysinfo_id, void *event_handle)
     }
 
     /* set bits once bound to avoid missing event*/
-    uint32_t unprocessed = atomic_load(event_bits);
-    while (!atomic_compare_exchange_weak(event_bits, &unprocessed, 0));
+    uint32_t unprocessed = esp_amp_shm_bits_take(event_bits, UINT32_MAX);
     xEventGroupSetBits(event_handle, unprocessed);
     ESP_AMP_LOGD(TAG, "event_bits(%04x) bind value %p", sysinfo_id, (void *)unprocessed);
     return 0;
@@ -200,11 +192,11 @@ void esp_amp_event_table_dump(void)
 #if IS_MAIN_CORE
 int esp_amp_event_create(uint16_t sysinfo_id)
 {
-    atomic_int *event_bits = esp_amp_sys_info_alloc(sysinfo_id, sizeof(atomic_int));
+    esp_amp_shm_bits_t *event_bits = esp_amp_sys_info_alloc(sysinfo_id, sizeof(esp_amp_shm_bits_t));
     if (event_bits == NULL) {
         return -1;
     }
-    atomic_init(event_bits, 0);
+    esp_amp_shm_bits_init(event_bits);
     return 0;
 }
 #endif /* IS_MAIN_CORE */
@@ -216,10 +208,10 @@ int esp_amp_event_init(void)
     assert(esp_amp_event_create(SYS_INFO_RESERVED_ID_EVENT_SUB) == 0);
 #else
     uint16_t event_bits_size = 0;
-    atomic_int *main_core_event_bits = (atomic_int *) esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_EVENT_MAIN, &event_bits_size);
-    assert(main_core_event_bits != NULL && event_bits_size == sizeof(atomic_int));
-    atomic_int *sub_core_event_bits = (atomic_int *) esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_EVENT_SUB, &event_bits_size);
-    assert(sub_core_event_bits != NULL && event_bits_size == sizeof(atomic_int));
+    esp_amp_shm_bits_t *main_core_event_bits = (esp_amp_shm_bits_t *) esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_EVENT_MAIN, &event_bits_size);
+    assert(main_core_event_bits != NULL && event_bits_size == sizeof(esp_amp_shm_bits_t));
+    esp_amp_shm_bits_t *sub_core_event_bits = (esp_amp_shm_bits_t *) esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_EVENT_SUB, &event_bits_size);
+    assert(sub_core_event_bits != NULL && event_bits_size == sizeof(esp_amp_shm_bits_t));
 #endif /* IS_MAIN_CORE */
 
     /* init event group table */
@@ -9,6 +9,7 @@
 #include "esp_amp_log.h"
 #include "esp_amp_env.h"
 #include "esp_amp_rpc.h"
+#include "esp_amp_copy.h"
 
 static const DRAM_ATTR __attribute__((unused)) char TAG[] = "esp_amp_rpc_client";
 
@@ -27,7 +28,7 @@ static int IRAM_ATTR client_cb(void* data, uint16_t data_len, uint16_t src_addr,
 
         if (resp_pkt->msg_len > 0 && client_inst->pending_cmd->resp_data != NULL) {
             int cpy_len = resp_pkt->msg_len > client_inst->pending_cmd->resp_len ? client_inst->pending_cmd->resp_len : resp_pkt->msg_len;
-            memcpy(client_inst->pending_cmd->resp_data, resp_pkt->msg_data, cpy_len);
+            esp_amp_copy(client_inst->pending_cmd->resp_data, resp_pkt->msg_data, cpy_len);
         }
 
         if (client_inst->pending_cmd->cb) {
@@ -91,31 +92,34 @@ int esp_amp_rpc_client_execute_cmd(esp_amp_rpc_client_t client, esp_amp_rpc_cmd_
     /* set cmd status to pending */
     cmd->status = ESP_AMP_RPC_STATUS_PENDING;
 
-    /* fetch new buffer from buffer pool */
     uint16_t req_pkt_len = cmd->req_len + sizeof(esp_amp_rpc_pkt_t);
-    uint8_t *req_pkt_buf = (uint8_t *)esp_amp_rpmsg_create_message(client_inst->rpmsg_dev, req_pkt_len, ESP_AMP_RPMSG_DATA_DEFAULT);
-    if (req_pkt_buf == NULL) {
-        if (esp_amp_rpmsg_get_max_size(client_inst->rpmsg_dev) < req_pkt_len) {
-            return ESP_AMP_RPC_ERR_INVALID_SIZE; /* buffer cannot fit */
-        }
-        return ESP_AMP_RPC_ERR_NO_MEM; /* buffer pool is empty */
+    if (esp_amp_rpmsg_get_max_size(client_inst->rpmsg_dev) < req_pkt_len) {
+        return ESP_AMP_RPC_ERR_INVALID_SIZE; /* buffer cannot fit */
     }
 
     /* construct packet */
     esp_amp_rpc_pkt_t req_pkt = {
         .cmd_id = cmd->cmd_id,
         .status = ESP_AMP_RPC_STATUS_PENDING,
-        .msg_id = ++client_inst->pending_id,
+        .msg_id = client_inst->pending_id + 1,
         .msg_len = cmd->req_len,
     };
+    esp_amp_rpmsg_iovec_t req_iov[] = {
+        { .data = &req_pkt, .len = sizeof(esp_amp_rpc_pkt_t) },
+        { .data = cmd->req_data, .len = cmd->req_len },
+    };
 
     /* keep track of current command for later response */
+    esp_amp_rpc_cmd_t *prev_cmd = client_inst->pending_cmd;
     client_inst->pending_cmd = cmd;
-    memcpy(req_pkt_buf, &req_pkt, sizeof(esp_amp_rpc_pkt_t));
-    memcpy(req_pkt_buf + sizeof(esp_amp_rpc_pkt_t), cmd->req_data, cmd->req_len);
+    client_inst->pending_id = req_pkt.msg_id;
 
-    /* send packet to server */
-    esp_amp_rpmsg_send_nocopy(client_inst->rpmsg_dev, &client_inst->rpmsg_ept, client_inst->server_id, req_pkt_buf, req_pkt_len);
+    /* header and request data are gathered into one packet and sent to server */
+    if (esp_amp_rpmsg_sendv(client_inst->rpmsg_dev, &client_inst->rpmsg_ept, client_inst->server_id, req_iov, 2) != 0) {
+        client_inst->pending_cmd = prev_cmd;
+        client_inst->pending_id = req_pkt.msg_id - 1;
+        return ESP_AMP_RPC_ERR_NO_MEM; /* buffer pool is empty */
+    }
     return ESP_AMP_RPC_OK;
 }
 
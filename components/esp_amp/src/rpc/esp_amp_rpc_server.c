@@ -11,9 +11,14 @@
 #include "esp_amp_env.h"
 #include "esp_amp_rpmsg.h"
 #include "esp_amp_rpc.h"
+#include "esp_amp_copy.h"
+#include "esp_amp_platform.h"
 
 static const DRAM_ATTR char __attribute__((unused)) TAG[] = "esp_amp_rpc_server";
 
+#define RPC_SERVER_RESP_RETRY_NUM       10
+#define RPC_SERVER_RESP_RETRY_DELAY_US  100
+
 typedef struct {
     uint16_t client_addr;
     uint16_t pkt_len;
@@ -64,6 +69,7 @@ esp_amp_rpc_server_t esp_amp_rpc_server_init(esp_amp_rpc_server_cfg_t *cfg)
     server_inst->rpmsg_dev = cfg->rpmsg_dev;
     server_inst->srv_tbl_len = cfg->srv_tbl_len;
     server_inst->srv = (esp_amp_rpc_service_t *)cfg->srv_tbl_stg;
+    server_inst->resp_drop_num = 0;
     server_inst->running = true;
     esp_amp_env_exit_critical();
     return server_inst;
@@ -148,7 +154,7 @@ static void exec_cmd_and_send(esp_amp_rpc_server_inst_t *server_inst, esp_amp_rp
     uint16_t resp_buf_len = server_inst->resp_buf_len;
     uint16_t cmd_id = req_pkt->cmd_id;
     uint16_t msg_id = req_pkt->msg_id;
-    memcpy(server_inst->req_buf, req_pkt->msg_data, req_buf_len);
+    esp_amp_copy(server_inst->req_buf, req_pkt->msg_data, req_buf_len);
 
     /* destroy request */
     esp_amp_rpmsg_destroy(server_inst->rpmsg_dev, req_pkt);
@@ -185,9 +191,7 @@ static void exec_cmd_and_send(esp_amp_rpc_server_inst_t *server_inst, esp_amp_rp
 
     /* only send response if response is needed */
     if (cmd.resp_len > 0) {
-        uint16_t resp_pkt_buf_max_len = esp_amp_rpmsg_get_max_size(server_inst->rpmsg_dev);
-        uint8_t *resp_pkt_buf = esp_amp_rpmsg_create_message(server_inst->rpmsg_dev, resp_pkt_buf_max_len, ESP_AMP_RPMSG_DATA_DEFAULT);
-        uint16_t msg_max_len = resp_pkt_buf_max_len - sizeof(esp_amp_rpc_pkt_t);
+        uint16_t msg_max_len = esp_amp_rpmsg_get_max_size(server_inst->rpmsg_dev) - sizeof(esp_amp_rpc_pkt_t);
         uint16_t msg_len = cmd.resp_len > msg_max_len ? msg_max_len : cmd.resp_len;
         esp_amp_rpc_pkt_t resp_pkt = {
             .msg_id = msg_id,
@@ -195,11 +199,26 @@ static void exec_cmd_and_send(esp_amp_rpc_server_inst_t *server_inst, esp_amp_rp
             .status = cmd.status,
             .msg_len = msg_len,
         };
-        memcpy(resp_pkt_buf, &resp_pkt, sizeof(esp_amp_rpc_pkt_t));
-        memcpy(resp_pkt_buf + sizeof(esp_amp_rpc_pkt_t), cmd.resp_data, msg_len);
+        esp_amp_rpmsg_iovec_t resp_iov[] = {
+            { .data = &resp_pkt, .len = sizeof(esp_amp_rpc_pkt_t) },
+            { .data = cmd.resp_data, .len = msg_len },
+        };
+
+        /* send response, msg is cut off to fit in send buffer. retry if tx buffer is used up */
+        int ret = -1;
+        for (int i = 0; i < RPC_SERVER_RESP_RETRY_NUM; i++) {
+            ret = esp_amp_rpmsg_sendv(server_inst->rpmsg_dev, &server_inst->rpmsg_ept, client_addr, resp_iov, 2);
+            if (ret == 0) {
+                break;
+            }
+            esp_amp_platform_delay_us(RPC_SERVER_RESP_RETRY_DELAY_US);
+        }
 
-        /* send response, msg is cut off to fit in send buffer. will always success */
-        esp_amp_rpmsg_send_nocopy(server_inst->rpmsg_dev, &server_inst->rpmsg_ept, client_addr, resp_pkt_buf, sizeof(esp_amp_rpc_pkt_t) + msg_len);
+        /* client will time out on this msg_id */
+        if (ret != 0) {
+            server_inst->resp_drop_num++;
+            ESP_AMP_LOGW(TAG, "drop response of cmd %d msg %d to client %d", cmd_id, msg_id, client_addr);
+        }
     }
 }
 
@@ -259,3 +278,12 @@ static int server_cb(void* data, uint16_t data_len, uint16_t src_addr, void* pri
     return ESP_AMP_RPC_OK;
 }
 #endif
+
+uint32_t esp_amp_rpc_server_get_resp_drop_num(esp_amp_rpc_server_t server)
+{
+    esp_amp_rpc_server_inst_t *server_inst = (esp_amp_rpc_server_inst_t *)server;
+    if (server_inst == NULL) {
+        return 0;
+    }
+    return server_inst->resp_drop_num;
+}
@@ -0,0 +1,619 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include "string.h"
+#include "errno.h"
+#include <sys/param.h>
+#include <sys/stat.h>
+
+#include "esp_amp_sys_info.h"
+#include "esp_amp_platform.h"
+#include "esp_amp_system.h"
+#include "esp_amp_service.h"
+#include "esp_amp_file_proxy.h"
+
+#if IS_MAIN_CORE
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <reent.h>
+#endif
+
+#if CONFIG_ESP_AMP_SUBCORE_FILE_PROXY
+
+#define FILE_PROXY_FD_BASE      3   /* subcore fd 0 ~ 2 are stdin, stdout and stderr */
+#define FILE_PROXY_MAX_FILES    8   /* number of files subcore can open at the same time */
+
+/* file operations forwarded to maincore */
+#define FILE_PROXY_OP_OPEN      1
+#define FILE_PROXY_OP_CLOSE     2
+#define FILE_PROXY_OP_READ      3
+#define FILE_PROXY_OP_WRITE     4
+#define FILE_PROXY_OP_LSEEK     5
+#define FILE_PROXY_OP_FSTAT     6
+#define FILE_PROXY_OP_RESET     7   /* close files left open by last boot of subcore */
+
+typedef struct {
+    uint32_t seq;       /* sequence number of request */
+    uint16_t op;        /* file operation */
+    int16_t fd;         /* subcore fd */
+    int32_t arg0;       /* flags of open, length of read and write, offset of lseek */
+    int32_t arg1;       /* mode of open, whence of lseek */
+    char path[0];       /* '\0'-terminated path of open */
+} file_proxy_req_t;
+
+typedef struct {
+    uint32_t mode;
+    int32_t size;
+} file_proxy_stat_t;
+
+typedef struct {
+    volatile uint32_t done_seq; /* sequence number of last finished request, only written by maincore */
+    volatile int32_t ret;       /* return value of last finished request */
+    volatile int32_t err;       /* errno of last finished request if it fails */
+    uint32_t size;              /* size of buf in byte */
+    uint32_t buf[0];            /* data of read, write and fstat, word-aligned */
+} file_proxy_chan_t;
+
+static file_proxy_chan_t *s_file_chan = NULL;
+
+#if IS_MAIN_CORE
+/* maincore fd of files opened by subcore, indexed by subcore fd minus FILE_PROXY_FD_BASE */
+static int s_main_fds[FILE_PROXY_MAX_FILES];
+
+static int file_proxy_get_main_fd(int fd)
+{
+    if (fd < FILE_PROXY_FD_BASE || fd >= FILE_PROXY_FD_BASE + FILE_PROXY_MAX_FILES) {
+        return -1;
+    }
+    return s_main_fds[fd - FILE_PROXY_FD_BASE];
+}
+
+static int file_proxy_open(file_proxy_req_t *req, uint16_t req_len)
+{
+    uint16_t path_max = req_len - sizeof(file_proxy_req_t);
+    if (memchr(req->path, '\0', path_max) == NULL) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    int idx;
+    for (idx = 0; idx < FILE_PROXY_MAX_FILES; idx++) {
+        if (s_main_fds[idx] < 0) {
+            break;
+        }
+    }
+    if (idx == FILE_PROXY_MAX_FILES) {
+        errno = EMFILE;
+        return -1;
+    }
+
+    int main_fd = open(req->path, req->arg0, req->arg1);
+    if (main_fd < 0) {
+        return -1;
+    }
+    s_main_fds[idx] = main_fd;
+    return FILE_PROXY_FD_BASE + idx;
+}
+
+static int file_proxy_write(int main_fd, uint32_t len)
+{
+    uint8_t *data = (uint8_t *)s_file_chan->buf;
+    uint32_t written = 0;
+
+    /* data may be batched from several writes already returned on subcore, write all of it */
+    while (written < len) {
+        ssize_t ret = write(main_fd, data + written, len - written);
+        if (ret <= 0) {
+            if (ret == 0) {
+                errno = ENOSPC;
+            }
+            return -1;
+        }
+        written += ret;
+    }
+    return written;
+}
+
+static int file_proxy_reset(void)
+{
+    for (int i = 0; i < FILE_PROXY_MAX_FILES; i++) {
+        if (s_main_fds[i] >= 0) {
+            close(s_main_fds[i]);
+            s_main_fds[i] = -1;
+        }
+    }
+    return 0;
+}
+
+static int file_proxy_fstat(int main_fd)
+{
+    struct stat st;
+    if (fstat(main_fd, &st) != 0) {
+        return -1;
+    }
+
+    file_proxy_stat_t *sub_st = (file_proxy_stat_t *)s_file_chan->buf;
+    sub_st->mode = st.st_mode;
+    sub_st->size = st.st_size;
+    return 0;
+}
+
+static void file_proxy_handler(void *param, uint16_t param_len, void *arg)
+{
+    (void)arg;
+    file_proxy_chan_t *chan = s_file_chan;
+    file_proxy_req_t *req = (file_proxy_req_t *)param;
+    int ret = -1;
+
+    if (param_len < sizeof(file_proxy_req_t)) {
+        /* no sequence number to mark as done */
+        return;
+    }
+
+    errno = 0;
+    if (req->op == FILE_PROXY_OP_OPEN) {
+        ret = file_proxy_open(req, param_len);
+    } else if (req->op == FILE_PROXY_OP_RESET) {
+        ret = file_proxy_reset();
+    } else {
+        int main_fd = file_proxy_get_main_fd(req->fd);
+        if (main_fd < 0) {
+            errno = EBADF;
+        } else if ((req->op == FILE_PROXY_OP_READ || req->op == FILE_PROXY_OP_WRITE) &&
+                   (req->arg0 < 0 || (uint32_t)req->arg0 > chan->size)) {
+            errno = EINVAL;
+        } else {
+            switch (req->op) {
+            case FILE_PROXY_OP_CLOSE:
+                ret = close(main_fd);
+                s_main_fds[req->fd - FILE_PROXY_FD_BASE] = -1;
+                break;
+            case FILE_PROXY_OP_READ:
+                ret = read(main_fd, chan->buf, req->arg0);
+                break;
+            case FILE_PROXY_OP_WRITE:
+                ret = file_proxy_write(main_fd, req->arg0);
+                break;
+            case FILE_PROXY_OP_LSEEK:
+                ret = lseek(main_fd, req->arg0, req->arg1);
+                break;
+            case FILE_PROXY_OP_FSTAT:
+                ret = file_proxy_fstat(main_fd);
+                break;
+            default:
+                errno = ENOSYS;
+                break;
+            }
+        }
+    }
+
+    chan->ret = ret;
+    chan->err = (ret < 0) ? errno : 0;
+    // make sure result is written before request is marked as done
+    esp_amp_platform_memory_barrier();
+    chan->done_seq = req->seq;
+}
+
+int esp_amp_file_proxy_init(void)
+{
+    uint32_t size = CONFIG_ESP_AMP_SUBCORE_FILE_PROXY_BUF_SIZE & ~3;
+    file_proxy_chan_t *chan = (file_proxy_chan_t *)esp_amp_sys_info_alloc(SYS_INFO_RESERVED_ID_FILE, sizeof(file_proxy_chan_t) + size);
+    if (chan == NULL) {
+        return -1;
+    }
+
+    for (int i = 0; i < FILE_PROXY_MAX_FILES; i++) {
+        s_main_fds[i] = -1;
+    }
+    chan->done_seq = 0;
+    chan->ret = 0;
+    chan->err = 0;
+    chan->size = size;
+    esp_amp_platform_memory_barrier();
+    s_file_chan = chan;
+
+    if (esp_amp_system_service_register(ESP_AMP_SYSTEM_SERVICE_ID_FILE_PROXY, file_proxy_handler, NULL) != 0) {
+        s_file_chan = NULL;
+        esp_amp_sys_info_free(SYS_INFO_RESERVED_ID_FILE);
+        return -1;
+    }
+    return 0;
+}
+
+#else /* IS_MAIN_CORE */
+
+#define FILE_PROXY_POLL_US      10  /* interval of checking if maincore is done */
+
+static uint32_t s_seq = 0;          /* sequence number of last request sent */
+static bool s_busy = false;         /* last request is not done in time, maincore may still use channel buffer */
+static bool s_reset = false;        /* files left open by last boot of subcore are closed */
+static uint32_t s_open_fds = 0;     /* bitmap of subcore fds opened via file proxy */
+static int s_wb_fd = -1;            /* fd of write data batched in channel buffer */
+static uint32_t s_wb_len = 0;       /* length of write data batched in channel buffer */
+static int s_wb_err[FILE_PROXY_MAX_FILES]; /* error of batched data not written, indexed like s_open_fds */
+
+static bool file_proxy_fd_is_open(int fd)
+{
+    if (fd < FILE_PROXY_FD_BASE || fd >= FILE_PROXY_FD_BASE + FILE_PROXY_MAX_FILES) {
+        return false;
+    }
+    return (s_open_fds & (1 << (fd - FILE_PROXY_FD_BASE))) != 0;
+}
+
+/* wait until maincore is done with last request */
+static int file_proxy_wait_done(void)
+{
+    uint32_t start_ms = esp_amp_platform_get_time_ms();
+
+    while (s_file_chan->done_seq != s_seq) {
+        if (esp_amp_platform_get_time_ms() - start_ms >= CONFIG_ESP_AMP_SUBCORE_FILE_PROXY_TIMEOUT_MS) {
+            return -1;
+        }
+        esp_amp_platform_delay_us(FILE_PROXY_POLL_US);
+    }
+    // make sure result is read after request is done
+    esp_amp_platform_memory_barrier();
+    s_busy = false;
+    return 0;
+}
+
+/* wait until channel buffer is no longer used by a request timed out before */
+static int file_proxy_wait_idle(void)
+{
+    return s_busy ? file_proxy_wait_done() : 0;
+}
+
+/* send request to maincore and wait until it is done. return value and errno are those on maincore */
+static int file_proxy_send(uint16_t op, int fd, int32_t arg0, int32_t arg1, const char *path, int *err)
+{
+    size_t path_len = path ? strlen(path) + 1 : 0;
+    file_proxy_req_t *req;
+    uint16_t max_len;
+
+    if (file_proxy_wait_idle() != 0) {
+        *err = EIO;
+        return -1;
+    }
+
+    /* requests are given back by supplicant, wait for a free one */
+    uint32_t start_ms = esp_amp_platform_get_time_ms();
+    while (esp_amp_system_service_create_request((void **)&req, &max_len) != 0) {
+        if (esp_amp_platform_get_time_ms() - start_ms >= CONFIG_ESP_AMP_SUBCORE_FILE_PROXY_TIMEOUT_MS) {
+            *err = EIO;
+            return -1;
+        }
+        esp_amp_platform_delay_us(FILE_PROXY_POLL_US);
+    }
+
+    size_t req_len = sizeof(file_proxy_req_t) + path_len;
+    if (req_len > max_len) {
+        /* request can't be cancelled, send it empty so that it is ignored by maincore */
+        esp_amp_system_service_send_request(ESP_AMP_SYSTEM_SERVICE_ID_FILE_PROXY, req, 0);
+        *err = ENAMETOOLONG;
+        return -1;
+    }
+
+    req->seq = ++s_seq;
+    req->op = op;
+    req->fd = fd;
+    req->arg0 = arg0;
+    req->arg1 = arg1;
+    if (path_len) {
+        memcpy(req->path, path, path_len);
+    }
+    if (esp_amp_system_service_send_request(ESP_AMP_SYSTEM_SERVICE_ID_FILE_PROXY, req, req_len) != 0) {
+        *err = EIO;
+        return -1;
+    }
+
+    s_busy = true;
+    if (file_proxy_wait_done() != 0) {
+        *err = EIO;
+        return -1;
+    }
+
+    int ret = s_file_chan->ret;
+    *err = s_file_chan->err;
+    return ret;
+}
+
+static int file_proxy_call(uint16_t op, int fd, int32_t arg0, int32_t arg1, const char *path, int *err)
+{
+    if (s_file_chan == NULL || !esp_amp_system_service_is_ready()) {
+        *err = ENOSYS;
+        return -1;
+    }
+
+    /* maincore still holds files opened before subcore restarts, close them with the first request */
+    if (!s_reset) {
+        if (file_proxy_send(FILE_PROXY_OP_RESET, -1, 0, 0, NULL, err) < 0) {
+            return -1;
+        }
+        s_reset = true;
+    }
+    return file_proxy_send(op, fd, arg0, arg1, path, err);
+}
+
+/* write batched data to file. batch is dropped if it fails, error is kept until reported for that file */
+static void file_proxy_flush(void)
+{
+    int err = 0;
+
+    if (s_wb_len == 0) {
+        return;
+    }
+
+    int idx = s_wb_fd - FILE_PROXY_FD_BASE;
+    if (file_proxy_call(FILE_PROXY_OP_WRITE, s_wb_fd, s_wb_len, 0, NULL, &err) < 0 && s_wb_err[idx] == 0) {
+        s_wb_err[idx] = err;
+    }
+    s_wb_fd = -1;
+    s_wb_len = 0;
+}
+
+/* get and clear error of batched data of a file */
+static int file_proxy_take_err(int fd)
+{
+    int err = s_wb_err[fd - FILE_PROXY_FD_BASE];
+    s_wb_err[fd - FILE_PROXY_FD_BASE] = 0;
+    return err;
+}
+
+static int file_proxy_read(int fd, uint32_t len, int *err)
+{
+    if (!file_proxy_fd_is_open(fd)) {
+        *err = EBADF;
+        return -1;
+    }
+    file_proxy_flush();
+    return file_proxy_call(FILE_PROXY_OP_READ, fd, MIN(len, s_file_chan->size), 0, NULL, err);
+}
+
+static void file_proxy_console_write(const char *data, size_t size)
+{
+    extern int esp_amp_subcore_putchar(int ch);
+    for (size_t i = 0; i < size; i++) {
+        esp_amp_subcore_putchar(data[i]);
+    }
+}
+
+int _open_r(struct _reent *r, const char *path, int flags, int mode)
+{
+    int err = 0;
+
+    file_proxy_flush();
+    int ret = file_proxy_call(FILE_PROXY_OP_OPEN, -1, flags, mode, path, &err);
+    if (ret < 0) {
+        __errno_r(r) = err;
+        return -1;
+    }
+    s_open_fds |= 1 << (ret - FILE_PROXY_FD_BASE);
+    s_wb_err[ret - FILE_PROXY_FD_BASE] = 0;
+    return ret;
+}
+
+int _close_r(struct _reent *r, int fd)
+{
+    int err = 0;
+
+    if (fd < FILE_PROXY_FD_BASE) {
+        return 0;
+    }
+    if (!file_proxy_fd_is_open(fd)) {
+        __errno_r(r) = EBADF;
+        return -1;
+    }
+
+    /* batched data of this file is written before it is closed, report its error if any */
+    file_proxy_flush();
+    int ret = file_proxy_call(FILE_PROXY_OP_CLOSE, fd, 0, 0, NULL, &err);
+    s_open_fds &= ~(1 << (fd - FILE_PROXY_FD_BASE));
+    int wb_err = file_proxy_take_err(fd);
+    if (wb_err != 0) {
+        __errno_r(r) = wb_err;
+        return -1;
+    }
+    if (ret < 0) {
+        __errno_r(r) = err;
+        return -1;
+    }
+    return 0;
+}
+
+ssize_t _write_r(struct _reent *r, int fd, const void *data, size_t size)
+{
+    int err = 0;
+
+    if (fd < FILE_PROXY_FD_BASE) {
+        file_proxy_console_write(data, size);
+        return size;
+    }
+    if (!file_proxy_fd_is_open(fd)) {
+        __errno_r(r) = EBADF;
+        return -1;
+    }
+
+    /* data batched by earlier writes failed to be written */
+    err = file_proxy_take_err(fd);
+    if (err != 0) {
+        __errno_r(r) = err;
+        return -1;
+    }
+
+    /* small writes to the same file are batched in channel buffer and written by maincore at once */
+    if (s_wb_len != 0 && s_wb_fd != fd) {
+        file_proxy_flush();
+    }
+    if (s_wb_len == 0 && file_proxy_wait_idle() != 0) {
+        __errno_r(r) = EIO;
+        return -1;
+    }
+
+    const uint8_t *src = (const uint8_t *)data;
+    size_t copied = 0;
+    size_t accepted = 0;    /* data of this write already written by maincore */
+    while (copied < size) {
+        uint32_t n = MIN(size - copied, s_file_chan->size - s_wb_len);
+        memcpy((uint8_t *)s_file_chan->buf + s_wb_len, src + copied, n);
+        s_wb_fd = fd;
+        s_wb_len += n;
+        copied += n;
+        if (s_wb_len == s_file_chan->size) {
+            file_proxy_flush();
+            err = file_proxy_take_err(fd);
+            if (err != 0) {
+                if (accepted == 0) {
+                    __errno_r(r) = err;
+                    return -1;
+                }
+                /* short write, error is reported by next write */
+                s_wb_err[fd - FILE_PROXY_FD_BASE] = err;
+                return accepted;
+            }
+            accepted = copied;
+        }
+    }
+    return size;
+}
+
+ssize_t _read_r(struct _reent *r, int fd, void *dst, size_t size)
+{
+    int err = 0;
+
+    if (fd < FILE_PROXY_FD_BASE) {
+        /* no console input on subcore */
+        return 0;
+    }
+
+    uint8_t *dst_buf = (uint8_t *)dst;
+    size_t total = 0;
+    while (total < size) {
+        uint32_t len = MIN(size - total, s_file_chan->size);
+        int ret = file_proxy_read(fd, len, &err);
+        if (ret < 0) {
+            if (total == 0) {
+                __errno_r(r) = err;
+                return -1;
+            }
+            break;
+        }
+        memcpy(dst_buf + total, s_file_chan->buf, ret);
+        total += ret;
+        if ((uint32_t)ret < len) {
+            /* end of file */
+            break;
+        }
+    }
+    return total;
+}
+
+off_t _lseek_r(struct _reent *r, int fd, off_t offset, int whence)
+{
+    int err = 0;
+    int ret = -1;
+
+    if (fd < FILE_PROXY_FD_BASE) {
+        err = ESPIPE;
+    } else if (!file_proxy_fd_is_open(fd)) {
+        err = EBADF;
+    } else {
+        file_proxy_flush();
+        ret = file_proxy_call(FILE_PROXY_OP_LSEEK, fd, offset, whence, NULL, &err);
+    }
+    if (ret < 0) {
+        __errno_r(r) = err;
+        return -1;
+    }
+    return ret;
+}
+
+int _fstat_r(struct _reent *r, int fd, struct stat *st)
+{
+    int err = 0;
+    int ret = -1;
+
+    memset(st, 0, sizeof(struct stat));
+    if (fd < FILE_PROXY_FD_BASE) {
+        st->st_mode = S_IFCHR;
+        return 0;
+    }
+
+    if (!file_proxy_fd_is_open(fd)) {
+        err = EBADF;
+    } else {
+        file_proxy_flush();
+        ret = file_proxy_call(FILE_PROXY_OP_FSTAT, fd, 0, 0, NULL, &err);
+    }
+    if (ret < 0) {
+        __errno_r(r) = err;
+        return -1;
+    }
+
+    file_proxy_stat_t *sub_st = (file_proxy_stat_t *)s_file_chan->buf;
+    st->st_mode = sub_st->mode;
+    st->st_size = sub_st->size;
+    return 0;
+}
+
+int esp_amp_subcore_file_flush(void)
+{
+    int err = 0;
+
+    /* report the first error kept for any file, all of them are cleared */
+    file_proxy_flush();
+    for (int fd = FILE_PROXY_FD_BASE; fd < FILE_PROXY_FD_BASE + FILE_PROXY_MAX_FILES; fd++) {
+        int wb_err = file_proxy_take_err(fd);
+        if (err == 0) {
+            err = wb_err;
+        }
+    }
+    if (err != 0) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+int esp_amp_subcore_file_read_shared(int fd, uint16_t len, const void **data)
+{
+    int err = 0;
+
+    *data = NULL;
+    int ret = file_proxy_read(fd, len, &err);
+    if (ret < 0) {
+        errno = err;
+        return -1;
+    }
+    *data = s_file_chan->buf;
+    return ret;
+}
+
+/* referenced by linker with -u to pull in file syscalls above instead of those in newlib */
+void esp_amp_file_proxy_include_syscalls(void)
+{
+}
+
+int esp_amp_file_proxy_init(void)
+{
+    file_proxy_chan_t *chan = (file_proxy_chan_t *)esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_FILE, NULL);
+    if (chan == NULL) {
+        return -1;
+    }
+    s_file_chan = chan;
+    /* continue from sequence number of last boot, so that its result is never taken as done */
+    s_seq = chan->done_seq + 1;
+    return 0;
+}
+#endif /* IS_MAIN_CORE */
+
+bool esp_amp_file_proxy_is_ready(void)
+{
+    return s_file_chan != NULL;
+}
+
+#endif /* CONFIG_ESP_AMP_SUBCORE_FILE_PROXY */
@@ -25,6 +25,7 @@
 #include "esp_amp.h"
 #include "esp_amp_log.h"
 #include "esp_amp_system.h"
+#include "esp_amp_system_priv.h"
 #include "esp_amp_mem_priv.h"
 
 #if CONFIG_ESP_AMP_SUBCORE_TYPE_LP_CORE
@@ -73,6 +74,24 @@ static bool is_valid_subcore_app_addr(intptr_t addr)
     return ret;
 }
 
+#if CONFIG_ESP_AMP_SUBCORE_USE_HP_MEM
+/* end of subcore firmware in reserved dram. the rest is given back to main-core heap after loading */
+static intptr_t s_subcore_app_dram_end = SUBCORE_USE_HP_MEM_START;
+#endif
+
+bool esp_amp_system_is_subcore_app_addr(intptr_t addr)
+{
+    bool ret = false;
+#if CONFIG_ESP_AMP_SUBCORE_USE_HP_MEM
+    ret |= (addr >= SUBCORE_USE_HP_MEM_START && addr < s_subcore_app_dram_end);
+#endif
+
+#if CONFIG_ESP_AMP_SUBCORE_TYPE_LP_CORE
+    ret |= is_valid_subcore_app_rtcram_addr(addr);
+#endif
+    return ret;
+}
+
 static void show_sub_app_info(esp_app_desc_t *app_desc)
 {
     ESP_AMP_LOGI(TAG, "Subcore App Info:");
@@ -130,7 +149,13 @@ esp_err_t esp_amp_load_sub(const void* sub_bin)
     memcpy(&sub_img_data.image, sub_bin_byte_ptr, sizeof(esp_image_header_t));
 
 #if CONFIG_ESP_AMP_SUBCORE_TYPE_LP_CORE
+#if CONFIG_ESP_AMP_SHARED_MEM_IN_LP
+    /* shared memory at the top of LP core reserved memory is already initialized by maincore, keep it */
+    hal_memset(ulp_base_address, 0, ESP_AMP_SHARED_MEM_START - (intptr_t)ulp_base_address);
+    hal_memset((void *)ESP_AMP_SHARED_MEM_END, 0, (intptr_t)ulp_base_address + CONFIG_ULP_COPROC_RESERVE_MEM - ESP_AMP_SHARED_MEM_END);
+#else
     hal_memset(ulp_base_address, 0, CONFIG_ULP_COPROC_RESERVE_MEM);
+#endif
     if (sub_img_data.image.entry_addr != ULP_RESET_HANDLER_ADDR) {
         ESP_AMP_LOGE(TAG, "Invalid entry address");
         ret = ESP_FAIL;
@@ -183,6 +208,7 @@ esp_err_t esp_amp_load_sub(const void* sub_bin)
     if (ret != ESP_OK) {
         unused_reserved_dram_start = SUBCORE_USE_HP_MEM_START;
     }
+    s_subcore_app_dram_end = unused_reserved_dram_start;
 
     if (heap_caps_add_region(unused_reserved_dram_start, (intptr_t)SUBCORE_USE_HP_MEM_END) == ESP_OK) {
         ESP_AMP_LOGI(TAG, "Give unused reserved dram region (%p - %p) back to main-core heap",
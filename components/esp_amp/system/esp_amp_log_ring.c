@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include "string.h"
+
+#include "esp_amp_sys_info.h"
+#include "esp_amp_sw_intr.h"
+#include "esp_amp_env.h"
+#include "esp_amp_platform.h"
+#include "esp_amp_log_ring.h"
+
+#define LOG_RING_RECORD_PAD     0xffff  /* rest of ring until its end is unused */
+#define LOG_RING_ALIGN(len)     (((len) + 3) & ~3)
+
+typedef struct {
+    uint16_t type;
+    uint16_t len;
+    uint8_t data[0];
+} log_ring_record_t;
+
+typedef struct {
+    volatile uint32_t head;     /* offset of next record to write, only written by subcore */
+    volatile uint32_t tail;     /* offset of next record to read, only written by maincore */
+    volatile uint32_t dropped;  /* total size of dropped records, only written by subcore */
+    uint32_t size;              /* size of data in byte, multiple of 4 */
+    uint32_t data[0];           /* keep records word-aligned */
+} log_ring_shm_t;
+
+static log_ring_shm_t *s_log_ring = NULL;
+
+#if IS_MAIN_CORE
+int esp_amp_log_ring_init(void)
+{
+    uint32_t size = CONFIG_ESP_AMP_SUBCORE_LOG_RING_SIZE & ~3;
+    log_ring_shm_t *shm = (log_ring_shm_t *)esp_amp_sys_info_alloc(SYS_INFO_RESERVED_ID_LOG, sizeof(log_ring_shm_t) + size);
+    if (shm == NULL) {
+        return -1;
+    }
+
+    shm->head = 0;
+    shm->tail = 0;
+    shm->dropped = 0;
+    shm->size = size;
+    esp_amp_platform_memory_barrier();
+    s_log_ring = shm;
+    return 0;
+}
+
+int esp_amp_log_ring_drain(esp_amp_log_ring_cb_t cb)
+{
+    log_ring_shm_t *shm = s_log_ring;
+    int num = 0;
+
+    if (shm == NULL) {
+        return 0;
+    }
+
+    uint32_t head = shm->head;
+    uint32_t tail = shm->tail;
+    // make sure records are read after head
+    esp_amp_platform_memory_barrier();
+
+    while (tail != head) {
+        log_ring_record_t *rec = (log_ring_record_t *)((uint8_t *)shm->data + tail);
+        if (rec->type == LOG_RING_RECORD_PAD) {
+            tail = 0;
+        } else {
+            cb(rec->type, rec->data, rec->len);
+            tail += LOG_RING_ALIGN(sizeof(log_ring_record_t) + rec->len);
+            if (tail == shm->size) {
+                tail = 0;
+            }
+            num++;
+        }
+        // make sure record is consumed before its space is released
+        esp_amp_platform_memory_barrier();
+        shm->tail = tail;
+    }
+    return num;
+}
+
+uint32_t esp_amp_log_ring_get_dropped(void)
+{
+    return s_log_ring ? s_log_ring->dropped : 0;
+}
+
+#else /* IS_MAIN_CORE */
+
+int esp_amp_log_ring_init(void)
+{
+    log_ring_shm_t *shm = (log_ring_shm_t *)esp_amp_sys_info_get(SYS_INFO_RESERVED_ID_LOG, NULL);
+    if (shm == NULL) {
+        return -1;
+    }
+    s_log_ring = shm;
+    return 0;
+}
+
+int esp_amp_log_ring_write(uint16_t type, const void *data, uint16_t len)
+{
+    log_ring_shm_t *shm = s_log_ring;
+    uint32_t rec_len = LOG_RING_ALIGN(sizeof(log_ring_record_t) + len);
+    int ret = -1;
+
+    if (shm == NULL) {
+        return -1;
+    }
+
+    esp_amp_env_enter_critical();
+    uint32_t size = shm->size;
+    uint32_t head = shm->head;
+    uint32_t tail = shm->tail;
+
+    /* one word is kept unused to tell full ring from empty ring */
+    uint32_t free_len = (tail > head) ? (tail - head - 4) : (size - head + tail - 4);
+    uint32_t to_end = size - head;
+    uint32_t need_len = (rec_len > to_end) ? (rec_len + to_end) : rec_len;
+
+    if (need_len <= free_len) {
+        if (rec_len > to_end) {
+            /* record does not fit before end of ring, continue from its beginning */
+            ((log_ring_record_t *)((uint8_t *)shm->data + head))->type = LOG_RING_RECORD_PAD;
+            head = 0;
+        }
+        log_ring_record_t *rec = (log_ring_record_t *)((uint8_t *)shm->data + head);
+        rec->type = type;
+        rec->len = len;
+        memcpy(rec->data, data, len);
+        head += rec_len;
+        if (head == size) {
+            head = 0;
+        }
+        // make sure record is written before it is published
+        esp_amp_platform_memory_barrier();
+        shm->head = head;
+        ret = 0;
+    } else {
+        shm->dropped += len;
+    }
+    esp_amp_env_exit_critical();
+
+    if (ret == 0) {
+        esp_amp_sw_intr_trigger(SW_INTR_RESERVED_ID_SYS_SVC);
+    }
+    return ret;
+}
+#endif /* IS_MAIN_CORE */
+
+bool esp_amp_log_ring_is_ready(void)
+{
+    return s_log_ring != NULL;
+}
@@ -27,7 +27,7 @@
 #include "esp_amp_mem_priv.h"
 #include "esp_amp_service.h"
 
-#define PANIC_DUMP_START_ADDR ESP_AMP_SHARED_MEM_END
+#define PANIC_DUMP_START_ADDR ESP_AMP_HP_MEM_END
 #define PANIC_DUMP_MAX_LEN   0x1000
 #define PANIC_DUMP_STACK_OFFSET 0x400
 #define PANIC_DUMP_STACK_SIZE 0x400
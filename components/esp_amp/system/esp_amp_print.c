@@ -7,20 +7,37 @@
 #include "sdkconfig.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/param.h>
+#include "esp_amp_log_ring.h"
 
 #if !IS_MAIN_CORE
-#include <string.h>
 #include "esp_amp_platform.h"
-#include "esp_amp_service.h"
-
 #if CONFIG_ESP_AMP_SUBCORE_TYPE_LP_CORE
 #include "ulp_lp_core_print.h"
 #else
 #include "esp_rom_uart.h"
 #endif /* CONFIG_ESP_AMP_SUBCORE_TYPE_LP_CORE */
+#else
+#include "esp_amp_system_priv.h"
+#endif /* !IS_MAIN_CORE */
+
+/* every argument in binary log record starts at 4-byte boundary */
+#define BINARY_LOG_ALIGN(len) (((len) + 3) & ~3)
+/* longest format string maincore reads from subcore firmware, including '\0' */
+#define BINARY_LOG_FMT_MAX 256
+/* rebuilt conversion spec: '%', flags, width and precision, followed by "ll", conversion and '\0' */
+#define BINARY_LOG_SPEC_MAX 16
+#define BINARY_LOG_SPEC_BODY_MAX (BINARY_LOG_SPEC_MAX - 4)
+
+#if !IS_MAIN_CORE
 
 #define is_digit(c) ((c >= '0') && (c <= '9'))
 
+/* max length of a routed text line or binary log record */
+#define SUBCORE_LOG_LINE_MAX 128
+
 static int _cvt(unsigned long long val, char *buf, long radix, const char *digits)
 {
     char temp[64];
@@ -199,11 +216,13 @@ static int subcore_vprintf(void (*putc)(char c), const char *fmt, va_list ap)
                 break;
             case '%':
                 (*putc)('%');
-                break;
+                res++;
+                continue;
             default:
                 (*putc)('%');
                 (*putc)(c);
                 res += 2;
+                continue;
             }
             pad = left_prec - length;
             right_prec = right_prec - length;
@@ -278,54 +297,184 @@ int esp_amp_subcore_early_printf(const char *format, ...)
 }
 
 #if CONFIG_ESP_AMP_ROUTE_SUBCORE_PRINT
-void __attribute__((alias("virtqueue_send_char"))) subcore_putchar(char c);
-static void virtqueue_send_char(char c)
-{
-    static char* buf = NULL;
-    static uint16_t buf_len = 0;
-    static uint16_t pos = 0;
+/* text line being printed, written to log ring on newline or when it is full */
+static char s_line[SUBCORE_LOG_LINE_MAX];
+static uint16_t s_line_pos = 0;
 
+void __attribute__((alias("log_ring_send_char"))) subcore_putchar(char c);
+static void log_ring_send_char(char c)
+{
     // ignore '\0'
     if (c == '\0') {
         return;
     }
 
-    if (buf == NULL) {
-        if (!esp_amp_system_service_is_ready()) {
-            subcore_uart_putchar(c);
-            return;
+    if (!esp_amp_log_ring_is_ready()) {
+        subcore_uart_putchar(c);
+        return;
+    }
+
+    char *buf = s_line;
+    uint16_t pos = s_line_pos;
+    buf[pos++] = c;
+    if ((pos == SUBCORE_LOG_LINE_MAX - 1) || (c == '\n')) {
+        buf[pos] = '\0';
+        if (pos >= 2 && buf[pos - 2] == '\r' && buf[pos - 1] == '\n') {
+            buf[pos - 2] = '\0';
+            pos -= 2;
+        } else if (pos >= 1 && buf[pos - 1] == '\n') {
+            buf[pos - 1] = '\0';
+            pos -= 1;
         }
+        /* never wait for maincore. if log ring is full, the line is dropped and counted */
+        esp_amp_log_ring_write(LOG_RING_RECORD_TEXT, buf, pos + 1);
+        pos = 0;
+    }
+    s_line_pos = pos;
+}
 
-        /* create buffer, try maximum 10ms */
-        if (esp_amp_system_service_create_request((void **)&buf, &buf_len) != 0) {
-            uint32_t cur_time = esp_amp_platform_get_time_ms();
-            while (esp_amp_platform_get_time_ms() - cur_time < 10) {
-                if (esp_amp_system_service_create_request((void **)&buf, &buf_len) == 0) {
-                    break;
+#if CONFIG_ESP_AMP_SUBCORE_BINARY_LOG
+static bool s_binary_log_enabled = true;
+
+void esp_amp_subcore_binary_log_enable(bool enable)
+{
+    s_binary_log_enabled = enable;
+}
+
+/*
+ * Binary log record: 32-bit address of format string, followed by raw arguments.
+ * Integers take 4 bytes (8 bytes for %ll), strings are copied with terminating '\0'.
+ * Conversions are parsed in the same way as subcore_vprintf(). Formats maincore
+ * cannot rebuild (too long format string or conversion spec) go through text print.
+ */
+static int binary_log_encode(uint8_t *rec, uint16_t max_len, const char *fmt, va_list ap)
+{
+    const char *fmt_start = fmt;
+    uint32_t fmt_addr = (uint32_t)fmt;
+    uint16_t pos = sizeof(uint32_t);
+    char c, last = '\0';
+    int right_prec, islonglong, spec_len;
+
+    memcpy(rec, &fmt_addr, sizeof(uint32_t));
+    while ((c = *fmt++) != '\0') {
+        last = c;
+        if (c != '%') {
+            continue;
+        }
+        const char *spec_start = fmt - 1;
+        c = *fmt++;
+        right_prec = islonglong = 0;
+        if (c == '-') {
+            c = *fmt++;
+        }
+        if (c == '0') {
+            c = *fmt++;
+        }
+        while (is_digit(c)) {
+            c = *fmt++;
+        }
+        if (c == '.') {
+            c = *fmt++;
+            while (is_digit(c)) {
+                right_prec = (right_prec * 10) + (c - '0');
+                c = *fmt++;
+            }
+        }
+        /* '%' up to and excluding the current char */
+        spec_len = fmt - 1 - spec_start;
+        if (spec_len > BINARY_LOG_SPEC_BODY_MAX) {
+            return -1;
+        }
+        if (c == 'l') {
+            c = *fmt++;
+            if (c == 'l') {
+                c = *fmt++;
+                islonglong = 1;
+            }
+        }
+        switch (c) {
+        case 'p':
+        case 'd':
+        case 'D':
+        case 'x':
+        case 'X':
+        case 'u':
+        case 'U':
+            if (islonglong) {
+                if (pos + sizeof(long long) > max_len) {
+                    return -1;
                 }
+                long long val = va_arg(ap, long long);
+                memcpy(&rec[pos], &val, sizeof(long long));
+                pos += sizeof(long long);
+                break;
+            }
+        /* fall through */
+        case 'c':
+        case 'C': {
+            /* int and long are both 32-bit on subcore */
+            if (pos + sizeof(uint32_t) > max_len) {
+                return -1;
             }
+            uint32_t val = (uint32_t)va_arg(ap, int);
+            memcpy(&rec[pos], &val, sizeof(uint32_t));
+            pos += sizeof(uint32_t);
+            break;
         }
-
-        /* if still failed, drop the log */
-        if (buf == NULL) {
-            return;
+        case 's':
+        case 'S': {
+            const char *str = va_arg(ap, char *);
+            if (str == NULL) {
+                str = "<null>";
+            }
+            int length = strlen(str);
+            if (right_prec) {
+                length = MIN(right_prec, length);
+            }
+            if (pos + length + 1 > max_len) {
+                return -1;
+            }
+            memcpy(&rec[pos], str, length);
+            rec[pos + length] = '\0';
+            pos += BINARY_LOG_ALIGN(length + 1);
+            break;
+        }
+        case '%':
+            break;
+        default:
+            /* %b, %B and unknown conversions are only supported by text print */
+            return -1;
         }
     }
 
-    buf[pos++] = c;
-    if ((pos == buf_len - 1) || (c == '\n')) {
-        buf[pos] = '\0';
-        if (pos >= 1 && buf[pos - 1] == '\n') {
-            buf[pos - 1] = '\0';
-        } else if (pos >= 2 && buf[pos - 2] == '\r' && buf[pos - 1] == '\n') {
-            buf[pos - 2] = '\0';
-        }
-        esp_amp_system_service_send_request(SYSTEM_SERVICE_ID_PRINT, buf, pos + 1);
-        // release the sent buf
-        buf = NULL;
-        pos = 0;
+    /* supplicant prints one line per request, partial lines go through text print */
+    if (last != '\n') {
+        return -1;
     }
+    /* `fmt` is past '\0' now */
+    if (fmt - fmt_start > BINARY_LOG_FMT_MAX) {
+        return -1;
+    }
+    return MIN(pos, max_len);
 }
+
+static int log_ring_send_binary(const char *fmt, va_list ap)
+{
+    /* keep the order with a partially printed text line by staying on text print */
+    if (!s_binary_log_enabled || s_line_pos != 0 || !esp_amp_log_ring_is_ready()) {
+        return -1;
+    }
+
+    uint32_t rec[SUBCORE_LOG_LINE_MAX / sizeof(uint32_t)];
+    int len = binary_log_encode((uint8_t *)rec, sizeof(rec), fmt, ap);
+    if (len < 0) {
+        return -1;
+    }
+
+    esp_amp_log_ring_write(LOG_RING_RECORD_BINARY, rec, len);
+    return len;
+}
+#endif /* CONFIG_ESP_AMP_SUBCORE_BINARY_LOG */
 #else
 #if CONFIG_ESP_AMP_SUBCORE_TYPE_LP_CORE
 
@@ -349,7 +498,17 @@ int esp_amp_subcore_printf(const char *format, ...)
     va_start(args, format);
 
     int prt_bytes;
+#if CONFIG_ESP_AMP_SUBCORE_BINARY_LOG
+    va_list args_copy;
+    va_copy(args_copy, args);
+    prt_bytes = log_ring_send_binary(format, args_copy);
+    va_end(args_copy);
+    if (prt_bytes < 0) {
+        prt_bytes = subcore_vprintf(subcore_putchar, format, args);
+    }
+#else
     prt_bytes = subcore_vprintf(subcore_putchar, format, args);
+#endif
     va_end(args);
 
     return prt_bytes;
@@ -372,11 +531,226 @@ int esp_amp_subcore_putchar(int ch)
 
 #else /* !IS_MAIN_CORE */
 #if CONFIG_ESP_AMP_ROUTE_SUBCORE_PRINT
-#include "stdio.h"
+#if CONFIG_ESP_AMP_SUBCORE_BINARY_LOG
+#define BINARY_LOG_LINE_MAX 256
+
+/* return length of format string in subcore firmware, 0 if it is invalid */
+static size_t binary_log_fmt_len(const char *fmt)
+{
+    for (size_t i = 0; i < BINARY_LOG_FMT_MAX; i++) {
+        if (!esp_amp_system_is_subcore_app_addr((intptr_t)&fmt[i])) {
+            break;
+        }
+        if (fmt[i] == '\0') {
+            return i;
+        }
+    }
+    return 0;
+}
+
+/* copy width or precision digits into `spec`, false if the spec gets too long */
+static bool binary_log_spec_digits(const char *fmt, size_t *i, char *spec, size_t *n)
+{
+    while (fmt[*i] >= '0' && fmt[*i] <= '9') {
+        if (*n >= BINARY_LOG_SPEC_BODY_MAX) {
+            return false;
+        }
+        spec[(*n)++] = fmt[(*i)++];
+    }
+    return true;
+}
+
+static void binary_log_append(char *line, size_t size, size_t *pos, const char *spec, ...)
+{
+    va_list args;
+    va_start(args, spec);
+    int ret = vsnprintf(line + *pos, size - *pos, spec, args);
+    va_end(args);
+    if (ret > 0) {
+        *pos = MIN(*pos + ret, size - 1);
+    }
+}
+
+int esp_amp_system_binary_log_decode(const void *param, uint16_t param_len, char *line, size_t size)
+{
+    const uint8_t *rec = (const uint8_t *)param;
+    uint32_t fmt_addr = 0;
+
+    if (param_len >= sizeof(uint32_t)) {
+        memcpy(&fmt_addr, rec, sizeof(uint32_t));
+    }
+
+    /* format string is read from subcore firmware, reject anything outside of it */
+    const char *fmt = (const char *)fmt_addr;
+    size_t fmt_len = param_len >= sizeof(uint32_t) ? binary_log_fmt_len(fmt) : 0;
+    if (fmt_len == 0) {
+        snprintf(line, size, "<invalid subcore log format at 0x%08" PRIx32 ">", fmt_addr);
+        return -1;
+    }
+
+    char spec[BINARY_LOG_SPEC_MAX];
+    size_t pos = 0;
+    uint16_t arg = sizeof(uint32_t);
+    size_t i = 0;
+
+    while (i < fmt_len && pos < size - 1) {
+        char c = fmt[i++];
+        if (c != '%') {
+            line[pos++] = c;
+            continue;
+        }
+
+        /* rebuild conversion spec, same syntax as subcore_vprintf(). Subcore sends longer
+         * specs as text, so one here means the record does not match its format */
+        size_t n = 0, n_prec;
+        int islong = 0, islonglong = 0;
+        bool spec_ok;
+        spec[n++] = '%';
+        if (fmt[i] == '-') {
+            spec[n++] = fmt[i++];
+        }
+        if (fmt[i] == '0') {
+            spec[n++] = fmt[i++];
+        }
+        spec_ok = binary_log_spec_digits(fmt, &i, spec, &n);
+        n_prec = n;
+        if (spec_ok && fmt[i] == '.') {
+            if (n < BINARY_LOG_SPEC_BODY_MAX) {
+                spec[n++] = fmt[i++];
+                spec_ok = binary_log_spec_digits(fmt, &i, spec, &n);
+            } else {
+                spec_ok = false;
+            }
+        }
+        if (!spec_ok) {
+            snprintf(line, size, "<invalid subcore log format at 0x%08" PRIx32 ">", fmt_addr);
+            return -1;
+        }
+        if (fmt[i] == 'l') {
+            i++;
+            islong = 1;
+            if (fmt[i] == 'l') {
+                i++;
+                islonglong = 1;
+                islong = 0;
+            }
+        }
+
+        c = fmt[i++];
+        if (c == '%') {
+            line[pos++] = '%';
+            continue;
+        }
 
-void esp_amp_system_service_print(void *param, uint16_t param_len)
+        uint16_t arg_len = (c == 's' || c == 'S') ? 1 : (islonglong ? sizeof(uint64_t) : sizeof(uint32_t));
+        if (arg + arg_len > param_len) {
+            /* record was cut off or is malformed */
+            break;
+        }
+
+        switch (c) {
+        case 'p': {
+            uint32_t val;
+            memcpy(&val, &rec[arg], sizeof(uint32_t));
+            binary_log_append(line, size, &pos, "0x%08" PRIx32, val);
+            break;
+        }
+        case 'd':
+        case 'D':
+        case 'u':
+        case 'U':
+        case 'x':
+        case 'X':
+            if (islonglong) {
+                spec[n++] = 'l';
+                spec[n++] = 'l';
+            } else if (islong) {
+                spec[n++] = 'l';
+            }
+            spec[n++] = (c == 'D' || c == 'U') ? c + ('a' - 'A') : c;
+            spec[n] = '\0';
+            if (islonglong) {
+                long long val;
+                memcpy(&val, &rec[arg], sizeof(long long));
+                binary_log_append(line, size, &pos, spec, val);
+            } else {
+                int32_t val;
+                memcpy(&val, &rec[arg], sizeof(int32_t));
+                if (islong) {
+                    binary_log_append(line, size, &pos, spec, (long)val);
+                } else {
+                    binary_log_append(line, size, &pos, spec, (int)val);
+                }
+            }
+            break;
+        case 'c':
+        case 'C': {
+            int32_t val;
+            memcpy(&val, &rec[arg], sizeof(int32_t));
+            line[pos++] = (char)val;
+            break;
+        }
+        case 's':
+        case 'S': {
+            /* string has been cut to precision on subcore */
+            size_t str_len = strnlen((char *)&rec[arg], param_len - arg);
+            if (arg + str_len >= param_len) {
+                arg = param_len;
+                break;
+            }
+            spec[n_prec] = 's';
+            spec[n_prec + 1] = '\0';
+            binary_log_append(line, size, &pos, spec, (char *)&rec[arg]);
+            arg_len = BINARY_LOG_ALIGN(str_len + 1);
+            break;
+        }
+        default:
+            arg_len = 0;
+            break;
+        }
+        arg += arg_len;
+    }
+    /* supplicant prints one line per request, same as text print */
+    if (pos >= 2 && line[pos - 2] == '\r' && line[pos - 1] == '\n') {
+        pos -= 2;
+    } else if (pos >= 1 && line[pos - 1] == '\n') {
+        pos -= 1;
+    }
+    line[pos] = '\0';
+    return pos;
+}
+#endif /* CONFIG_ESP_AMP_SUBCORE_BINARY_LOG */
+
+static void print_log_record(uint16_t type, void *data, uint16_t len)
 {
-    puts((char *)param);
+    switch (type) {
+    case LOG_RING_RECORD_TEXT:
+        printf("%.*s\n", (int)len, (char *)data);
+        break;
+#if CONFIG_ESP_AMP_SUBCORE_BINARY_LOG
+    case LOG_RING_RECORD_BINARY: {
+        char line[BINARY_LOG_LINE_MAX];
+        esp_amp_system_binary_log_decode(data, len, line, sizeof(line));
+        puts(line);
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+}
+
+void esp_amp_system_print_drain(void)
+{
+    static uint32_t s_dropped = 0;
+
+    esp_amp_log_ring_drain(print_log_record);
+
+    uint32_t dropped = esp_amp_log_ring_get_dropped();
+    if (dropped != s_dropped) {
+        printf("<subcore log: %" PRIu32 " bytes dropped>\n", dropped - s_dropped);
+        s_dropped = dropped;
+    }
 }
 
 #endif /* CONFIG_ESP_AMP_ROUTE_SUBCORE_PRINT */
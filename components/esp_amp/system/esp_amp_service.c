@@ -14,15 +14,24 @@
 #include "esp_amp_sw_intr.h"
 
 #include "esp_amp_env.h"
+#include "esp_amp_arch.h"
 #include "esp_amp_system.h"
 #include "esp_amp_service.h"
+#include "esp_amp_log_ring.h"
+#include "esp_amp_file_proxy.h"
 
 static bool s_system_service_ready = false;
 
+#if IS_MAIN_CORE
+static TaskHandle_t supplicant_daemon = NULL;
+#endif
+
+#if CONFIG_ESP_AMP_SYSTEM_ENABLE_SUPPLICANT
 #define SERVICE_QUEUE_LEN 16
 #define SERVICE_QUEUE_ITEM_SIZE 128
-#define SERVICE_DAEMON_STACK_SIZE 2048
+#define SERVICE_DAEMON_STACK_SIZE CONFIG_ESP_AMP_SYSTEM_SUPPLICANT_STACK_SIZE
 #define SERVICE_DAEMON_PRIORITY 1
+#define SERVICE_DRAIN_BATCH 8
 
 typedef struct {
     uint16_t srv_id;
@@ -35,7 +44,15 @@ static esp_amp_queue_t service_queue;
 #if IS_MAIN_CORE
 static StaticTask_t daemon_task_stg;
 static StackType_t daemon_task_stack[SERVICE_DAEMON_STACK_SIZE];
-static TaskHandle_t supplicant_daemon = NULL;
+
+typedef struct {
+    esp_amp_system_service_handler_t handler;
+    void *arg;
+    esp_amp_system_service_stats_t stats;
+} srv_entry_t;
+
+/* indexed by service id */
+static srv_entry_t s_srv_tbl[CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN];
 
 static inline void handle_subcore_panic(void)
 {
@@ -46,36 +63,123 @@ static inline void handle_subcore_panic(void)
     }
 }
 
+static void dispatch_request(srv_pkt_hdr_t *pkt)
+{
+    srv_entry_t *entry = &s_srv_tbl[pkt->srv_id];
+
+    esp_amp_env_enter_critical();
+    esp_amp_system_service_handler_t handler = entry->handler;
+    void *arg = entry->arg;
+    esp_amp_env_exit_critical();
+
+    if (handler == NULL) {
+        entry->stats.unhandled_num++;
+        return;
+    }
+
+    uint32_t start = (uint32_t)esp_amp_arch_get_cpu_cycle();
+    handler(pkt->param, pkt->param_len, arg);
+    uint32_t cycles = (uint32_t)esp_amp_arch_get_cpu_cycle() - start;
+
+    entry->stats.req_num++;
+    entry->stats.req_bytes += pkt->param_len;
+    if (cycles > entry->stats.max_cycles) {
+        entry->stats.max_cycles = cycles;
+    }
+}
+
 static void supplicant_task(void *args)
 {
     (void)args;
-    uint16_t srv_id;
-    void *param;
-    uint16_t param_len;
+    srv_pkt_hdr_t *batch[SERVICE_DRAIN_BATCH];
+    uint16_t pkt_len;
 
     while (1) {
         xTaskNotifyWait(0, 0, NULL, portMAX_DELAY);
         /* first check subcore panic */
         handle_subcore_panic();
 
-        /* then check if there is any pending remote service */
-        while (esp_amp_system_service_recv_request(&srv_id, &param, &param_len) == 0) {
-            switch (srv_id) {
-#if CONFIG_ESP_AMP_ROUTE_SUBCORE_PRINT
-            case SYSTEM_SERVICE_ID_PRINT:
-                extern void esp_amp_system_service_print(void *param, uint16_t param_len);
-                esp_amp_system_service_print(param, param_len);
-                break;
-#endif
-            default:
+        /* then handle pending remote services, in batches to enter critical section less often */
+        while (1) {
+            int num = 0;
+            esp_amp_env_enter_critical();
+            while (num < SERVICE_DRAIN_BATCH && esp_amp_queue_recv_try(&service_queue, (void **)&batch[num], &pkt_len) == 0) {
+                num++;
+            }
+            esp_amp_env_exit_critical();
+            if (num == 0) {
                 break;
             }
-            esp_amp_system_service_destroy_request(param);
+
+            for (int i = 0; i < num; i++) {
+                /* subcore rejects out-of-range id, check again in case of corrupted request */
+                if (batch[i]->srv_id < CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN) {
+                    dispatch_request(batch[i]);
+                }
+            }
+
+            esp_amp_env_enter_critical();
+            for (int i = 0; i < num; i++) {
+                esp_amp_queue_free_try(&service_queue, (void *)batch[i]);
+            }
+            esp_amp_env_exit_critical();
 
             /* always check subcore panic to mitigate priority inversion */
             handle_subcore_panic();
         }
+
+#if CONFIG_ESP_AMP_ROUTE_SUBCORE_PRINT
+        /* print all lines in subcore log ring */
+        extern void esp_amp_system_print_drain(void);
+        esp_amp_system_print_drain();
+#endif
+    }
+}
+
+int esp_amp_system_service_register(uint16_t id, esp_amp_system_service_handler_t handler, void *arg)
+{
+    if (id >= CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN || handler == NULL) {
+        return -1;
+    }
+
+    int ret = -1;
+    esp_amp_env_enter_critical();
+    if (s_srv_tbl[id].handler == NULL) {
+        s_srv_tbl[id].handler = handler;
+        s_srv_tbl[id].arg = arg;
+        ret = 0;
+    }
+    esp_amp_env_exit_critical();
+    return ret;
+}
+
+int esp_amp_system_service_unregister(uint16_t id)
+{
+    if (id >= CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN) {
+        return -1;
+    }
+
+    int ret = -1;
+    esp_amp_env_enter_critical();
+    if (s_srv_tbl[id].handler != NULL) {
+        s_srv_tbl[id].handler = NULL;
+        s_srv_tbl[id].arg = NULL;
+        ret = 0;
+    }
+    esp_amp_env_exit_critical();
+    return ret;
+}
+
+int esp_amp_system_service_get_stats(uint16_t id, esp_amp_system_service_stats_t *stats)
+{
+    if (id >= CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN || stats == NULL) {
+        return -1;
     }
+
+    esp_amp_env_enter_critical();
+    *stats = s_srv_tbl[id].stats;
+    esp_amp_env_exit_critical();
+    return 0;
 }
 
 int esp_amp_system_service_recv_request(uint16_t *id, void** param, uint16_t *param_len)
@@ -106,11 +210,6 @@ int esp_amp_system_service_destroy_request(void* buf)
     return ret;
 }
 
-void *esp_amp_system_get_supplicant(void)
-{
-    return (void *)supplicant_daemon;
-}
-
 #else /* IS_MAIN_CORE */
 
 int esp_amp_system_service_create_request(void **buf, uint16_t *max_len)
@@ -119,6 +218,10 @@ int esp_amp_system_service_create_request(void **buf, uint16_t *max_len)
     *max_len = 0;
     void *__buf;
 
+    if (!s_system_service_ready) {
+        return -1;
+    }
+
     esp_amp_env_enter_critical();
     int ret = esp_amp_queue_alloc_try(&service_queue, &__buf, SERVICE_QUEUE_ITEM_SIZE);
     esp_amp_env_exit_critical();
@@ -137,13 +240,18 @@ int esp_amp_system_service_create_request(void **buf, uint16_t *max_len)
 int esp_amp_system_service_send_request(uint16_t id, void* param, uint16_t param_len)
 {
     srv_pkt_hdr_t *pkt = (srv_pkt_hdr_t *)((uint8_t *)param - offsetof(srv_pkt_hdr_t, param));
-    pkt->srv_id = id;
-    pkt->param_len = param_len;
+    bool valid = (id < CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN && param_len <= SERVICE_QUEUE_ITEM_SIZE - sizeof(srv_pkt_hdr_t));
+
+    /* request can't be freed on subcore. invalid one is still sent with id 0xffff and ignored by maincore */
+    if (valid) {
+        pkt->srv_id = id;
+        pkt->param_len = param_len;
+    }
 
     esp_amp_env_enter_critical();
     int ret = esp_amp_queue_send_try(&service_queue, (void *)pkt, SERVICE_QUEUE_ITEM_SIZE);
     esp_amp_env_exit_critical();
-    if (ret != 0) {
+    if (ret != 0 || !valid) {
         return -1;
     }
     return 0;
@@ -185,9 +293,55 @@ int esp_amp_system_service_init(void)
     assert(esp_amp_queue_sub_init(&service_queue, notify_cb, NULL, true, SYS_INFO_RESERVED_ID_SYSTEM) == 0);
 #endif
 
+#if CONFIG_ESP_AMP_ROUTE_SUBCORE_PRINT
+    assert(esp_amp_log_ring_init() == 0);
+#endif
+
+#if CONFIG_ESP_AMP_SUBCORE_FILE_PROXY
+    assert(esp_amp_file_proxy_init() == 0);
+#endif
+
     s_system_service_ready = true;
     return 0;
 }
+#else
+/* service table only exists with supplicant, nobody would handle requests without it */
+#if IS_MAIN_CORE
+int esp_amp_system_service_register(uint16_t id, esp_amp_system_service_handler_t handler, void *arg)
+{
+    return -1;
+}
+
+int esp_amp_system_service_unregister(uint16_t id)
+{
+    return -1;
+}
+
+int esp_amp_system_service_get_stats(uint16_t id, esp_amp_system_service_stats_t *stats)
+{
+    return -1;
+}
+#else
+int esp_amp_system_service_create_request(void **buf, uint16_t *max_len)
+{
+    *buf = NULL;
+    *max_len = 0;
+    return -1;
+}
+
+int esp_amp_system_service_send_request(uint16_t id, void* param, uint16_t param_len)
+{
+    return -1;
+}
+#endif /* IS_MAIN_CORE */
+#endif /* CONFIG_ESP_AMP_SYSTEM_ENABLE_SUPPLICANT */
+
+#if IS_MAIN_CORE
+void *esp_amp_system_get_supplicant(void)
+{
+    return (void *)supplicant_daemon;
+}
+#endif
 
 bool esp_amp_system_service_is_ready(void)
 {
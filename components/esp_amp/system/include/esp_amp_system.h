@@ -6,8 +6,10 @@
 
 #pragma once
 
-#if IS_MAIN_CORE
 #include "stdbool.h"
+#include "stdint.h"
+
+#if IS_MAIN_CORE
 #include "esp_err.h"
 #include "esp_partition.h"
 #endif
@@ -16,6 +18,9 @@
 extern "C" {
 #endif
 
+/* system service id reserved for subcore file proxy if CONFIG_ESP_AMP_SUBCORE_FILE_PROXY is enabled */
+#define ESP_AMP_SYSTEM_SERVICE_ID_FILE_PROXY 0
+
 #if IS_MAIN_CORE
 /**
  * Load the program binary from partition
@@ -70,6 +75,129 @@ bool esp_amp_subcore_panic(void);
  * @brief default handler for subcore panic
  */
 void esp_amp_subcore_panic_handler_default(void);
+
+/**
+ * System service handler
+ *
+ * Called in subcore supplicant task for each request sent by subcore with the registered id.
+ *
+ * @param param request data, only valid until the handler returns
+ * @param param_len length of request data
+ * @param arg arg registered with the handler
+ */
+typedef void (*esp_amp_system_service_handler_t)(void *param, uint16_t param_len, void *arg);
+
+/**
+ * Statistics of a system service
+ */
+typedef struct {
+    uint32_t req_num;       /* number of requests handled */
+    uint32_t req_bytes;     /* total length of data of handled requests in byte */
+    uint32_t unhandled_num; /* number of requests received while no handler is registered */
+    uint32_t max_cycles;    /* longest execution time of the handler in CPU cycles */
+} esp_amp_system_service_stats_t;
+
+/**
+ * Register a handler for system service requests sent by subcore
+ *
+ * @note requires CONFIG_ESP_AMP_SYSTEM_ENABLE_SUPPLICANT
+ *
+ * @param id service id, less than CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN
+ * @param handler handler of the service
+ * @param arg arg to be passed to handler
+ *
+ * @retval 0 if successful
+ * @retval -1 invalid id or handler, or a handler is already registered for the id
+ */
+int esp_amp_system_service_register(uint16_t id, esp_amp_system_service_handler_t handler, void *arg);
+
+/**
+ * Unregister the handler of a system service
+ *
+ * @param id service id
+ *
+ * @retval 0 if successful
+ * @retval -1 invalid id or no handler is registered for the id
+ */
+int esp_amp_system_service_unregister(uint16_t id);
+
+/**
+ * Get statistics of a system service
+ *
+ * @param id service id
+ * @param stats pointer to store the statistics
+ *
+ * @retval 0 if successful
+ * @retval -1 invalid id or stats
+ */
+int esp_amp_system_service_get_stats(uint16_t id, esp_amp_system_service_stats_t *stats);
+#else
+/**
+ * Create a system service request
+ *
+ * @note requires CONFIG_ESP_AMP_SYSTEM_ENABLE_SUPPLICANT. A created request can only be given back
+ * by sending it, there is no way to cancel it on subcore.
+ *
+ * @param buf pointer to store the buffer of request data
+ * @param max_len pointer to store the maximum length of request data
+ *
+ * @retval 0 if successful
+ * @retval -1 system service not ready or no free request
+ */
+int esp_amp_system_service_create_request(void **buf, uint16_t *max_len);
+
+/**
+ * Send a system service request to maincore
+ *
+ * Request is handled by the handler registered with esp_amp_system_service_register() on maincore.
+ *
+ * @param id service id, less than CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN
+ * @param param buffer of request data got from esp_amp_system_service_create_request()
+ * @param param_len length of request data
+ *
+ * @retval 0 if successful
+ * @retval -1 invalid id or param_len, or failed to send. Request is given back anyway
+ */
+int esp_amp_system_service_send_request(uint16_t id, void* param, uint16_t param_len);
+
+/**
+ * Enable or disable binary log of subcore printf at runtime
+ *
+ * @note only available when CONFIG_ESP_AMP_SUBCORE_BINARY_LOG is enabled.
+ * Binary log is enabled by default.
+ *
+ * @param enable true to send format string address and raw arguments, false to send formatted text
+ */
+void esp_amp_subcore_binary_log_enable(bool enable);
+
+/**
+ * Write data batched by subcore file proxy to files on maincore
+ *
+ * @note only available when CONFIG_ESP_AMP_SUBCORE_FILE_PROXY is enabled. Small writes to
+ * the same file are kept in shared memory until the buffer is full, or another file operation
+ * is made, or this function is called.
+ *
+ * @retval 0 if successful
+ * @retval -1 batched data of any file failed to be written, errno is set to the first error.
+ *            Failed data is dropped, and errors reported here are not reported by write or close
+ */
+int esp_amp_subcore_file_flush(void);
+
+/**
+ * Read from file into shared memory without copying it to subcore buffer
+ *
+ * @note only available when CONFIG_ESP_AMP_SUBCORE_FILE_PROXY is enabled. Data is read by
+ * maincore into file proxy buffer in shared memory, and is only valid until the next file
+ * operation on subcore.
+ *
+ * @param fd file descriptor opened on subcore
+ * @param len maximum length to read, clamped to CONFIG_ESP_AMP_SUBCORE_FILE_PROXY_BUF_SIZE
+ * @param data pointer to store the address of read data
+ *
+ * @retval length of read data, 0 at end of file
+ * @retval -1 if failed, errno is set
+ */
+int esp_amp_subcore_file_read_shared(int fd, uint16_t len, const void **data);
 #endif
 
 /**
@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * File proxy forwards newlib file syscalls of subcore to maincore VFS. Each syscall is
+ * sent as a system service request with id ESP_AMP_SYSTEM_SERVICE_ID_FILE_PROXY, and file
+ * data is exchanged through a buffer in shared memory. Subcore has at most one request in
+ * flight and waits until maincore marks it as done, or fails it with EIO after
+ * CONFIG_ESP_AMP_SUBCORE_FILE_PROXY_TIMEOUT_MS.
+ */
+
+/**
+ * Create file proxy channel and register its service handler on maincore, or get file
+ * proxy channel created by maincore on subcore
+ *
+ * @retval 0 if successful
+ * @retval -1 if failed
+ */
+int esp_amp_file_proxy_init(void);
+
+/**
+ * Check if file proxy is initialized
+ *
+ * @retval true if file proxy is ready
+ * @retval false if not
+ */
+bool esp_amp_file_proxy_is_ready(void);
+
+#ifdef __cplusplus
+}
+#endif
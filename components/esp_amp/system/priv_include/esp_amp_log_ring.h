@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* type of records in log ring */
+#define LOG_RING_RECORD_TEXT    0x0001  /* '\0'-terminated line */
+#define LOG_RING_RECORD_BINARY  0x0002  /* format string address followed by raw arguments */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Log ring is a single-producer single-consumer ring of variable-length records in
+ * shared memory. Subcore is the only writer of the head and maincore is the only writer
+ * of the tail, so no atomic read-modify-write is needed and the ring can be placed in
+ * LP RAM. Writing never waits for maincore: record not fitting into free space is dropped
+ * and its size is accounted.
+ */
+
+/**
+ * Create log ring on maincore, or get log ring created by maincore on subcore
+ *
+ * @retval 0 if successful
+ * @retval -1 if failed
+ */
+int esp_amp_log_ring_init(void);
+
+/**
+ * Check if log ring is initialized
+ *
+ * @retval true if log ring is ready
+ * @retval false if not
+ */
+bool esp_amp_log_ring_is_ready(void);
+
+#if !IS_MAIN_CORE
+/**
+ * Write a record to log ring and notify subcore supplicant
+ *
+ * @note can only be called in subcore
+ *
+ * @param type record type
+ * @param data record data
+ * @param len length of record data
+ *
+ * @retval 0 if successful
+ * @retval -1 log ring not ready or not enough space. Record is dropped
+ */
+int esp_amp_log_ring_write(uint16_t type, const void *data, uint16_t len);
+
+#else
+
+/**
+ * Callback to handle a record in log ring
+ *
+ * @param type record type
+ * @param data record data in shared memory, only valid inside the callback
+ * @param len length of record data
+ */
+typedef void (*esp_amp_log_ring_cb_t)(uint16_t type, void *data, uint16_t len);
+
+/**
+ * Handle all records in log ring
+ *
+ * @note can only be called in maincore
+ *
+ * @param cb callback invoked on each record in order
+ *
+ * @retval number of records handled
+ */
+int esp_amp_log_ring_drain(esp_amp_log_ring_cb_t cb);
+
+/**
+ * Get total size of records dropped by subcore since log ring is created
+ *
+ * @note can only be called in maincore
+ *
+ * @retval dropped size in byte
+ */
+uint32_t esp_amp_log_ring_get_dropped(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
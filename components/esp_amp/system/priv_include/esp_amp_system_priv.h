@@ -6,6 +6,12 @@
 
 #pragma once
 
+#if IS_MAIN_CORE
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -19,6 +25,31 @@ extern "C" {
  */
 int esp_amp_system_panic_init(void);
 
+/**
+ * Check if address belongs to subcore firmware loaded in memory
+ *
+ * @param addr address to check
+ *
+ * @retval true if address is inside loaded subcore firmware
+ * @retval false if not
+ */
+bool esp_amp_system_is_subcore_app_addr(intptr_t addr);
+
+/**
+ * Format a binary log record from subcore into a line of text
+ *
+ * @note only available when CONFIG_ESP_AMP_SUBCORE_BINARY_LOG is enabled
+ *
+ * @param param binary log record read from log ring
+ * @param param_len length of record in bytes
+ * @param line buffer to store the line, without trailing newline
+ * @param size size of `line` in bytes
+ *
+ * @retval length of the line
+ * @retval -1 if format string is invalid, `line` then holds an error message
+ */
+int esp_amp_system_binary_log_decode(const void *param, uint16_t param_len, char *line, size_t size);
+
 #endif
 
 #ifdef __cplusplus
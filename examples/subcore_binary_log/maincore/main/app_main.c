@@ -0,0 +1,35 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_amp.h"
+
+#include "event.h"
+
+#define TAG "app_main"
+
+void app_main(void)
+{
+    assert(esp_amp_init() == 0);
+
+    /* Load firmware & start subcore */
+    const esp_partition_t *sub_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, 0x40, NULL);
+    ESP_ERROR_CHECK(esp_amp_load_sub_from_partition(sub_partition));
+    ESP_ERROR_CHECK(esp_amp_start_subcore());
+
+    /* subcore log lines are printed by subcore supplicant */
+    if ((esp_amp_event_wait(EVENT_SUBCORE_DONE, true, true, 10000) & EVENT_SUBCORE_DONE) == 0) {
+        ESP_LOGE(TAG, "subcore did not finish in time");
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));
+    printf("Main: done\n");
+}
@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "esp_amp_platform.h"
+#include "esp_amp.h"
+
+#include "event.h"
+
+#define LOG_LINE_NUM 32
+
+static uint32_t measure_cycles_per_line(void)
+{
+    uint64_t total_cycles = 0;
+    uint32_t sensor_val = 0x1234;
+
+    for (int i = 0; i < LOG_LINE_NUM; i++) {
+        uint64_t start = esp_amp_arch_get_cpu_cycle();
+        printf("SUB: sample %d from %s, raw=0x%08" PRIx32 ", temp=%d.%02d C\n", i, "lp_adc", sensor_val, 25 + i % 3, i * 7 % 100);
+        total_cycles += esp_amp_arch_get_cpu_cycle() - start;
+        sensor_val += 0x101;
+
+        /* let supplicant drain log ring, so that no line is dropped */
+        esp_amp_platform_delay_ms(20);
+    }
+    return (uint32_t)(total_cycles / LOG_LINE_NUM);
+}
+
+int main(void)
+{
+    assert(esp_amp_init() == 0);
+
+    esp_amp_subcore_binary_log_enable(false);
+    uint32_t text_cycles = measure_cycles_per_line();
+
+    esp_amp_subcore_binary_log_enable(true);
+    uint32_t binary_cycles = measure_cycles_per_line();
+
+    esp_amp_subcore_binary_log_enable(false);
+    printf("SUB: text log: %" PRIu32 " cycles/line\n", text_cycles);
+    printf("SUB: binary log: %" PRIu32 " cycles/line\n", binary_cycles);
+
+    esp_amp_event_notify(EVENT_SUBCORE_DONE);
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_amp.h"
+#include "esp_err.h"
+#include "stdatomic.h"
+
+/* white-box test of binary log records behind routed subcore print */
+#include "esp_amp_service.h"
+#include "esp_amp_log_ring.h"
+#include "esp_amp_system_priv.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+extern const uint8_t subcore_binary_log_test_bin_start[] asm("_binary_subcore_test_binary_log_bin_start");
+extern const uint8_t subcore_binary_log_test_bin_end[]   asm("_binary_subcore_test_binary_log_bin_end");
+
+#define SYS_INFO_ID_TEST_LOG_SYNC 0x0107
+#define EVENT_SUBCORE_DONE        (1 << 0)
+
+#define TEST_STR_10   "0123456789"
+#define TEST_STR_100  TEST_STR_10 TEST_STR_10 TEST_STR_10 TEST_STR_10 TEST_STR_10 \
+                      TEST_STR_10 TEST_STR_10 TEST_STR_10 TEST_STR_10 TEST_STR_10
+#define TEST_STR_LONG TEST_STR_100 TEST_STR_100 TEST_STR_100
+
+#define TEST_RECORD_MAX  128 /* max length of a routed text line or binary log record */
+#define TEST_RECORD_NUM  16
+#define TEST_LONG_REC_NUM 3  /* text records the long line is split into */
+#define TEST_CUT_LEN     8   /* format address and first argument */
+
+/* each line is printed with binary log enabled, then with text print */
+static const struct {
+    uint16_t type; /* record type of the line printed with binary log enabled */
+    const char *line;
+} s_pairs[] = {
+    { LOG_RING_RECORD_BINARY, "spec: [-42   ] [00beef] [     7] [abc] [   ab] [-0003]" },
+    { LOG_RING_RECORD_BINARY, "ll: -1234567890123 18446744073709551615 123456789abcdef deadbeef -5" },
+    { LOG_RING_RECORD_BINARY, "str abc, chr Az, pct 100%, ptr 0x4ff12345" },
+    { LOG_RING_RECORD_BINARY, "prec [abc]" },
+    { LOG_RING_RECORD_TEXT,   "long prec [abc]" },
+    { LOG_RING_RECORD_BINARY, "cut 1 middle 2 end" },
+};
+#define TEST_PAIR_NUM    (int)(sizeof(s_pairs) / sizeof(s_pairs[0]))
+#define TEST_PAIR_CUT    (TEST_PAIR_NUM - 1)
+
+static struct {
+    struct {
+        uint16_t type;
+        uint16_t len;
+        uint8_t data[TEST_RECORD_MAX];
+        char line[TEST_RECORD_MAX];
+    } rec[TEST_RECORD_NUM];
+    int num;
+    int bad_num;
+} s_rx;
+
+static void log_record_cb(uint16_t type, void *data, uint16_t len)
+{
+    char line[TEST_RECORD_MAX];
+
+    if (len > TEST_RECORD_MAX) {
+        s_rx.bad_num++;
+        return;
+    }
+    if (type == LOG_RING_RECORD_BINARY) {
+        if (esp_amp_system_binary_log_decode(data, len, line, sizeof(line)) < 0) {
+            s_rx.bad_num++;
+            return;
+        }
+    } else {
+        snprintf(line, sizeof(line), "%.*s", (int)len, (char *)data);
+    }
+
+    /* lines printed before the test starts are not counted */
+    if (strncmp(line, "Hello", 5) == 0) {
+        return;
+    }
+    if (s_rx.num >= TEST_RECORD_NUM) {
+        s_rx.bad_num++;
+        return;
+    }
+    s_rx.rec[s_rx.num].type = type;
+    s_rx.rec[s_rx.num].len = len;
+    memcpy(s_rx.rec[s_rx.num].data, data, len);
+    strcpy(s_rx.rec[s_rx.num].line, line);
+    s_rx.num++;
+}
+
+/* let subcore print the next step and wait for `num` records in total */
+static int wait_records(atomic_uint *log_sync, int step, int num)
+{
+    atomic_store(log_sync, step + 1);
+    for (int i = 0; i < 100 && s_rx.num < num; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        esp_amp_log_ring_drain(log_record_cb);
+    }
+    return s_rx.num;
+}
+
+TEST_CASE("subcore binary log is formatted the same as text print", "[esp_amp]")
+{
+    char line[TEST_RECORD_MAX];
+
+    memset(&s_rx, 0, sizeof(s_rx));
+
+    TEST_ASSERT(esp_amp_init() == 0);
+    atomic_uint *log_sync = (atomic_uint *)esp_amp_sys_info_alloc_with_caps(SYS_INFO_ID_TEST_LOG_SYNC, sizeof(uint32_t), ESP_AMP_SYS_INFO_CAP_ATOMIC);
+    TEST_ASSERT_NOT_NULL(log_sync);
+    atomic_init(log_sync, 0);
+
+    /* test task is the only reader of log ring while supplicant is suspended */
+    TaskHandle_t supplicant = (TaskHandle_t)esp_amp_system_get_supplicant();
+    TEST_ASSERT_NOT_NULL(supplicant);
+    vTaskSuspend(supplicant);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_load_sub(subcore_binary_log_test_bin_start));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_start_subcore());
+
+    /* one pair at a time, so that small log ring never drops a line */
+    for (int i = 0; i < TEST_PAIR_NUM; i++) {
+        TEST_ASSERT_EQUAL(2 * (i + 1), wait_records(log_sync, i, 2 * (i + 1)));
+        printf("%s\n", s_rx.rec[2 * i].line);
+        TEST_ASSERT_EQUAL(s_pairs[i].type, s_rx.rec[2 * i].type);
+        TEST_ASSERT_EQUAL(LOG_RING_RECORD_TEXT, s_rx.rec[2 * i + 1].type);
+        TEST_ASSERT_EQUAL_STRING(s_rx.rec[2 * i + 1].line, s_rx.rec[2 * i].line);
+        TEST_ASSERT_EQUAL_STRING(s_pairs[i].line, s_rx.rec[2 * i].line);
+    }
+
+    /* arguments cut off by the end of record are not printed */
+    TEST_ASSERT_EQUAL(0, s_rx.bad_num);
+    TEST_ASSERT_GREATER_THAN(TEST_CUT_LEN, s_rx.rec[2 * TEST_PAIR_CUT].len);
+    TEST_ASSERT_EQUAL(6, esp_amp_system_binary_log_decode(s_rx.rec[2 * TEST_PAIR_CUT].data, TEST_CUT_LEN, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("cut 1 ", line);
+
+    /* format string outside of subcore firmware is rejected */
+    uint32_t bad_rec[2] = { 0, 0 };
+    TEST_ASSERT_EQUAL(-1, esp_amp_system_binary_log_decode(bad_rec, sizeof(bad_rec), line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("<invalid subcore log format at 0x00000000>", line);
+
+    /* format string too long for maincore to read is sent as text, split into full lines */
+    int num = 2 * TEST_PAIR_NUM + TEST_LONG_REC_NUM;
+    TEST_ASSERT_EQUAL(num, wait_records(log_sync, TEST_PAIR_NUM, num));
+    char long_line[sizeof(TEST_STR_LONG)];
+    long_line[0] = '\0';
+    for (int i = 2 * TEST_PAIR_NUM; i < num; i++) {
+        TEST_ASSERT_EQUAL(LOG_RING_RECORD_TEXT, s_rx.rec[i].type);
+        strlcat(long_line, s_rx.rec[i].line, sizeof(long_line));
+    }
+    TEST_ASSERT_EQUAL_STRING(TEST_STR_LONG, long_line);
+    TEST_ASSERT_EQUAL(0, s_rx.bad_num);
+
+    TEST_ASSERT_EQUAL(EVENT_SUBCORE_DONE, EVENT_SUBCORE_DONE & esp_amp_event_wait(EVENT_SUBCORE_DONE, true, true, 5000));
+
+    vTaskResume(supplicant);
+}
@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "esp_cpu.h"
+#include "esp_amp.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+#define SYS_INFO_ID_TEST_COPY 0x0103
+#define TEST_COPY_BENCH_SIZE 4096
+#define TEST_COPY_BENCH_ROUNDS 16
+
+static uint8_t copy_local[TEST_COPY_BENCH_SIZE + 8] __attribute__((aligned(4)));
+static uint8_t copy_expect[TEST_COPY_BENCH_SIZE + 8] __attribute__((aligned(4)));
+
+TEST_CASE("esp_amp_copy copies any alignment and size", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    uint8_t *shm = esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_COPY, 256);
+    TEST_ASSERT_NOT_NULL(shm);
+    for (int i = 0; i < 256; i++) {
+        shm[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    for (int src_off = 0; src_off < 4; src_off++) {
+        for (int dst_off = 0; dst_off < 4; dst_off++) {
+            for (int size = 0; size < 100; size++) {
+                memset(copy_local, 0xee, 128);
+                memset(copy_expect, 0xee, 128);
+                memcpy(copy_expect + dst_off, shm + src_off, size);
+                TEST_ASSERT_EQUAL_PTR(copy_local + dst_off, esp_amp_copy(copy_local + dst_off, shm + src_off, size));
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(copy_expect, copy_local, 128);
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_COPY));
+}
+
+typedef void (*test_copy_kernel_t)(void *dst, const void *src, uint32_t size);
+
+static void test_copy_libc(void *dst, const void *src, uint32_t size)
+{
+    memcpy(dst, src, size);
+}
+
+static void test_copy_default(void *dst, const void *src, uint32_t size)
+{
+    esp_amp_copy(dst, src, size);
+}
+
+static uint32_t test_copy_bench(test_copy_kernel_t kernel, void *dst, const void *src)
+{
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < TEST_COPY_BENCH_ROUNDS; i++) {
+        kernel(dst, src, TEST_COPY_BENCH_SIZE);
+    }
+    return (esp_cpu_get_cycle_count() - start) / TEST_COPY_BENCH_ROUNDS;
+}
+
+TEST_CASE("esp_amp_copy bandwidth of copy kernels", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    uint8_t *shm = esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_COPY, TEST_COPY_BENCH_SIZE);
+    TEST_ASSERT_NOT_NULL(shm);
+
+    const struct {
+        const char *name;
+        test_copy_kernel_t kernel;
+    } kernels[] = {
+        { "byte", esp_amp_copy_byte },
+        { "word", esp_amp_copy_word },
+        { "word_x8", esp_amp_copy_word_x8 },
+        { "esp_amp_copy", test_copy_default },
+        { "memcpy", test_copy_libc },
+    };
+
+    uint32_t cycles[sizeof(kernels) / sizeof(kernels[0])][2];
+    for (int k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        /* warm up instruction cache */
+        kernels[k].kernel(shm, copy_local, TEST_COPY_BENCH_SIZE);
+        cycles[k][0] = test_copy_bench(kernels[k].kernel, shm, copy_local);
+        cycles[k][1] = test_copy_bench(kernels[k].kernel, copy_local, shm);
+        printf("%-12s to shm: %5"PRIu32" cycles/KB, from shm: %5"PRIu32" cycles/KB\n", kernels[k].name,
+               cycles[k][0] / (TEST_COPY_BENCH_SIZE / 1024), cycles[k][1] / (TEST_COPY_BENCH_SIZE / 1024));
+    }
+
+    /* word kernels must beat byte-by-byte copy in both directions */
+    for (int dir = 0; dir < 2; dir++) {
+        TEST_ASSERT_LESS_THAN_UINT32(cycles[0][dir], cycles[1][dir]);
+        TEST_ASSERT_LESS_THAN_UINT32(cycles[0][dir], cycles[2][dir]);
+        TEST_ASSERT_LESS_THAN_UINT32(cycles[0][dir], cycles[3][dir]);
+    }
+
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_COPY));
+}
+
+static int test_backend_calls;
+static int test_done_calls;
+
+static int test_backend_copy(void *ctx, void *dst, const void *src, uint32_t size, esp_amp_copy_done_cb_t done_cb, void *arg)
+{
+    test_backend_calls++;
+    memcpy(dst, src, size);
+    done_cb(arg);
+    return 0;
+}
+
+static void test_copy_done(void *arg)
+{
+    test_done_calls++;
+}
+
+TEST_CASE("esp_amp_copy_async offloads only large aligned copies", "[esp_amp]")
+{
+    static uint32_t src[64], dst[64];
+    /* backend stays registered if an assertion fails, keep it valid after this test */
+    static const esp_amp_copy_backend_t backend = {
+        .copy = test_backend_copy,
+        .ctx = NULL,
+        .min_size = 64,
+        .align = 4,
+    };
+
+    test_backend_calls = 0;
+    test_done_calls = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_amp_copy_async(dst, src, sizeof(src), NULL, NULL));
+
+    /* without backend, copy is done by CPU */
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_copy_async(dst, src, sizeof(src), test_copy_done, NULL));
+    TEST_ASSERT_EQUAL(0, test_backend_calls);
+    TEST_ASSERT_EQUAL(1, test_done_calls);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_copy_register_backend(&backend));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_copy_async(dst, src, sizeof(src), test_copy_done, NULL));
+    TEST_ASSERT_EQUAL(1, test_backend_calls);
+    /* too small */
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_copy_async(dst, src, 32, test_copy_done, NULL));
+    /* unaligned */
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_copy_async((uint8_t *)dst + 1, src, 128, test_copy_done, NULL));
+    TEST_ASSERT_EQUAL(1, test_backend_calls);
+    TEST_ASSERT_EQUAL(4, test_done_calls);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_copy_register_backend(NULL));
+}
@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/param.h>
+#include "esp_amp.h"
+#include "esp_err.h"
+#include "esp_vfs.h"
+#include "stdatomic.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+extern const uint8_t subcore_file_proxy_test_bin_start[] asm("_binary_subcore_test_file_proxy_bin_start");
+extern const uint8_t subcore_file_proxy_test_bin_end[]   asm("_binary_subcore_test_file_proxy_bin_end");
+
+#define SYS_INFO_ID_TEST_BITS 0x0000
+#define EVENT_SUBCORE_DONE    (1 << 0)
+
+#define TEST_LINE_NUM   64
+#define TEST_LINE_LEN   8
+
+#define TEST_WRITE (1 << 0)
+#define TEST_READ (1 << 1)
+#define TEST_READ_SHARED (1 << 2)
+#define TEST_ERROR (1 << 3)
+#define TEST_PENDING_ERROR (1 << 4)
+#define TEST_ALL (TEST_WRITE | TEST_READ | TEST_READ_SHARED | TEST_ERROR | TEST_PENDING_ERROR)
+
+/* fake filesystem holding a single file "/log.txt" in memory, and "/full.txt" which can't be written */
+#define FAKE_FS_FILE_MAX 1024
+#define FAKE_FS_FULL_FD  1
+
+static struct {
+    char data[FAKE_FS_FILE_MAX];
+    off_t size;
+    bool exist;
+    bool opened;
+    off_t pos;
+    int write_calls;
+} s_fake_file;
+
+static int fake_open(const char *path, int flags, int mode)
+{
+    if (strcmp(path, "/full.txt") == 0) {
+        return FAKE_FS_FULL_FD;
+    }
+    if (strcmp(path, "/log.txt") != 0 || s_fake_file.opened) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (!s_fake_file.exist && !(flags & O_CREAT)) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (flags & O_TRUNC) {
+        s_fake_file.size = 0;
+    }
+    s_fake_file.exist = true;
+    s_fake_file.opened = true;
+    s_fake_file.pos = 0;
+    return 0;
+}
+
+static int fake_close(int fd)
+{
+    if (fd == FAKE_FS_FULL_FD) {
+        return 0;
+    }
+    s_fake_file.opened = false;
+    return 0;
+}
+
+static ssize_t fake_write(int fd, const void *data, size_t size)
+{
+    if (fd == FAKE_FS_FULL_FD) {
+        errno = ENOSPC;
+        return -1;
+    }
+    s_fake_file.write_calls++;
+    if (s_fake_file.pos + (off_t)size > FAKE_FS_FILE_MAX) {
+        errno = ENOSPC;
+        return -1;
+    }
+    memcpy(s_fake_file.data + s_fake_file.pos, data, size);
+    s_fake_file.pos += size;
+    if (s_fake_file.pos > s_fake_file.size) {
+        s_fake_file.size = s_fake_file.pos;
+    }
+    return size;
+}
+
+static ssize_t fake_read(int fd, void *dst, size_t size)
+{
+    size_t len = (s_fake_file.pos < s_fake_file.size) ? MIN(size, (size_t)(s_fake_file.size - s_fake_file.pos)) : 0;
+    memcpy(dst, s_fake_file.data + s_fake_file.pos, len);
+    s_fake_file.pos += len;
+    return len;
+}
+
+static off_t fake_lseek(int fd, off_t offset, int whence)
+{
+    off_t base = (whence == SEEK_SET) ? 0 : (whence == SEEK_CUR) ? s_fake_file.pos : s_fake_file.size;
+    if (base + offset < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    s_fake_file.pos = base + offset;
+    return s_fake_file.pos;
+}
+
+static int fake_fstat(int fd, struct stat *st)
+{
+    memset(st, 0, sizeof(struct stat));
+    st->st_mode = S_IFREG;
+    st->st_size = s_fake_file.size;
+    return 0;
+}
+
+TEST_CASE("subcore file io is forwarded to maincore vfs", "[esp_amp]")
+{
+    const esp_vfs_t fake_vfs = {
+        .flags = ESP_VFS_FLAG_DEFAULT,
+        .open = fake_open,
+        .close = fake_close,
+        .write = fake_write,
+        .read = fake_read,
+        .lseek = fake_lseek,
+        .fstat = fake_fstat,
+    };
+    memset(&s_fake_file, 0, sizeof(s_fake_file));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_register("/fake", &fake_vfs, NULL));
+
+    TEST_ASSERT(esp_amp_init() == 0);
+    atomic_uint *test_bits = (atomic_uint *)esp_amp_sys_info_alloc_with_caps(SYS_INFO_ID_TEST_BITS, sizeof(uint32_t), ESP_AMP_SYS_INFO_CAP_ATOMIC);
+    TEST_ASSERT_NOT_NULL(test_bits);
+    atomic_init(test_bits, 0);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_load_sub(subcore_file_proxy_test_bin_start));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_start_subcore());
+
+    TEST_ASSERT_EQUAL(EVENT_SUBCORE_DONE, EVENT_SUBCORE_DONE & esp_amp_event_wait(EVENT_SUBCORE_DONE, true, true, 5000));
+
+    uint32_t test_bits_val = atomic_load(test_bits);
+    printf("test_bits = %lu\n", test_bits_val);
+    TEST_ASSERT_EQUAL(TEST_ALL, test_bits_val);
+
+    /* file content written by subcore */
+    TEST_ASSERT_EQUAL(TEST_LINE_NUM * TEST_LINE_LEN, s_fake_file.size);
+    for (int i = 0; i < TEST_LINE_NUM; i++) {
+        char line[TEST_LINE_LEN + 1];
+        snprintf(line, sizeof(line), "line %02d\n", i);
+        TEST_ASSERT_EQUAL_MEMORY(line, s_fake_file.data + i * TEST_LINE_LEN, TEST_LINE_LEN);
+    }
+
+    /* small writes of subcore are batched into file proxy buffer and written on maincore at once */
+    printf("%d writes on subcore, %d writes on maincore\n", TEST_LINE_NUM, s_fake_file.write_calls);
+    TEST_ASSERT_EQUAL((TEST_LINE_NUM * TEST_LINE_LEN + CONFIG_ESP_AMP_SUBCORE_FILE_PROXY_BUF_SIZE - 1) / CONFIG_ESP_AMP_SUBCORE_FILE_PROXY_BUF_SIZE,
+                      s_fake_file.write_calls);
+
+    esp_amp_system_service_stats_t stats;
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_get_stats(ESP_AMP_SYSTEM_SERVICE_ID_FILE_PROXY, &stats));
+    printf("file proxy requests: %"PRIu32", max cycles: %"PRIu32"\n", stats.req_num, stats.max_cycles);
+    TEST_ASSERT(stats.req_num < TEST_LINE_NUM);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_unregister("/fake"));
+}
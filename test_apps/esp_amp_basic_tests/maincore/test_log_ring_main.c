@@ -0,0 +1,134 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <sys/param.h>
+#include "esp_amp.h"
+#include "esp_err.h"
+#include "stdatomic.h"
+
+/* white-box test of the ring behind routed subcore print */
+#include "esp_amp_service.h"
+#include "esp_amp_log_ring.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+extern const uint8_t subcore_log_ring_test_bin_start[] asm("_binary_subcore_test_log_ring_bin_start");
+extern const uint8_t subcore_log_ring_test_bin_end[]   asm("_binary_subcore_test_log_ring_bin_end");
+
+#define SYS_INFO_ID_TEST_BITS     0x0000
+#define SYS_INFO_ID_TEST_LOG_SYNC 0x0105
+#define SYS_INFO_ID_TEST_LOG_CYCLES 0x0106
+#define EVENT_SUBCORE_DONE        (1 << 0)
+
+#define TEST_FULL_LINE_NUM  64
+#define TEST_WRAP_LINE_NUM  128
+#define TEST_LINE_LEN       8   /* "log XXX" with '\0' */
+#define TEST_WRAP_WINDOW    16  /* lines subcore can write ahead of maincore */
+/* average subcore cycles per line of the burst, mostly spent formatting. Waiting for
+ * maincore to drain the ring on dropped lines would cost orders of magnitude more */
+#define TEST_LINE_MAX_CYCLES 10000
+
+#define TEST_LOG_FULL (1 << 0)
+#define TEST_LOG_WRAP (1 << 1)
+#define TEST_ALL (TEST_LOG_FULL | TEST_LOG_WRAP)
+
+static struct {
+    int seq[TEST_FULL_LINE_NUM + TEST_WRAP_LINE_NUM];
+    int num;
+    int bad_num;
+} s_rx;
+
+static void log_record_cb(uint16_t type, void *data, uint16_t len)
+{
+    const char *line = (const char *)data;
+
+    /* lines printed before the test starts are not counted */
+    if (type != LOG_RING_RECORD_TEXT || strncmp(line, "log ", 4) != 0) {
+        return;
+    }
+    if (len != TEST_LINE_LEN || s_rx.num >= TEST_FULL_LINE_NUM + TEST_WRAP_LINE_NUM) {
+        s_rx.bad_num++;
+        return;
+    }
+    s_rx.seq[s_rx.num++] = atoi(line + 4);
+}
+
+static uint32_t wait_test_bits(atomic_uint *test_bits, uint32_t bits, int timeout_ms)
+{
+    for (int i = 0; i < timeout_ms / 10; i++) {
+        if ((atomic_load(test_bits) & bits) == bits) {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return atomic_load(test_bits) & bits;
+}
+
+TEST_CASE("subcore log ring drops lines when full and keeps order across wraparound", "[esp_amp]")
+{
+    memset(&s_rx, 0, sizeof(s_rx));
+
+    TEST_ASSERT(esp_amp_init() == 0);
+    atomic_uint *test_bits = (atomic_uint *)esp_amp_sys_info_alloc_with_caps(SYS_INFO_ID_TEST_BITS, sizeof(uint32_t), ESP_AMP_SYS_INFO_CAP_ATOMIC);
+    TEST_ASSERT_NOT_NULL(test_bits);
+    atomic_init(test_bits, 0);
+    atomic_uint *log_sync = (atomic_uint *)esp_amp_sys_info_alloc_with_caps(SYS_INFO_ID_TEST_LOG_SYNC, sizeof(uint32_t), ESP_AMP_SYS_INFO_CAP_ATOMIC);
+    TEST_ASSERT_NOT_NULL(log_sync);
+    atomic_init(log_sync, 0);
+    uint32_t *log_cycles = (uint32_t *)esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_LOG_CYCLES, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(log_cycles);
+    *log_cycles = UINT32_MAX;
+
+    /* test task is the only reader of log ring while supplicant is suspended */
+    TaskHandle_t supplicant = (TaskHandle_t)esp_amp_system_get_supplicant();
+    TEST_ASSERT_NOT_NULL(supplicant);
+    vTaskSuspend(supplicant);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_load_sub(subcore_log_ring_test_bin_start));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_start_subcore());
+
+    /* subcore is not blocked by a full log ring */
+    TEST_ASSERT_EQUAL(TEST_LOG_FULL, wait_test_bits(test_bits, TEST_LOG_FULL, 1000));
+    printf("subcore print: %"PRIu32" cycles/line with log ring full\n", *log_cycles);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(TEST_LINE_MAX_CYCLES, *log_cycles);
+
+    esp_amp_log_ring_drain(log_record_cb);
+    int full_num = s_rx.num;
+    printf("log ring full: %d lines kept, %"PRIu32" bytes dropped\n", full_num, esp_amp_log_ring_get_dropped());
+    TEST_ASSERT(full_num > 0 && full_num < TEST_FULL_LINE_NUM);
+    for (int i = 0; i < full_num; i++) {
+        TEST_ASSERT_EQUAL(i, s_rx.seq[i]);
+    }
+    TEST_ASSERT_EQUAL((TEST_FULL_LINE_NUM - full_num) * TEST_LINE_LEN, esp_amp_log_ring_get_dropped());
+
+    /* let subcore write a few lines ahead each time, so that nothing is dropped */
+    int wrap_num = 0;
+    for (int i = 0; i < 500 && wrap_num < TEST_WRAP_LINE_NUM; i++) {
+        esp_amp_log_ring_drain(log_record_cb);
+        wrap_num = s_rx.num - full_num;
+        atomic_store(log_sync, TEST_FULL_LINE_NUM + MIN(wrap_num + TEST_WRAP_WINDOW, TEST_WRAP_LINE_NUM));
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    TEST_ASSERT_EQUAL(TEST_WRAP_LINE_NUM, wrap_num);
+    for (int i = 0; i < TEST_WRAP_LINE_NUM; i++) {
+        TEST_ASSERT_EQUAL(TEST_FULL_LINE_NUM + i, s_rx.seq[full_num + i]);
+    }
+    TEST_ASSERT_EQUAL((TEST_FULL_LINE_NUM - full_num) * TEST_LINE_LEN, esp_amp_log_ring_get_dropped());
+    TEST_ASSERT_EQUAL(0, s_rx.bad_num);
+
+    TEST_ASSERT_EQUAL(EVENT_SUBCORE_DONE, EVENT_SUBCORE_DONE & esp_amp_event_wait(EVENT_SUBCORE_DONE, true, true, 5000));
+    TEST_ASSERT_EQUAL(TEST_ALL, atomic_load(test_bits));
+
+    vTaskResume(supplicant);
+}
@@ -0,0 +1,176 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_amp.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+#define SYS_INFO_ID_TEST_POOL 0x0102
+#define TEST_POOL_BLOCK_SIZE 32
+#define TEST_POOL_BLOCK_NUM 12
+#define TEST_POOL_HOLD_NUM 8
+#define TEST_POOL_ITERATION 50000
+#define TEST_CACHED_REGION_SIZE 4096
+
+typedef struct {
+    esp_amp_pool_t *pool;
+    uint32_t owner;
+    volatile bool failed;
+} test_pool_worker_t;
+
+static SemaphoreHandle_t worker_done;
+
+static void pool_worker_task(void *arg)
+{
+    test_pool_worker_t *worker = (test_pool_worker_t *)arg;
+    uint32_t *held[TEST_POOL_HOLD_NUM] = {0};
+
+    for (int i = 0; i < TEST_POOL_ITERATION; i++) {
+        int k = i % TEST_POOL_HOLD_NUM;
+        if (held[k] != NULL) {
+            /* the other worker must never get a block we hold */
+            if (held[k][0] != worker->owner) {
+                worker->failed = true;
+            }
+            if (esp_amp_pool_free(worker->pool, held[k]) != ESP_OK) {
+                worker->failed = true;
+            }
+            held[k] = NULL;
+        } else {
+            held[k] = esp_amp_pool_alloc(worker->pool);
+            if (held[k] != NULL) {
+                held[k][0] = worker->owner;
+            }
+        }
+        if ((i & 0x3ff) == 0) {
+            vTaskDelay(1);
+        }
+    }
+
+    for (int k = 0; k < TEST_POOL_HOLD_NUM; k++) {
+        if (held[k] != NULL) {
+            esp_amp_pool_free(worker->pool, held[k]);
+        }
+    }
+    xSemaphoreGive(worker_done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("fixed-block pool alloc and free", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    esp_amp_pool_t pool;
+    void *blocks[TEST_POOL_BLOCK_NUM];
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_amp_pool_main_init(&pool, 0, TEST_POOL_BLOCK_NUM, SYS_INFO_ID_TEST_POOL));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_pool_main_init(&pool, TEST_POOL_BLOCK_SIZE, TEST_POOL_BLOCK_NUM, SYS_INFO_ID_TEST_POOL));
+    TEST_ASSERT_EQUAL(TEST_POOL_BLOCK_NUM, esp_amp_pool_get_free_num(&pool));
+
+    for (int i = 0; i < TEST_POOL_BLOCK_NUM; i++) {
+        blocks[i] = esp_amp_pool_alloc(&pool);
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+        for (int j = 0; j < i; j++) {
+            TEST_ASSERT(blocks[i] != blocks[j]);
+        }
+    }
+    TEST_ASSERT_NULL(esp_amp_pool_alloc(&pool));
+    TEST_ASSERT_EQUAL(0, esp_amp_pool_get_free_num(&pool));
+
+    /* pointers not from the pool are rejected */
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_amp_pool_free(&pool, (uint8_t *)blocks[0] + 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_amp_pool_free(&pool, &pool));
+
+    for (int i = 0; i < TEST_POOL_BLOCK_NUM; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, esp_amp_pool_free(&pool, blocks[i]));
+    }
+    TEST_ASSERT_EQUAL(TEST_POOL_BLOCK_NUM, esp_amp_pool_get_free_num(&pool));
+}
+
+TEST_CASE("fixed-block pool survives concurrent alloc and free", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    /* two handles of the same pool, as maincore and subcore would have */
+    esp_amp_pool_t pool_a, pool_b;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_pool_main_init(&pool_a, TEST_POOL_BLOCK_SIZE, TEST_POOL_BLOCK_NUM, SYS_INFO_ID_TEST_POOL));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_pool_sub_init(&pool_b, SYS_INFO_ID_TEST_POOL));
+
+    test_pool_worker_t worker_a = { .pool = &pool_a, .owner = 0xaaaaaaaa, .failed = false };
+    test_pool_worker_t worker_b = { .pool = &pool_b, .owner = 0xbbbbbbbb, .failed = false };
+
+    worker_done = xSemaphoreCreateCounting(2, 0);
+    TEST_ASSERT_NOT_NULL(worker_done);
+    /* same priority so that workers preempt each other on tick */
+    xTaskCreate(pool_worker_task, "pool_a", 2048, &worker_a, tskIDLE_PRIORITY + 2, NULL);
+    xTaskCreate(pool_worker_task, "pool_b", 2048, &worker_b, tskIDLE_PRIORITY + 2, NULL);
+
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(worker_done, pdMS_TO_TICKS(60000)));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(worker_done, pdMS_TO_TICKS(60000)));
+    vSemaphoreDelete(worker_done);
+
+    TEST_ASSERT_FALSE(worker_a.failed);
+    TEST_ASSERT_FALSE(worker_b.failed);
+
+    /* every block is back in the free list exactly once */
+    TEST_ASSERT_EQUAL(TEST_POOL_BLOCK_NUM, esp_amp_pool_get_free_num(&pool_a));
+    int cnt = 0;
+    while (esp_amp_pool_alloc(&pool_b) != NULL) {
+        cnt++;
+    }
+    TEST_ASSERT_EQUAL(TEST_POOL_BLOCK_NUM, cnt);
+}
+
+TEST_CASE("fixed-block pool keeps cached blocks on cache line boundary", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    uint8_t *region = malloc(TEST_CACHED_REGION_SIZE);
+    TEST_ASSERT_NOT_NULL(region);
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_add_region(region, TEST_CACHED_REGION_SIZE, ESP_AMP_SYS_INFO_CAP_BULK | ESP_AMP_SYS_INFO_CAP_CACHED));
+    esp_amp_sys_info_mem_info_t cached_info;
+    esp_amp_sys_info_get_mem_info_with_caps(ESP_AMP_SYS_INFO_CAP_CACHED, &cached_info);
+    uint32_t cached_free = cached_info.free;
+
+    esp_amp_pool_t pool_a, pool_b;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_pool_main_init_with_caps(&pool_a, 20, 4, ESP_AMP_SYS_INFO_CAP_CACHED, SYS_INFO_ID_TEST_POOL));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_pool_sub_init(&pool_b, SYS_INFO_ID_TEST_POOL));
+    TEST_ASSERT_TRUE(pool_a.cached);
+    TEST_ASSERT_TRUE(pool_b.cached);
+    TEST_ASSERT_EQUAL(0, pool_a.block_size % ESP_AMP_PLATFORM_CACHE_LINE_SIZE);
+
+    /* free list stays outside of cached region */
+    TEST_ASSERT((uint8_t *)pool_a.shm < region || (uint8_t *)pool_a.shm >= region + TEST_CACHED_REGION_SIZE);
+
+    /* hand a block over from one handle to the other */
+    uint8_t *block = esp_amp_pool_alloc(&pool_a);
+    TEST_ASSERT_NOT_NULL(block);
+    TEST_ASSERT(block >= region && block + pool_a.block_size <= region + TEST_CACHED_REGION_SIZE);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)block % ESP_AMP_PLATFORM_CACHE_LINE_SIZE);
+    memset(block, 0xa5, 20);
+    esp_amp_pool_writeback(&pool_a, block, 20);
+
+    esp_amp_pool_invalidate(&pool_b, block, 20);
+    for (int i = 0; i < 20; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0xa5, block[i]);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_pool_free(&pool_b, block));
+    TEST_ASSERT_EQUAL(4, esp_amp_pool_get_free_num(&pool_a));
+
+    /* blocks in cached region are released together with the free list */
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_POOL));
+    esp_amp_sys_info_get_mem_info_with_caps(ESP_AMP_SYS_INFO_CAP_CACHED, &cached_info);
+    TEST_ASSERT_EQUAL(cached_free, cached_info.free);
+}
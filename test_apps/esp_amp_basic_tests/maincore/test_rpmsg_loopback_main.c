@@ -0,0 +1,517 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_amp.h"
+#include "esp_amp_platform.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+/*
+ * Loopback of main-core to sub-core virtqueues, without running subcore:
+ * `tx_dev` is the rpmsg device of maincore, `rx_dev` is initialized on the
+ * same shared memory the way subcore would, and sends back on the sub-core
+ * to main-core virtqueues.
+ */
+#define SYS_INFO_ID_TEST_LOOPBACK 0x0104
+#define TEST_LOOPBACK_QUEUE_LEN 4
+#define TEST_LOOPBACK_ITEM_SIZE 64
+#define TEST_LOOPBACK_EPT_TX 0x10
+#define TEST_LOOPBACK_EPT_TX_NOFC 0x11
+#define TEST_LOOPBACK_EPT_RX 0x20
+#define TEST_LOOPBACK_MAX_MSG 16
+
+static esp_amp_rpmsg_dev_t tx_dev;
+static esp_amp_rpmsg_dev_t rx_dev;
+static esp_amp_queue_t tx_vqueue[ESP_AMP_RPMSG_MAX_LANES * 2];
+static esp_amp_queue_t rx_vqueue[ESP_AMP_RPMSG_MAX_LANES * 2];
+static esp_amp_rpmsg_ept_t tx_ept;
+static esp_amp_rpmsg_ept_t rx_ept;
+
+static int rx_cnt;
+static uint16_t rx_len[TEST_LOOPBACK_MAX_MSG];
+static uint8_t rx_first[TEST_LOOPBACK_MAX_MSG];
+static void *rx_held[TEST_LOOPBACK_MAX_MSG];
+static bool rx_hold;
+
+static int rx_record_cb(void* msg_data, uint16_t data_len, uint16_t src_addr, void* rx_cb_data)
+{
+    TEST_ASSERT(src_addr == TEST_LOOPBACK_EPT_TX || src_addr == TEST_LOOPBACK_EPT_TX_NOFC);
+    if (rx_cnt < TEST_LOOPBACK_MAX_MSG) {
+        rx_len[rx_cnt] = data_len;
+        rx_first[rx_cnt] = ((uint8_t *)msg_data)[0];
+        rx_held[rx_cnt] = msg_data;
+        rx_cnt++;
+    }
+    if (rx_hold) {
+        /* destroyed later by test case */
+        return 0;
+    }
+    return esp_amp_rpmsg_destroy(&rx_dev, msg_data);
+}
+
+static void test_loopback_init(uint8_t lane_num)
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_main_init_lanes(&tx_dev, tx_vqueue, lane_num, TEST_LOOPBACK_QUEUE_LEN, TEST_LOOPBACK_ITEM_SIZE, false, true, SYS_INFO_ID_TEST_LOOPBACK));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_sub_init_lanes(&rx_dev, rx_vqueue, lane_num, false, true, SYS_INFO_ID_TEST_LOOPBACK));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_create_endpoint(&tx_dev, TEST_LOOPBACK_EPT_TX, NULL, NULL, &tx_ept));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_create_endpoint(&rx_dev, TEST_LOOPBACK_EPT_RX, rx_record_cb, NULL, &rx_ept));
+
+    rx_cnt = 0;
+    rx_hold = false;
+}
+
+static void test_loopback_deinit(void)
+{
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&tx_dev, TEST_LOOPBACK_EPT_TX));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&rx_dev, TEST_LOOPBACK_EPT_RX));
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_LOOPBACK));
+}
+
+static void test_loopback_send(uint8_t tag, uint16_t len)
+{
+    uint8_t data[TEST_LOOPBACK_ITEM_SIZE];
+    memset(data, tag, sizeof(data));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, data, len));
+}
+
+static int test_loopback_poll_all(void)
+{
+    int polled = 0;
+    while (esp_amp_rpmsg_poll(&rx_dev) == 0) {
+        polled++;
+    }
+    return polled;
+}
+
+TEST_CASE("rpmsg coalescing packs small messages into one buffer", "[esp_amp]")
+{
+    test_loopback_init(1);
+
+    /* 12 bytes per 4-byte message with head */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_coalescing(&tx_dev, 48, 0));
+
+    /* more rounds than virtqueue slots, so leaked buffers would make sending fail */
+    for (int round = 0; round < TEST_LOOPBACK_QUEUE_LEN * 2; round++) {
+        rx_cnt = 0;
+        test_loopback_send(1, 4);
+        test_loopback_send(2, 4);
+        test_loopback_send(3, 1);
+        TEST_ASSERT_EQUAL(0, test_loopback_poll_all());
+
+        TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_flush(&tx_dev));
+        TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+        TEST_ASSERT_EQUAL(3, rx_cnt);
+        TEST_ASSERT_EQUAL(4, rx_len[0]);
+        TEST_ASSERT_EQUAL(1, rx_first[0]);
+        TEST_ASSERT_EQUAL(2, rx_first[1]);
+        TEST_ASSERT_EQUAL(1, rx_len[2]);
+        TEST_ASSERT_EQUAL(3, rx_first[2]);
+    }
+
+    /* flush on size */
+    rx_cnt = 0;
+    for (int i = 0; i < 4; i++) {
+        test_loopback_send(i, 4);
+    }
+    TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+    TEST_ASSERT_EQUAL(4, rx_cnt);
+
+    /* large message goes alone, after messages packed before it */
+    rx_cnt = 0;
+    test_loopback_send(5, 4);
+    test_loopback_send(6, 50);
+    TEST_ASSERT_EQUAL(2, test_loopback_poll_all());
+    TEST_ASSERT_EQUAL(2, rx_cnt);
+    TEST_ASSERT_EQUAL(5, rx_first[0]);
+    TEST_ASSERT_EQUAL(50, rx_len[1]);
+    TEST_ASSERT_EQUAL(6, rx_first[1]);
+
+    /* flush on timeout, checked by poll on sender side */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_coalescing(&tx_dev, 48, 1));
+    rx_cnt = 0;
+    test_loopback_send(7, 4);
+    TEST_ASSERT_EQUAL(0, test_loopback_poll_all());
+    esp_amp_platform_delay_ms(2);
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_poll(&tx_dev));
+    TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+    TEST_ASSERT_EQUAL(1, rx_cnt);
+
+    /* disabling coalescing sends what is pending */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_coalescing(&tx_dev, 48, 0));
+    rx_cnt = 0;
+    test_loopback_send(8, 4);
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_coalescing(&tx_dev, 0, 0));
+    test_loopback_send(9, 4);
+    TEST_ASSERT_EQUAL(2, test_loopback_poll_all());
+    TEST_ASSERT_EQUAL(2, rx_cnt);
+    TEST_ASSERT_EQUAL(8, rx_first[0]);
+    TEST_ASSERT_EQUAL(9, rx_first[1]);
+
+    test_loopback_deinit();
+}
+
+#define TEST_LARGE_MSG_LEN 200
+
+static uint8_t large_tx[TEST_LARGE_MSG_LEN * 2];
+static uint8_t large_rx[TEST_LARGE_MSG_LEN * 2];
+static int frag_calls;
+static uint32_t frag_received;
+
+static int rx_frag_cb(void* data, uint32_t data_len, uint32_t offset, uint32_t total_len, uint16_t src_addr, void* rx_cb_data)
+{
+    TEST_ASSERT_EQUAL(TEST_LOOPBACK_EPT_TX, src_addr);
+    TEST_ASSERT(offset + data_len <= total_len);
+    if (data != large_rx) {
+        /* streaming, fragments arrive in order */
+        TEST_ASSERT_EQUAL(frag_received, offset);
+        memcpy(large_rx + offset, data, data_len);
+    }
+    frag_received = offset + data_len;
+    frag_calls++;
+    return 0;
+}
+
+TEST_CASE("rpmsg fragments messages larger than one buffer", "[esp_amp]")
+{
+    test_loopback_init(1);
+    for (int i = 0; i < sizeof(large_tx); i++) {
+        large_tx[i] = (uint8_t)(i * 13 + 1);
+    }
+    uint16_t max_size = esp_amp_rpmsg_get_max_size(&tx_dev);
+    TEST_ASSERT(TEST_LARGE_MSG_LEN > max_size);
+    TEST_ASSERT(TEST_LARGE_MSG_LEN + 4 <= max_size * TEST_LOOPBACK_QUEUE_LEN);
+
+    /* reassembly buffer, whole message in one callback */
+    memset(large_rx, 0, sizeof(large_rx));
+    frag_calls = 0;
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_frag_rx(&rx_ept, rx_frag_cb, large_rx, TEST_LARGE_MSG_LEN));
+    for (int round = 0; round < 3; round++) {
+        TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send_large(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, large_tx, TEST_LARGE_MSG_LEN, 0));
+        TEST_ASSERT_EQUAL((TEST_LARGE_MSG_LEN + 4 + max_size - 1) / max_size, test_loopback_poll_all());
+        TEST_ASSERT_EQUAL(round + 1, frag_calls);
+        TEST_ASSERT_EQUAL(TEST_LARGE_MSG_LEN, frag_received);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(large_tx, large_rx, TEST_LARGE_MSG_LEN);
+    }
+
+    /* larger than reassembly buffer, dropped */
+    frag_calls = 0;
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send_large(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, large_tx, TEST_LARGE_MSG_LEN + 1, 0));
+    test_loopback_poll_all();
+    TEST_ASSERT_EQUAL(0, frag_calls);
+
+    /* streaming, one callback per fragment */
+    memset(large_rx, 0, sizeof(large_rx));
+    frag_calls = 0;
+    frag_received = 0;
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_frag_rx(&rx_ept, rx_frag_cb, NULL, 0));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send_large(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, large_tx + 1, TEST_LARGE_MSG_LEN - 1, 0));
+    test_loopback_poll_all();
+    TEST_ASSERT_EQUAL((TEST_LARGE_MSG_LEN - 1 + 4 + max_size - 1) / max_size, frag_calls);
+    TEST_ASSERT_EQUAL(TEST_LARGE_MSG_LEN - 1, frag_received);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(large_tx + 1, large_rx, TEST_LARGE_MSG_LEN - 1);
+
+    /* virtqueue full and nobody receives: sender gives up, partial message is dropped */
+    frag_calls = 0;
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_send_large(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, large_tx, sizeof(large_tx), 5));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_frag_rx(&rx_ept, rx_frag_cb, large_rx, sizeof(large_rx)));
+    TEST_ASSERT_EQUAL(TEST_LOOPBACK_QUEUE_LEN, test_loopback_poll_all());
+    TEST_ASSERT_EQUAL(0, frag_calls);
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send_large(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, large_tx, TEST_LARGE_MSG_LEN, 0));
+    test_loopback_poll_all();
+    TEST_ASSERT_EQUAL(1, frag_calls);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(large_tx, large_rx, TEST_LARGE_MSG_LEN);
+
+    /* regular messages are not affected */
+    rx_cnt = 0;
+    test_loopback_send(3, 8);
+    TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+    TEST_ASSERT_EQUAL(1, rx_cnt);
+
+    test_loopback_deinit();
+}
+
+#define TEST_CREDIT_WINDOW 2
+
+static int credit_calls;
+static uint16_t credit_last;
+
+static void tx_credit_cb(esp_amp_rpmsg_ept_t* ept, uint16_t tx_credits, void* credit_cb_data)
+{
+    TEST_ASSERT_EQUAL_PTR(&tx_ept, ept);
+    credit_last = tx_credits;
+    credit_calls++;
+}
+
+TEST_CASE("rpmsg credits limit messages in flight per endpoint", "[esp_amp]")
+{
+    test_loopback_init(1);
+    uint8_t data[8] = { 0 };
+    esp_amp_rpmsg_ept_t tx_ept_nofc;
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_create_endpoint(&tx_dev, TEST_LOOPBACK_EPT_TX_NOFC, NULL, NULL, &tx_ept_nofc));
+
+    TEST_ASSERT_EQUAL(UINT16_MAX, esp_amp_rpmsg_get_credit(&tx_ept));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_credit(&tx_ept, TEST_LOOPBACK_EPT_RX, TEST_CREDIT_WINDOW, tx_credit_cb, NULL));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_credit(&rx_ept, TEST_LOOPBACK_EPT_TX, TEST_CREDIT_WINDOW, NULL, NULL));
+    /* credited messages are never packed */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_coalescing(&tx_dev, 48, 0));
+    credit_calls = 0;
+
+    rx_hold = true;
+    test_loopback_send(1, 4);
+    test_loopback_send(2, 4);
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_get_credit(&tx_ept));
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_send(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(2, test_loopback_poll_all());
+    TEST_ASSERT_EQUAL(2, rx_cnt);
+
+    /* endpoint without flow control still has buffers to use */
+    rx_hold = false;
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send(&tx_dev, &tx_ept_nofc, TEST_LOOPBACK_EPT_RX, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_flush(&tx_dev));
+    TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+
+    /* destroying half of the window returns credits to sender */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_destroy(&rx_dev, rx_held[0]));
+    TEST_ASSERT_EQUAL(0, credit_calls);
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_poll(&tx_dev));
+    TEST_ASSERT_EQUAL(1, credit_calls);
+    TEST_ASSERT_EQUAL(1, credit_last);
+    TEST_ASSERT_EQUAL(1, esp_amp_rpmsg_get_credit(&tx_ept));
+
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_destroy(&rx_dev, rx_held[1]));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_poll(&tx_dev));
+    TEST_ASSERT_EQUAL(TEST_CREDIT_WINDOW, esp_amp_rpmsg_get_credit(&tx_ept));
+
+    /* more rounds than virtqueue slots, credits keep flowing */
+    for (int round = 0; round < TEST_LOOPBACK_QUEUE_LEN * 2; round++) {
+        test_loopback_send(round, 4);
+        TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+        while (esp_amp_rpmsg_poll(&tx_dev) == 0) {
+        }
+        TEST_ASSERT_EQUAL(TEST_CREDIT_WINDOW, esp_amp_rpmsg_get_credit(&tx_ept));
+    }
+
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_coalescing(&tx_dev, 0, 0));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_credit(&tx_ept, 0, 0, NULL, NULL));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&tx_dev, TEST_LOOPBACK_EPT_TX_NOFC));
+    test_loopback_deinit();
+}
+
+static int free_notify_calls;
+
+static int rx_free_notify(void* priv_data)
+{
+    free_notify_calls++;
+    return 0;
+}
+
+TEST_CASE("rpmsg create message waits for receiver to free buffers", "[esp_amp]")
+{
+    test_loopback_init(1);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_queue_free_notify_enable(&rx_vqueue[1], rx_free_notify));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, esp_amp_queue_request_free_notify(&rx_vqueue[1]));
+    free_notify_calls = 0;
+
+    /* receiver holds all buffers */
+    rx_hold = true;
+    for (int i = 0; i < TEST_LOOPBACK_QUEUE_LEN; i++) {
+        void *msg = esp_amp_rpmsg_create_message_timeout(&tx_dev, 4, ESP_AMP_RPMSG_DATA_DEFAULT, 0);
+        TEST_ASSERT_NOT_NULL(msg);
+        TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send_nocopy(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, msg, 4));
+    }
+    TEST_ASSERT_EQUAL(TEST_LOOPBACK_QUEUE_LEN, test_loopback_poll_all());
+
+    /* no doorbell is rung unless sender waits */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_destroy(&rx_dev, rx_held[0]));
+    TEST_ASSERT_EQUAL(0, free_notify_calls);
+    void *msg = esp_amp_rpmsg_create_message_timeout(&tx_dev, 4, ESP_AMP_RPMSG_DATA_DEFAULT, 0);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send_nocopy(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, msg, 4));
+    TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+
+    /* too large, or timeout */
+    TEST_ASSERT_NULL(esp_amp_rpmsg_create_message_timeout(&tx_dev, esp_amp_rpmsg_get_max_size(&tx_dev) + 1, ESP_AMP_RPMSG_DATA_DEFAULT, 5));
+    uint32_t start_ms = esp_amp_platform_get_time_ms();
+    TEST_ASSERT_NULL(esp_amp_rpmsg_create_message_timeout(&tx_dev, 4, ESP_AMP_RPMSG_DATA_DEFAULT, 5));
+    TEST_ASSERT(esp_amp_platform_get_time_ms() - start_ms >= 5);
+
+    /* sender timed out waiting, receiver rings doorbell once */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_destroy(&rx_dev, rx_held[1]));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_destroy(&rx_dev, rx_held[2]));
+    TEST_ASSERT_EQUAL(1, free_notify_calls);
+
+    rx_hold = false;
+    for (int i = 3; i < rx_cnt; i++) {
+        TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_destroy(&rx_dev, rx_held[i]));
+    }
+    for (int i = 0; i < TEST_LOOPBACK_QUEUE_LEN; i++) {
+        test_loopback_send(i, 4);
+        TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+    }
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_queue_free_notify_enable(&rx_vqueue[1], NULL));
+    test_loopback_deinit();
+}
+
+TEST_CASE("rpmsg device with its own software interrupt", "[esp_amp]")
+{
+    test_loopback_init(1);
+    TEST_ASSERT_EQUAL(SW_INTR_RESERVED_ID_RPMSG, tx_dev.sw_intr_id);
+
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_set_intr_id(&tx_dev, SW_INTR_RESERVED_ID_PANIC, SW_INTR_PRIO_NORMAL));
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_set_intr_id(&tx_dev, SW_INTR_ID_3, (esp_amp_sw_intr_prio_t)(SW_INTR_PRIO_LOW + 1)));
+    TEST_ASSERT_EQUAL(SW_INTR_RESERVED_ID_RPMSG, tx_dev.sw_intr_id);
+
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_intr_id(&tx_dev, SW_INTR_ID_3, SW_INTR_PRIO_HIGH));
+    TEST_ASSERT_EQUAL(SW_INTR_ID_3, tx_dev.sw_intr_id);
+    TEST_ASSERT_EQUAL(SW_INTR_PRIO_HIGH, esp_amp_sw_intr_get_priority(SW_INTR_ID_3));
+    TEST_ASSERT_EQUAL(SW_INTR_PRIO_NORMAL, esp_amp_sw_intr_get_priority(SW_INTR_RESERVED_ID_RPMSG));
+
+    test_loopback_send(1, 4);
+    TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+    TEST_ASSERT_EQUAL(1, rx_cnt);
+
+    TEST_ASSERT_EQUAL(0, esp_amp_sw_intr_set_priority(SW_INTR_ID_3, SW_INTR_PRIO_NORMAL));
+    test_loopback_deinit();
+}
+
+#define TEST_NS_MAX_EVENTS 8
+
+static int ns_cnt;
+static char ns_name[TEST_NS_MAX_EVENTS][ESP_AMP_RPMSG_NS_NAME_LEN + 1];
+static uint16_t ns_addr[TEST_NS_MAX_EVENTS];
+static uint16_t ns_flags[TEST_NS_MAX_EVENTS];
+
+static void rx_ns_cb(const char* name, uint16_t addr, uint16_t flags, void* ns_cb_data)
+{
+    if (ns_cnt < TEST_NS_MAX_EVENTS) {
+        strcpy(ns_name[ns_cnt], name);
+        ns_addr[ns_cnt] = addr;
+        ns_flags[ns_cnt] = flags;
+        ns_cnt++;
+    }
+}
+
+TEST_CASE("rpmsg name service announces dynamic endpoints", "[esp_amp]")
+{
+    static esp_amp_rpmsg_ept_t tx_ns_ept, rx_ns_ept;
+    esp_amp_rpmsg_ept_t ctrl_ept, data_ept;
+
+    test_loopback_init(1);
+    ns_cnt = 0;
+
+    /* dynamic addresses */
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_create_endpoint(&tx_dev, ESP_AMP_RPMSG_ADDR_ANY, NULL, NULL, &ctrl_ept));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_create_endpoint(&tx_dev, ESP_AMP_RPMSG_ADDR_ANY, NULL, NULL, &data_ept));
+    TEST_ASSERT_EQUAL_HEX16(ESP_AMP_RPMSG_ADDR_DYNAMIC_BASE, ctrl_ept.addr);
+    TEST_ASSERT_EQUAL_HEX16(ESP_AMP_RPMSG_ADDR_DYNAMIC_BASE + 1, data_ept.addr);
+
+    /* announced before peer enables name service: dropped, sent again on its request */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_ns_enable(&tx_dev, &tx_ns_ept, NULL, NULL));
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_ns_enable(&tx_dev, &tx_ns_ept, NULL, NULL));
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_ns_announce(&tx_dev, &ctrl_ept, "ctrl", ESP_AMP_RPMSG_NS_SYNC));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_ns_announce(&tx_dev, &ctrl_ept, "ctrl", ESP_AMP_RPMSG_NS_CREATE));
+    /* sync request and announcement to missing endpoint */
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_poll(&rx_dev));
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_poll(&rx_dev));
+    TEST_ASSERT_EQUAL(0, ns_cnt);
+
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_ns_enable(&rx_dev, &rx_ns_ept, rx_ns_cb, NULL));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_poll(&tx_dev));
+    test_loopback_poll_all();
+    TEST_ASSERT_EQUAL(1, ns_cnt);
+    TEST_ASSERT_EQUAL_STRING("ctrl", ns_name[0]);
+    TEST_ASSERT_EQUAL_HEX16(ctrl_ept.addr, ns_addr[0]);
+    TEST_ASSERT_EQUAL(ESP_AMP_RPMSG_NS_CREATE, ns_flags[0]);
+
+    /* full-length name */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_ns_announce(&tx_dev, &data_ept, "data-0123456789a", ESP_AMP_RPMSG_NS_CREATE));
+    test_loopback_poll_all();
+    TEST_ASSERT_EQUAL(2, ns_cnt);
+    TEST_ASSERT_EQUAL_STRING("data-0123456789a", ns_name[1]);
+
+    /* withdraw explicitly, or by deleting the endpoint */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_ns_announce(&tx_dev, &data_ept, "data-0123456789a", ESP_AMP_RPMSG_NS_DESTROY));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&tx_dev, ctrl_ept.addr));
+    test_loopback_poll_all();
+    TEST_ASSERT_EQUAL(4, ns_cnt);
+    TEST_ASSERT_EQUAL(ESP_AMP_RPMSG_NS_DESTROY, ns_flags[2]);
+    TEST_ASSERT_EQUAL_HEX16(data_ept.addr, ns_addr[2]);
+    TEST_ASSERT_EQUAL(ESP_AMP_RPMSG_NS_DESTROY, ns_flags[3]);
+    TEST_ASSERT_EQUAL_STRING("ctrl", ns_name[3]);
+
+    /* freed address is allocated again */
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_create_endpoint(&tx_dev, ESP_AMP_RPMSG_ADDR_ANY, NULL, NULL, &ctrl_ept));
+    TEST_ASSERT_EQUAL_HEX16(ESP_AMP_RPMSG_ADDR_DYNAMIC_BASE, ctrl_ept.addr);
+
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&tx_dev, ctrl_ept.addr));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&tx_dev, data_ept.addr));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&tx_dev, ESP_AMP_RPMSG_RESERVED_EPT_NS));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&rx_dev, ESP_AMP_RPMSG_RESERVED_EPT_NS));
+    test_loopback_deinit();
+}
+
+#define TEST_LANE_NUM 2
+#define TEST_LANE_CTRL 1
+
+TEST_CASE("rpmsg lanes deliver control messages ahead of bulk data", "[esp_amp]")
+{
+    esp_amp_rpmsg_dev_t other_dev;
+    esp_amp_queue_t other_vqueue[TEST_LANE_NUM * 2];
+
+    TEST_ASSERT(esp_amp_init() == 0);
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_main_init_lanes(&tx_dev, tx_vqueue, ESP_AMP_RPMSG_MAX_LANES + 1, TEST_LOOPBACK_QUEUE_LEN, TEST_LOOPBACK_ITEM_SIZE, false, true, SYS_INFO_ID_TEST_LOOPBACK));
+    test_loopback_init(TEST_LANE_NUM);
+
+    /* subcore must use the same number of lanes */
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_sub_init_lanes(&other_dev, other_vqueue, 1, false, true, SYS_INFO_ID_TEST_LOOPBACK));
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_sub_init_by_id(&other_dev, other_vqueue, false, true, SYS_INFO_ID_TEST_LOOPBACK));
+
+    esp_amp_rpmsg_ept_t ctrl_ept;
+    uint8_t data[8];
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_create_endpoint(&tx_dev, TEST_LOOPBACK_EPT_TX_NOFC, NULL, NULL, &ctrl_ept));
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_set_lane(&tx_dev, &ctrl_ept, TEST_LANE_NUM));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_lane(&tx_dev, &ctrl_ept, TEST_LANE_CTRL));
+    TEST_ASSERT_NULL(esp_amp_rpmsg_create_message(&tx_dev, 4, ESP_AMP_RPMSG_DATA_LANE(TEST_LANE_NUM)));
+
+    /* bulk data fills up lane 0, control message still goes through and is received first */
+    for (int i = 0; i < TEST_LOOPBACK_QUEUE_LEN; i++) {
+        test_loopback_send(i + 1, 16);
+    }
+    memset(data, 0x80, sizeof(data));
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_send(&tx_dev, &tx_ept, TEST_LOOPBACK_EPT_RX, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send(&tx_dev, &ctrl_ept, TEST_LOOPBACK_EPT_RX, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(TEST_LOOPBACK_QUEUE_LEN + 1, test_loopback_poll_all());
+    TEST_ASSERT_EQUAL(TEST_LOOPBACK_QUEUE_LEN + 1, rx_cnt);
+    TEST_ASSERT_EQUAL(0x80, rx_first[0]);
+    for (int i = 0; i < TEST_LOOPBACK_QUEUE_LEN; i++) {
+        TEST_ASSERT_EQUAL(i + 1, rx_first[i + 1]);
+    }
+
+    /* buffers go back to the lane they came from, control lane is never coalesced */
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_coalescing(&tx_dev, 48, 0));
+    for (int round = 0; round < TEST_LOOPBACK_QUEUE_LEN * 2; round++) {
+        rx_cnt = 0;
+        test_loopback_send(1, 4);
+        data[0] = round;
+        TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send(&tx_dev, &ctrl_ept, TEST_LOOPBACK_EPT_RX, data, 4));
+        TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+        TEST_ASSERT_EQUAL(round, rx_first[0]);
+        TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_flush(&tx_dev));
+        TEST_ASSERT_EQUAL(1, test_loopback_poll_all());
+        TEST_ASSERT_EQUAL(2, rx_cnt);
+    }
+
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_set_coalescing(&tx_dev, 0, 0));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&tx_dev, TEST_LOOPBACK_EPT_TX_NOFC));
+    test_loopback_deinit();
+}
@@ -5,6 +5,7 @@
  */
 
 #include <stdio.h>
+#include <inttypes.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -19,6 +20,8 @@
 
 extern const uint8_t subcore_rpmsg_bin_start[] asm("_binary_subcore_test_rpmsg_bin_start");
 extern const uint8_t subcore_rpmsg_bin_end[]   asm("_binary_subcore_test_rpmsg_bin_end");
+extern const uint8_t subcore_rpmsg_wait_bin_start[] asm("_binary_subcore_test_rpmsg_wait_bin_start");
+extern const uint8_t subcore_rpmsg_wait_bin_end[]   asm("_binary_subcore_test_rpmsg_wait_bin_end");
 
 esp_amp_rpmsg_dev_t subcore_rpmsg_dev;
 typedef struct rpmsg_test_pars_t {
@@ -201,3 +204,45 @@ TEST_CASE("rpmsg transport layer test between main-core and sub-core", "[esp_amp
     /* wait for idle task to recycle task stack */
     vTaskDelay(pdMS_TO_TICKS(1000));
 }
+
+#define EVENT_SUBCORE_DONE  (1 << 0)
+
+#define TEST_WAIT_EPT_MAIN  0x10
+#define TEST_WAIT_EPT_SUB   0x20
+#define TEST_WAIT_QUEUE_LEN 4
+#define TEST_WAIT_HOLD_MS   50
+#define TEST_WAIT_TIMEOUT_MS 1000
+
+TEST_CASE("rpmsg create message blocks until subcore frees a buffer", "[esp_amp]")
+{
+    static esp_amp_rpmsg_dev_t rpmsg_dev;
+    static esp_amp_rpmsg_ept_t rpmsg_ept;
+
+    TEST_ASSERT_EQUAL_INT(0, esp_amp_init());
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_main_init(&rpmsg_dev, TEST_WAIT_QUEUE_LEN, 64, false, false));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_create_endpoint(&rpmsg_dev, TEST_WAIT_EPT_MAIN, NULL, NULL, &rpmsg_ept));
+    /* doorbell of freed buffers arrives as rpmsg software interrupt */
+    TEST_ASSERT_EQUAL_INT(0, esp_amp_rpmsg_intr_enable(&rpmsg_dev));
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_load_sub(subcore_rpmsg_wait_bin_start));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_start_subcore());
+
+    /* subcore holds all of them for TEST_WAIT_HOLD_MS */
+    for (int i = 0; i < TEST_WAIT_QUEUE_LEN; i++) {
+        void *msg = esp_amp_rpmsg_create_message(&rpmsg_dev, 4, ESP_AMP_RPMSG_DATA_DEFAULT);
+        TEST_ASSERT_NOT_NULL(msg);
+        TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send_nocopy(&rpmsg_dev, &rpmsg_ept, TEST_WAIT_EPT_SUB, msg, 4));
+    }
+
+    /* task sleeps on the wait queue and is woken up by the doorbell, well before timeout */
+    uint32_t start_ms = esp_amp_platform_get_time_ms();
+    void *msg = esp_amp_rpmsg_create_message_timeout(&rpmsg_dev, 4, ESP_AMP_RPMSG_DATA_DEFAULT, TEST_WAIT_TIMEOUT_MS);
+    uint32_t wait_ms = esp_amp_platform_get_time_ms() - start_ms;
+    printf("waited %"PRIu32" ms for a free buffer\n", wait_ms);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(TEST_WAIT_HOLD_MS - 1, wait_ms);
+    TEST_ASSERT_LESS_THAN_UINT32(TEST_WAIT_TIMEOUT_MS / 2, wait_ms);
+
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_send_nocopy(&rpmsg_dev, &rpmsg_ept, TEST_WAIT_EPT_SUB, msg, 4));
+    TEST_ASSERT_EQUAL(EVENT_SUBCORE_DONE, EVENT_SUBCORE_DONE & esp_amp_event_wait(EVENT_SUBCORE_DONE, true, true, 5000));
+}
@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_amp.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+#define SYS_INFO_ID_TEST_SHARED_VAR 0x0100
+#define TEST_SHARED_VAR_WORDS 16
+#define TEST_SHARED_VAR_WRITE_CNT 20000
+
+typedef struct {
+    uint32_t word[TEST_SHARED_VAR_WORDS];
+} test_sample_t;
+
+static esp_amp_shared_var_t test_var;
+static SemaphoreHandle_t writer_done;
+static volatile int writer_err_cnt;
+
+static void shared_var_writer_task(void *arg)
+{
+    test_sample_t sample;
+    for (uint32_t i = 1; i <= TEST_SHARED_VAR_WRITE_CNT; i++) {
+        for (int j = 0; j < TEST_SHARED_VAR_WORDS; j++) {
+            sample.word[j] = i;
+        }
+        if (esp_amp_shared_var_write(&test_var, &sample, sizeof(sample)) != ESP_OK) {
+            writer_err_cnt++;
+        }
+        /* same priority as reader, let it run in between so that tick preemption lands inside read or write */
+        taskYIELD();
+    }
+    xSemaphoreGive(writer_done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("shared variable write and read", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    test_sample_t sample;
+    uint32_t seq = 0;
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_amp_shared_var_main_init(&test_var, 0, SYS_INFO_ID_TEST_SHARED_VAR));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_amp_shared_var_main_init(&test_var, UINT16_MAX, SYS_INFO_ID_TEST_SHARED_VAR));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_shared_var_main_init(&test_var, sizeof(test_sample_t), SYS_INFO_ID_TEST_SHARED_VAR));
+
+    /* initial value is zero */
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_shared_var_read(&test_var, &sample, sizeof(sample), &seq));
+    TEST_ASSERT_EQUAL(0, seq);
+    TEST_ASSERT_EQUAL(0, sample.word[0]);
+
+    /* size mismatch is rejected */
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, esp_amp_shared_var_write(&test_var, &sample, sizeof(sample) - 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, esp_amp_shared_var_read(&test_var, &sample, sizeof(sample) + 1, NULL));
+
+    /* the other side of shared variable finds the same record via sysinfo */
+    esp_amp_shared_var_t reader;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_shared_var_sub_init(&reader, SYS_INFO_ID_TEST_SHARED_VAR));
+
+    for (int j = 0; j < TEST_SHARED_VAR_WORDS; j++) {
+        sample.word[j] = 0xdeadbeef;
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_shared_var_write(&test_var, &sample, sizeof(sample)));
+    memset(&sample, 0, sizeof(sample));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_shared_var_read(&reader, &sample, sizeof(sample), &seq));
+    TEST_ASSERT_EQUAL(2, seq);
+    TEST_ASSERT_EQUAL(2, esp_amp_shared_var_get_seq(&reader));
+    TEST_ASSERT_EQUAL_HEX32(0xdeadbeef, sample.word[TEST_SHARED_VAR_WORDS - 1]);
+
+    /* reader never observes a torn value while writer keeps updating */
+    writer_done = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(writer_done);
+    writer_err_cnt = 0;
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(shared_var_writer_task, "writer", 2048, NULL, uxTaskPriorityGet(NULL), NULL));
+
+    uint32_t last_seq = 0;
+    int read_cnt = 0;
+    while (xSemaphoreTake(writer_done, 0) != pdTRUE) {
+        TEST_ASSERT_EQUAL(ESP_OK, esp_amp_shared_var_read(&reader, &sample, sizeof(sample), &seq));
+        TEST_ASSERT_EQUAL(0, seq & 1);
+        TEST_ASSERT(seq >= last_seq);
+        for (int j = 1; j < TEST_SHARED_VAR_WORDS; j++) {
+            TEST_ASSERT_EQUAL(sample.word[0], sample.word[j]);
+        }
+        last_seq = seq;
+        read_cnt++;
+        taskYIELD();
+    }
+    printf("shared variable read %d consistent values\n", read_cnt);
+    TEST_ASSERT_EQUAL(0, writer_err_cnt);
+    TEST_ASSERT(read_cnt > 0);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_shared_var_read(&reader, &sample, sizeof(sample), &seq));
+    TEST_ASSERT_EQUAL(TEST_SHARED_VAR_WRITE_CNT, sample.word[0]);
+    TEST_ASSERT_EQUAL(2 + TEST_SHARED_VAR_WRITE_CNT * 2, seq);
+
+    vSemaphoreDelete(writer_done);
+}
@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_amp.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+#define TEST_STATIC_QUEUE_LEN 4
+#define TEST_STATIC_QUEUE_ITEM_SIZE 32
+
+typedef struct {
+    ESP_AMP_QUEUE_STATIC_T(TEST_STATIC_QUEUE_LEN, TEST_STATIC_QUEUE_ITEM_SIZE) cmd;
+    ESP_AMP_RPMSG_STATIC_T(4, 64) rpmsg;
+} test_static_layout_t;
+
+ESP_AMP_STATIC_LAYOUT_CHECK(test_static_layout_t);
+
+TEST_CASE("static queue needs no sys info lookup", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    test_static_layout_t *layout = ESP_AMP_STATIC_LAYOUT(test_static_layout_t);
+    TEST_ASSERT_EQUAL(TEST_STATIC_QUEUE_LEN, ESP_AMP_QUEUE_STATIC_LEN(&layout->cmd));
+    TEST_ASSERT_EQUAL(TEST_STATIC_QUEUE_ITEM_SIZE, ESP_AMP_QUEUE_STATIC_ITEM_SIZE(&layout->cmd));
+
+    /* static layout area does not overlap with sys info */
+    uint8_t *block = esp_amp_sys_info_alloc(0x0300, 16);
+    TEST_ASSERT_NOT_NULL(block);
+    TEST_ASSERT(block >= (uint8_t *)layout + sizeof(*layout) || block + 16 <= (uint8_t *)layout);
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(0x0300));
+
+    /* both ends of the same queue, as maincore and subcore would have */
+    esp_amp_queue_t master, remote;
+    TEST_ASSERT_EQUAL(ESP_OK, ESP_AMP_QUEUE_STATIC_INIT(&master, &layout->cmd, NULL, NULL, true));
+    TEST_ASSERT_EQUAL(ESP_OK, ESP_AMP_QUEUE_STATIC_INIT(&remote, &layout->cmd, NULL, NULL, false));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_amp_queue_static_init(&remote, &layout->cmd, 3, TEST_STATIC_QUEUE_ITEM_SIZE, NULL, NULL, false));
+
+    for (int i = 0; i < TEST_STATIC_QUEUE_LEN * 2; i++) {
+        void *buf = NULL;
+        uint16_t size = 0;
+        TEST_ASSERT_EQUAL(ESP_OK, esp_amp_queue_alloc_try(&master, &buf, TEST_STATIC_QUEUE_ITEM_SIZE));
+        TEST_ASSERT((uint8_t *)buf >= (uint8_t *)layout->cmd.buffer && (uint8_t *)buf < (uint8_t *)layout->cmd.buffer + sizeof(layout->cmd.buffer));
+        snprintf(buf, TEST_STATIC_QUEUE_ITEM_SIZE, "static %d", i);
+        TEST_ASSERT_EQUAL(ESP_OK, esp_amp_queue_send_try(&master, buf, TEST_STATIC_QUEUE_ITEM_SIZE));
+
+        TEST_ASSERT_EQUAL(ESP_OK, esp_amp_queue_recv_try(&remote, &buf, &size));
+        TEST_ASSERT_EQUAL(TEST_STATIC_QUEUE_ITEM_SIZE, size);
+        char expected[TEST_STATIC_QUEUE_ITEM_SIZE];
+        snprintf(expected, sizeof(expected), "static %d", i);
+        TEST_ASSERT_EQUAL_STRING(expected, buf);
+        TEST_ASSERT_EQUAL(ESP_OK, esp_amp_queue_free_try(&remote, buf));
+    }
+
+    static esp_amp_rpmsg_dev_t rpmsg_dev;
+    static esp_amp_queue_t rpmsg_vqueue[2];
+    TEST_ASSERT_EQUAL(0, ESP_AMP_RPMSG_STATIC_INIT(&rpmsg_dev, rpmsg_vqueue, &layout->rpmsg, false, true));
+    TEST_ASSERT_EQUAL(64, rpmsg_vqueue[0].max_item_size);
+    TEST_ASSERT_EQUAL_PTR(layout->rpmsg.vq[0].desc, rpmsg_vqueue[0].desc);
+    TEST_ASSERT_EQUAL_PTR(layout->rpmsg.vq[1].desc, rpmsg_vqueue[1].desc);
+}
+
+TEST_CASE("rpmsg sendv gathers fragments into one message", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    test_static_layout_t *layout = ESP_AMP_STATIC_LAYOUT(test_static_layout_t);
+    static esp_amp_rpmsg_dev_t rpmsg_dev;
+    static esp_amp_queue_t rpmsg_vqueue[2];
+    static esp_amp_rpmsg_ept_t ept;
+    TEST_ASSERT_EQUAL(0, ESP_AMP_RPMSG_STATIC_INIT(&rpmsg_dev, rpmsg_vqueue, &layout->rpmsg, false, true));
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_create_endpoint(&rpmsg_dev, 0x10, NULL, NULL, &ept));
+
+    /* receive end of main-core to sub-core virtqueue, as subcore would see it */
+    esp_amp_queue_t remote;
+    TEST_ASSERT_EQUAL(ESP_OK, ESP_AMP_QUEUE_STATIC_INIT(&remote, &layout->rpmsg.vq[0], NULL, NULL, false));
+
+    uint32_t hdr = 0x12345678;
+    char payload[] = "gathered";
+    esp_amp_rpmsg_iovec_t tx_iov[] = {
+        { .data = &hdr, .len = sizeof(hdr) },
+        { .data = NULL, .len = 0 },
+        { .data = payload, .len = sizeof(payload) },
+    };
+    TEST_ASSERT_EQUAL(0, esp_amp_rpmsg_sendv(&rpmsg_dev, &ept, 0x20, tx_iov, 3));
+
+    esp_amp_rpmsg_t *rpmsg = NULL;
+    uint16_t size = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_queue_recv_try(&remote, (void **)&rpmsg, &size));
+    TEST_ASSERT_EQUAL(0x10, rpmsg->msg_head.src_addr);
+    TEST_ASSERT_EQUAL(0x20, rpmsg->msg_head.dst_addr);
+    TEST_ASSERT_EQUAL(sizeof(hdr) + sizeof(payload), rpmsg->msg_head.data_len);
+
+    uint32_t rx_hdr = 0;
+    char rx_payload[sizeof(payload) + 4] = { 0 };
+    esp_amp_rpmsg_iovec_t rx_iov[] = {
+        { .data = &rx_hdr, .len = sizeof(rx_hdr) },
+        { .data = rx_payload, .len = sizeof(rx_payload) },
+    };
+    TEST_ASSERT_EQUAL(rpmsg->msg_head.data_len, esp_amp_rpmsg_scatter(rpmsg->msg_data, rpmsg->msg_head.data_len, rx_iov, 2));
+    TEST_ASSERT_EQUAL_HEX32(hdr, rx_hdr);
+    TEST_ASSERT_EQUAL_STRING(payload, rx_payload);
+
+    /* skip header, fragments shorter than message */
+    memset(rx_payload, 0, sizeof(rx_payload));
+    rx_iov[0].data = NULL;
+    rx_iov[1].len = 3;
+    TEST_ASSERT_EQUAL(sizeof(hdr) + 3, esp_amp_rpmsg_scatter(rpmsg->msg_data, rpmsg->msg_head.data_len, rx_iov, 2));
+    TEST_ASSERT_EQUAL_STRING("gat", rx_payload);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_queue_free_try(&remote, rpmsg));
+
+    /* total length larger than one message */
+    tx_iov[1].data = layout->rpmsg.vq[1].buffer;
+    tx_iov[1].len = esp_amp_rpmsg_get_max_size(&rpmsg_dev);
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_sendv(&rpmsg_dev, &ept, 0x20, tx_iov, 3));
+    TEST_ASSERT_EQUAL(-1, esp_amp_rpmsg_sendv(&rpmsg_dev, &ept, 0x20, tx_iov, 0));
+
+    TEST_ASSERT_NOT_NULL(esp_amp_rpmsg_delete_endpoint(&rpmsg_dev, 0x10));
+}
@@ -5,12 +5,16 @@
  */
 
 #include <stdio.h>
+#include <inttypes.h>
+#include <sys/param.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 
 #include "esp_log.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
 #include "esp_amp.h"
 
 #include "unity.h"
@@ -87,3 +91,195 @@ TEST_CASE("maincore & subcore can trigger software interrupt to each other", "[e
     uint8_t main_sw_intr_expect[4] = {0x10, 0x10, 0x10, 0x10};
     TEST_ASSERT_EQUAL_UINT8_ARRAY(main_sw_intr_expect, main_sw_intr_record, 4);
 }
+
+static uint8_t sw_intr_oneshot_cnt;
+static uint8_t sw_intr_after_oneshot_cnt;
+
+static IRAM_ATTR int sw_intr_oneshot_handler(void *arg)
+{
+    sw_intr_oneshot_cnt++;
+    esp_amp_sw_intr_delete_handler(SW_INTR_ID_1, sw_intr_oneshot_handler);
+    return 0;
+}
+
+static IRAM_ATTR int sw_intr_after_oneshot_handler(void *arg)
+{
+    sw_intr_after_oneshot_cnt++;
+    return 0;
+}
+
+TEST_CASE("software interrupt handler can delete itself", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    sw_intr_oneshot_cnt = 0;
+    sw_intr_after_oneshot_cnt = 0;
+    TEST_ASSERT(esp_amp_sw_intr_add_handler(SW_INTR_ID_1, sw_intr_oneshot_handler, NULL) == 0);
+    TEST_ASSERT(esp_amp_sw_intr_add_handler(SW_INTR_ID_1, sw_intr_after_oneshot_handler, NULL) == 0);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_load_sub(subcore_sw_intr_bin_start));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_start_subcore());
+    vTaskDelay(pdMS_TO_TICKS(1000)); /* wait for subcore to start */
+
+    /* subcore echoes SW_INTR_ID_1 back to maincore */
+    for (int i = 0; i < 3; i++) {
+        esp_amp_sw_intr_trigger(SW_INTR_ID_1);
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+
+    /* handler after the deleted one in the same chain still runs */
+    TEST_ASSERT_EQUAL(1, sw_intr_oneshot_cnt);
+    TEST_ASSERT_EQUAL(3, sw_intr_after_oneshot_cnt);
+
+    /* entry of deleted handler is reused */
+    TEST_ASSERT(esp_amp_sw_intr_add_handler(SW_INTR_ID_2, sw_intr_oneshot_handler, NULL) == 0);
+    esp_amp_sw_intr_delete_handler(SW_INTR_ID_2, sw_intr_oneshot_handler);
+}
+
+#define SW_INTR_BENCH_ROUNDS 1000
+
+static volatile uint32_t sw_intr_bench_flag;
+
+static IRAM_ATTR int sw_intr_bench_handler(void *arg)
+{
+    sw_intr_bench_flag = 1;
+    return 0;
+}
+
+static IRAM_ATTR int sw_intr_dummy_handler(void *arg)
+{
+    return 0;
+}
+
+/* round trip of SW_INTR_ID_0 echoed by subcore, return the shortest one as it is least disturbed */
+static uint32_t sw_intr_bench_round_trip(void)
+{
+    uint32_t total_cycles = 0;
+    uint32_t min_cycles = UINT32_MAX;
+    for (int i = 0; i < SW_INTR_BENCH_ROUNDS; i++) {
+        sw_intr_bench_flag = 0;
+        uint32_t start = esp_cpu_get_cycle_count();
+        esp_amp_sw_intr_trigger(SW_INTR_ID_0);
+        while (sw_intr_bench_flag == 0);
+        uint32_t cycles = esp_cpu_get_cycle_count() - start;
+        total_cycles += cycles;
+        min_cycles = MIN(min_cycles, cycles);
+    }
+    printf("software interrupt round trip: %"PRIu32" cycles on average, %"PRIu32" at least\n",
+           total_cycles / SW_INTR_BENCH_ROUNDS, min_cycles);
+    return min_cycles;
+}
+
+TEST_CASE("software interrupt dispatch cost does not depend on handler table size", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    TEST_ASSERT(esp_amp_sw_intr_add_handler(SW_INTR_ID_0, sw_intr_bench_handler, NULL) == 0);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_load_sub(subcore_sw_intr_bin_start));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_start_subcore());
+    vTaskDelay(pdMS_TO_TICKS(1000)); /* wait for subcore to start */
+
+    /* subcore echoes SW_INTR_ID_0 back to maincore */
+    uint32_t small_cycles = sw_intr_bench_round_trip();
+
+    /* fill the rest of handler table with handlers of ids never triggered */
+    int dummy_cnt = 0;
+    while (esp_amp_sw_intr_add_handler(SW_INTR_ID_4 + (dummy_cnt % 12), sw_intr_dummy_handler, NULL) == 0) {
+        dummy_cnt++;
+    }
+    printf("handler table len %d, %d dummy handlers registered\n", CONFIG_ESP_AMP_SW_INTR_HANDLER_TABLE_LEN, dummy_cnt);
+
+    /* deleting handlers makes room for new ones */
+    esp_amp_sw_intr_delete_handler(SW_INTR_ID_4, sw_intr_dummy_handler);
+    TEST_ASSERT(esp_amp_sw_intr_add_handler(SW_INTR_ID_4, sw_intr_dummy_handler, NULL) == 0);
+
+    /* only the chain of triggered id is walked, a full table costs no more than a nearly empty one */
+    uint32_t full_cycles = sw_intr_bench_round_trip();
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(small_cycles + small_cycles / 10, full_cycles);
+}
+
+#if CONFIG_ESP_AMP_SW_INTR_COALESCE
+TEST_CASE("software interrupt triggers are coalesced until peer core services them", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    /* subcore is not running, pending bits are never cleared */
+    uint32_t coalesced = esp_amp_sw_intr_get_coalesced_count();
+    esp_amp_sw_intr_trigger(SW_INTR_ID_5);
+    TEST_ASSERT_EQUAL(coalesced, esp_amp_sw_intr_get_coalesced_count());
+
+    for (int i = 0; i < 100; i++) {
+        esp_amp_sw_intr_trigger(SW_INTR_ID_5 + (i % 4));
+    }
+    TEST_ASSERT_EQUAL(coalesced + 100, esp_amp_sw_intr_get_coalesced_count());
+}
+#endif
+
+TEST_CASE("software interrupt priority class can be changed", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    TEST_ASSERT_EQUAL(SW_INTR_PRIO_HIGH, esp_amp_sw_intr_get_priority(SW_INTR_RESERVED_ID_EVENT));
+    TEST_ASSERT_EQUAL(SW_INTR_PRIO_HIGH, esp_amp_sw_intr_get_priority(SW_INTR_RESERVED_ID_PANIC));
+    TEST_ASSERT_EQUAL(SW_INTR_PRIO_NORMAL, esp_amp_sw_intr_get_priority(SW_INTR_RESERVED_ID_RPMSG));
+    TEST_ASSERT_EQUAL(SW_INTR_PRIO_NORMAL, esp_amp_sw_intr_get_priority(SW_INTR_ID_0));
+
+    TEST_ASSERT_EQUAL(0, esp_amp_sw_intr_set_priority(SW_INTR_ID_0, SW_INTR_PRIO_HIGH));
+    TEST_ASSERT_EQUAL(0, esp_amp_sw_intr_set_priority(SW_INTR_RESERVED_ID_RPMSG, SW_INTR_PRIO_LOW));
+    TEST_ASSERT_EQUAL(SW_INTR_PRIO_HIGH, esp_amp_sw_intr_get_priority(SW_INTR_ID_0));
+    TEST_ASSERT_EQUAL(SW_INTR_PRIO_LOW, esp_amp_sw_intr_get_priority(SW_INTR_RESERVED_ID_RPMSG));
+    TEST_ASSERT_EQUAL(-1, esp_amp_sw_intr_set_priority(SW_INTR_ID_0, (esp_amp_sw_intr_prio_t)3));
+    TEST_ASSERT_EQUAL(-1, esp_amp_sw_intr_set_priority((esp_amp_sw_intr_id_t)(SW_INTR_ID_MAX + 1), SW_INTR_PRIO_LOW));
+    TEST_ASSERT_EQUAL(-1, esp_amp_sw_intr_get_priority((esp_amp_sw_intr_id_t)(SW_INTR_ID_MAX + 1)));
+
+    /* restore defaults */
+    TEST_ASSERT_EQUAL(0, esp_amp_sw_intr_set_priority(SW_INTR_ID_0, SW_INTR_PRIO_NORMAL));
+    TEST_ASSERT_EQUAL(0, esp_amp_sw_intr_set_priority(SW_INTR_RESERVED_ID_RPMSG, SW_INTR_PRIO_NORMAL));
+}
+
+static int sw_intr_order[3];
+static int sw_intr_order_cnt;
+
+static IRAM_ATTR int sw_intr_order_handler(void *arg)
+{
+    if (sw_intr_order_cnt < 3) {
+        sw_intr_order[sw_intr_order_cnt] = (int)(intptr_t)arg;
+    }
+    sw_intr_order_cnt++;
+    return 0;
+}
+
+TEST_CASE("software interrupts are dispatched by priority class", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    /* lowest id of low class, then high class, then normal class */
+    TEST_ASSERT_EQUAL(0, esp_amp_sw_intr_set_priority(SW_INTR_ID_0, SW_INTR_PRIO_LOW));
+    TEST_ASSERT_EQUAL(0, esp_amp_sw_intr_set_priority(SW_INTR_ID_1, SW_INTR_PRIO_HIGH));
+    TEST_ASSERT(esp_amp_sw_intr_add_handler(SW_INTR_ID_0, sw_intr_order_handler, (void *)SW_INTR_ID_0) == 0);
+    TEST_ASSERT(esp_amp_sw_intr_add_handler(SW_INTR_ID_1, sw_intr_order_handler, (void *)SW_INTR_ID_1) == 0);
+    TEST_ASSERT(esp_amp_sw_intr_add_handler(SW_INTR_ID_2, sw_intr_order_handler, (void *)SW_INTR_ID_2) == 0);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_load_sub(subcore_sw_intr_bin_start));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_start_subcore());
+    vTaskDelay(pdMS_TO_TICKS(1000)); /* wait for subcore to start */
+
+    /* subcore triggers SW_INTR_ID_0/1/2 back on SW_INTR_ID_4. Keep interrupts masked until
+     * all of them are pending, so that they are dispatched in a single pass */
+    sw_intr_order_cnt = 0;
+    esp_amp_env_enter_critical();
+    esp_amp_sw_intr_trigger(SW_INTR_ID_4);
+    esp_rom_delay_us(10000);
+    esp_amp_env_exit_critical();
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    TEST_ASSERT_EQUAL(3, sw_intr_order_cnt);
+    TEST_ASSERT_EQUAL(SW_INTR_ID_1, sw_intr_order[0]);
+    TEST_ASSERT_EQUAL(SW_INTR_ID_2, sw_intr_order[1]);
+    TEST_ASSERT_EQUAL(SW_INTR_ID_0, sw_intr_order[2]);
+
+    /* restore defaults */
+    TEST_ASSERT_EQUAL(0, esp_amp_sw_intr_set_priority(SW_INTR_ID_0, SW_INTR_PRIO_NORMAL));
+    TEST_ASSERT_EQUAL(0, esp_amp_sw_intr_set_priority(SW_INTR_ID_1, SW_INTR_PRIO_NORMAL));
+}
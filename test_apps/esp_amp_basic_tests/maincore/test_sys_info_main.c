@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "sdkconfig.h"
+#include "esp_amp.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+#define SYS_INFO_ID_TEST_BASE 0x0200
+#define TEST_SYS_INFO_ENTRY_NUM 8
+
+TEST_CASE("sys info can be allocated, looked up and freed", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    uint16_t size = 0;
+    uint8_t *buf = esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_BASE, 100);
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_EQUAL(0, (uint32_t)buf & 0x3);
+    memset(buf, 0xa5, 100);
+
+    /* duplicate id is rejected */
+    TEST_ASSERT_NULL(esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_BASE, 16));
+
+    TEST_ASSERT_EQUAL_PTR(buf, esp_amp_sys_info_get(SYS_INFO_ID_TEST_BASE, &size));
+    TEST_ASSERT_EQUAL(100, size);
+
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE));
+    TEST_ASSERT_NULL(esp_amp_sys_info_get(SYS_INFO_ID_TEST_BASE, NULL));
+    TEST_ASSERT_EQUAL(-1, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE));
+
+    /* ids marking empty and deleted slots are never found, nor allocated */
+    TEST_ASSERT_NULL(esp_amp_sys_info_alloc(0xffff, 16));
+    TEST_ASSERT_NULL(esp_amp_sys_info_alloc(0xfffe, 16));
+    TEST_ASSERT_NULL(esp_amp_sys_info_get(0xffff, NULL));
+    TEST_ASSERT_NULL(esp_amp_sys_info_get(0xfffe, NULL));
+    TEST_ASSERT_EQUAL(-1, esp_amp_sys_info_free(0xffff));
+    TEST_ASSERT_EQUAL(-1, esp_amp_sys_info_free(0xfffe));
+
+    /* the same id can be allocated again after free */
+    TEST_ASSERT_NOT_NULL(esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_BASE, 32));
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE));
+}
+
+TEST_CASE("sys info memory is reclaimed after free", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    esp_amp_sys_info_mem_info_t before, during, after;
+    esp_amp_sys_info_get_mem_info(&before);
+    printf("sys info total:%"PRIu32" free:%"PRIu32" largest:%"PRIu32" max_used:%"PRIu32"\n",
+           before.total, before.free, before.largest_free_block, before.max_used);
+    TEST_ASSERT(before.largest_free_block <= before.free);
+
+    /* create and tear down channels repeatedly, memory must not leak */
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < TEST_SYS_INFO_ENTRY_NUM; i++) {
+            TEST_ASSERT_NOT_NULL(esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_BASE + i, 64 + 32 * i));
+        }
+        /* free every other entry to fragment the pool, then the rest */
+        for (int i = 0; i < TEST_SYS_INFO_ENTRY_NUM; i += 2) {
+            TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE + i));
+        }
+        esp_amp_sys_info_get_mem_info(&during);
+        TEST_ASSERT(during.free < before.free);
+        for (int i = 1; i < TEST_SYS_INFO_ENTRY_NUM; i += 2) {
+            TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE + i));
+        }
+    }
+
+    esp_amp_sys_info_get_mem_info(&after);
+    TEST_ASSERT_EQUAL(before.free, after.free);
+    TEST_ASSERT_EQUAL(before.largest_free_block, after.largest_free_block);
+    TEST_ASSERT(after.max_used > before.max_used);
+
+    /* the largest free block can be allocated as a whole */
+    void *big = esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_BASE, after.largest_free_block > UINT16_MAX ? UINT16_MAX : after.largest_free_block);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE));
+}
+
+#define TEST_BULK_REGION_SIZE (96 * 1024)
+
+TEST_CASE("sys info can allocate large blocks from extra regions", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    uint8_t *region = malloc(TEST_BULK_REGION_SIZE);
+    TEST_ASSERT_NOT_NULL(region);
+
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_add_region(region, TEST_BULK_REGION_SIZE, ESP_AMP_SYS_INFO_CAP_BULK));
+    /* overlapping region is rejected */
+    TEST_ASSERT_EQUAL(-1, esp_amp_sys_info_add_region(region + 1024, 1024, ESP_AMP_SYS_INFO_CAP_BULK));
+
+    /* block larger than 64KB */
+    uint32_t big_size = 80 * 1024;
+    uint8_t *big = esp_amp_sys_info_alloc_with_caps(SYS_INFO_ID_TEST_BASE, big_size, ESP_AMP_SYS_INFO_CAP_BULK);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT(big >= region && big + big_size <= region + TEST_BULK_REGION_SIZE);
+    memset(big, 0x5a, big_size);
+
+    uint32_t size = 0, caps = 0;
+    TEST_ASSERT_EQUAL_PTR(big, esp_amp_sys_info_get_with_caps(SYS_INFO_ID_TEST_BASE, &size, &caps));
+    TEST_ASSERT_EQUAL(big_size, size);
+    TEST_ASSERT(caps & ESP_AMP_SYS_INFO_CAP_BULK);
+
+    /* legacy api clamps size */
+    uint16_t size16 = 0;
+    TEST_ASSERT_EQUAL_PTR(big, esp_amp_sys_info_get(SYS_INFO_ID_TEST_BASE, &size16));
+    TEST_ASSERT_EQUAL(UINT16_MAX, size16);
+
+    /* default allocation still comes from control region */
+    uint8_t *ctrl = esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_BASE + 1, 64);
+    TEST_ASSERT_NOT_NULL(ctrl);
+    TEST_ASSERT(ctrl < region || ctrl >= region + TEST_BULK_REGION_SIZE);
+    TEST_ASSERT_EQUAL_PTR(ctrl, esp_amp_sys_info_get_with_caps(SYS_INFO_ID_TEST_BASE + 1, NULL, &caps));
+    TEST_ASSERT(caps & ESP_AMP_SYS_INFO_CAP_CONTROL);
+
+    esp_amp_sys_info_mem_info_t info;
+    esp_amp_sys_info_get_mem_info_with_caps(ESP_AMP_SYS_INFO_CAP_BULK, &info);
+    TEST_ASSERT(info.total >= big_size);
+    TEST_ASSERT(info.free < TEST_BULK_REGION_SIZE - big_size);
+
+    /* no region provides both control and bulk caps */
+    TEST_ASSERT_NULL(esp_amp_sys_info_alloc_with_caps(SYS_INFO_ID_TEST_BASE + 2, 16, ESP_AMP_SYS_INFO_CAP_CONTROL | ESP_AMP_SYS_INFO_CAP_BULK));
+
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE));
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE + 1));
+}
+
+TEST_CASE("sys info control region reports atomic capability by location", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    uint32_t caps = 0;
+    TEST_ASSERT_NOT_NULL(esp_amp_sys_info_alloc(SYS_INFO_ID_TEST_BASE, 16));
+    TEST_ASSERT_NOT_NULL(esp_amp_sys_info_get_with_caps(SYS_INFO_ID_TEST_BASE, NULL, &caps));
+    TEST_ASSERT(caps & ESP_AMP_SYS_INFO_CAP_CONTROL);
+#if CONFIG_ESP_AMP_SHARED_MEM_IN_LP
+    /* RTC RAM has no atomic read-modify-write */
+    TEST_ASSERT_FALSE(caps & ESP_AMP_SYS_INFO_CAP_ATOMIC);
+#else
+    TEST_ASSERT(caps & ESP_AMP_SYS_INFO_CAP_ATOMIC);
+
+    /* objects relying on atomics are allocated from control region as before */
+    void *atomic_buf = esp_amp_sys_info_alloc_with_caps(SYS_INFO_ID_TEST_BASE + 1, 16, ESP_AMP_SYS_INFO_CAP_ATOMIC);
+    TEST_ASSERT_NOT_NULL(atomic_buf);
+    TEST_ASSERT_NOT_NULL(esp_amp_sys_info_get_with_caps(SYS_INFO_ID_TEST_BASE + 1, NULL, &caps));
+    TEST_ASSERT(caps & ESP_AMP_SYS_INFO_CAP_CONTROL);
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE + 1));
+#endif
+
+    TEST_ASSERT_EQUAL(0, esp_amp_sys_info_free(SYS_INFO_ID_TEST_BASE));
+}
@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_amp.h"
+#include "esp_err.h"
+#include "stdatomic.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+extern const uint8_t subcore_sys_service_test_bin_start[] asm("_binary_subcore_test_sys_service_bin_start");
+extern const uint8_t subcore_sys_service_test_bin_end[]   asm("_binary_subcore_test_sys_service_bin_end");
+
+#define SYS_INFO_ID_TEST_BITS 0x0000
+#define EVENT_SUBCORE_DONE    (1 << 0)
+
+#define TEST_SRV_ID_ECHO       1
+#define TEST_SRV_ID_UNHANDLED  2
+#define TEST_BURST_NUM         14
+#define TEST_UNHANDLED_NUM     3
+
+#define TEST_BURST (1 << 0)
+#define TEST_UNHANDLED (1 << 1)
+#define TEST_INVALID (1 << 2)
+#define TEST_ALL (TEST_BURST | TEST_UNHANDLED | TEST_INVALID)
+
+static struct {
+    int next_seq;
+    int bad_num;
+} s_echo_ctx;
+
+static void echo_handler(void *param, uint16_t param_len, void *arg)
+{
+    uint8_t *data = (uint8_t *)param;
+    int seq = s_echo_ctx.next_seq++;
+
+    if (arg != &s_echo_ctx || param_len != seq + 1) {
+        s_echo_ctx.bad_num++;
+        return;
+    }
+    for (int i = 0; i < param_len; i++) {
+        if (data[i] != seq) {
+            s_echo_ctx.bad_num++;
+            return;
+        }
+    }
+
+    /* hold supplicant on the first request so that the rest of the burst piles up in queue */
+    if (seq == 0) {
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+}
+
+static void dummy_handler(void *param, uint16_t param_len, void *arg)
+{
+}
+
+TEST_CASE("system service registration", "[esp_amp]")
+{
+    esp_amp_system_service_stats_t stats;
+
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    /* invalid id or handler */
+    TEST_ASSERT_EQUAL(-1, esp_amp_system_service_register(CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN, dummy_handler, NULL));
+    TEST_ASSERT_EQUAL(-1, esp_amp_system_service_register(TEST_SRV_ID_ECHO, NULL, NULL));
+    TEST_ASSERT_EQUAL(-1, esp_amp_system_service_unregister(CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN));
+    TEST_ASSERT_EQUAL(-1, esp_amp_system_service_get_stats(CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN, &stats));
+    TEST_ASSERT_EQUAL(-1, esp_amp_system_service_get_stats(TEST_SRV_ID_ECHO, NULL));
+
+    /* file proxy owns its id */
+    TEST_ASSERT_EQUAL(-1, esp_amp_system_service_register(ESP_AMP_SYSTEM_SERVICE_ID_FILE_PROXY, dummy_handler, NULL));
+
+    /* duplicate registration */
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_register(TEST_SRV_ID_ECHO, dummy_handler, NULL));
+    TEST_ASSERT_EQUAL(-1, esp_amp_system_service_register(TEST_SRV_ID_ECHO, dummy_handler, NULL));
+
+    /* unregister and register again */
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_unregister(TEST_SRV_ID_ECHO));
+    TEST_ASSERT_EQUAL(-1, esp_amp_system_service_unregister(TEST_SRV_ID_ECHO));
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_register(TEST_SRV_ID_ECHO, dummy_handler, NULL));
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_unregister(TEST_SRV_ID_ECHO));
+}
+
+TEST_CASE("subcore requests are dispatched to system service handlers", "[esp_amp]")
+{
+    esp_amp_system_service_stats_t stats;
+    uint32_t burst_bytes = 0;
+
+    for (int i = 0; i < TEST_BURST_NUM; i++) {
+        burst_bytes += i + 1;
+    }
+    memset(&s_echo_ctx, 0, sizeof(s_echo_ctx));
+
+    TEST_ASSERT(esp_amp_init() == 0);
+    atomic_uint *test_bits = (atomic_uint *)esp_amp_sys_info_alloc_with_caps(SYS_INFO_ID_TEST_BITS, sizeof(uint32_t), ESP_AMP_SYS_INFO_CAP_ATOMIC);
+    TEST_ASSERT_NOT_NULL(test_bits);
+    atomic_init(test_bits, 0);
+
+    /* requests to a service unregistered before subcore starts are counted as unhandled */
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_register(TEST_SRV_ID_UNHANDLED, dummy_handler, NULL));
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_unregister(TEST_SRV_ID_UNHANDLED));
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_register(TEST_SRV_ID_ECHO, echo_handler, &s_echo_ctx));
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_load_sub(subcore_sys_service_test_bin_start));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_start_subcore());
+
+    TEST_ASSERT_EQUAL(EVENT_SUBCORE_DONE, EVENT_SUBCORE_DONE & esp_amp_event_wait(EVENT_SUBCORE_DONE, true, true, 5000));
+
+    uint32_t test_bits_val = atomic_load(test_bits);
+    printf("test_bits = %lu\n", test_bits_val);
+    TEST_ASSERT_EQUAL(TEST_ALL, test_bits_val);
+
+    /* subcore is done sending, wait for supplicant to drain the rest */
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL(0, esp_amp_system_service_get_stats(TEST_SRV_ID_UNHANDLED, &stats));
+        if (stats.unhandled_num == TEST_UNHANDLED_NUM) {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    TEST_ASSERT_EQUAL(0, stats.req_num);
+    TEST_ASSERT_EQUAL(TEST_UNHANDLED_NUM, stats.unhandled_num);
+
+    /* every request of the burst is handled once and in order */
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_get_stats(TEST_SRV_ID_ECHO, &stats));
+    printf("echo requests: %"PRIu32", bytes: %"PRIu32", max cycles: %"PRIu32"\n", stats.req_num, stats.req_bytes, stats.max_cycles);
+    TEST_ASSERT_EQUAL(TEST_BURST_NUM, stats.req_num);
+    TEST_ASSERT_EQUAL(burst_bytes, stats.req_bytes);
+    TEST_ASSERT_EQUAL(0, stats.unhandled_num);
+    TEST_ASSERT_EQUAL(TEST_BURST_NUM, s_echo_ctx.next_seq);
+    TEST_ASSERT_EQUAL(0, s_echo_ctx.bad_num);
+
+    TEST_ASSERT_EQUAL(0, esp_amp_system_service_unregister(TEST_SRV_ID_ECHO));
+}
@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_amp.h"
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+#define SYS_INFO_ID_TEST_TRIPLE_BUF 0x0101
+#define TEST_TRIPLE_BUF_WORDS 64
+#define TEST_TRIPLE_BUF_PUBLISH_CNT 20000
+
+static esp_amp_triple_buf_t test_producer;
+static SemaphoreHandle_t producer_done;
+
+static void triple_buf_producer_task(void *arg)
+{
+    for (uint32_t i = 1; i <= TEST_TRIPLE_BUF_PUBLISH_CNT; i++) {
+        uint32_t *block = esp_amp_triple_buf_get_write_buf(&test_producer);
+        for (int j = 0; j < TEST_TRIPLE_BUF_WORDS; j++) {
+            block[j] = i;
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, esp_amp_triple_buf_publish(&test_producer));
+        if ((i & 0xff) == 0) {
+            vTaskDelay(1);
+        }
+    }
+    xSemaphoreGive(producer_done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("triple buffer publish and acquire", "[esp_amp]")
+{
+    TEST_ASSERT(esp_amp_init() == 0);
+
+    esp_amp_triple_buf_t consumer;
+    uint32_t *block = NULL;
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_triple_buf_main_init(&test_producer, sizeof(uint32_t) * TEST_TRIPLE_BUF_WORDS, true, SYS_INFO_ID_TEST_TRIPLE_BUF));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_triple_buf_sub_init(&consumer, false, SYS_INFO_ID_TEST_TRIPLE_BUF));
+    TEST_ASSERT_EQUAL(sizeof(uint32_t) * TEST_TRIPLE_BUF_WORDS, esp_amp_triple_buf_get_slot_size(&consumer));
+
+    /* roles are enforced */
+    TEST_ASSERT_NULL(esp_amp_triple_buf_get_write_buf(&consumer));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, esp_amp_triple_buf_publish(&consumer));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, esp_amp_triple_buf_acquire(&test_producer, (void **)&block));
+
+    /* nothing published yet */
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, esp_amp_triple_buf_acquire(&consumer, (void **)&block));
+    TEST_ASSERT_NOT_NULL(block);
+
+    /* consumer always gets the latest block, older ones are overwritten */
+    for (uint32_t i = 1; i <= 3; i++) {
+        uint32_t *wr = esp_amp_triple_buf_get_write_buf(&test_producer);
+        wr[0] = i;
+        TEST_ASSERT_EQUAL(ESP_OK, esp_amp_triple_buf_publish(&test_producer));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, esp_amp_triple_buf_acquire(&consumer, (void **)&block));
+    TEST_ASSERT_EQUAL(3, block[0]);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, esp_amp_triple_buf_acquire(&consumer, (void **)&block));
+    TEST_ASSERT_EQUAL(3, block[0]);
+
+    /* producer never writes the slot held by consumer */
+    producer_done = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(producer_done);
+    xTaskCreate(triple_buf_producer_task, "producer", 2048, NULL, configMAX_PRIORITIES - 1, NULL);
+
+    uint32_t last = 0;
+    int acquire_cnt = 0;
+    while (xSemaphoreTake(producer_done, 0) != pdTRUE) {
+        if (esp_amp_triple_buf_acquire(&consumer, (void **)&block) != ESP_OK) {
+            continue;
+        }
+        TEST_ASSERT(block[0] > last);
+        for (int j = 1; j < TEST_TRIPLE_BUF_WORDS; j++) {
+            TEST_ASSERT_EQUAL(block[0], block[j]);
+        }
+        last = block[0];
+        acquire_cnt++;
+    }
+    printf("triple buffer acquired %d blocks\n", acquire_cnt);
+
+    /* either the last block is acquired now or it was acquired in the loop */
+    esp_amp_triple_buf_acquire(&consumer, (void **)&block);
+    TEST_ASSERT_EQUAL(TEST_TRIPLE_BUF_PUBLISH_CNT, block[0]);
+
+    vSemaphoreDelete(producer_done);
+}
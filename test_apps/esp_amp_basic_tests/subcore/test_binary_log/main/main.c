@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
+
+#include "esp_amp.h"
+#include "esp_amp_system.h"
+
+#define SYS_INFO_ID_TEST_LOG_SYNC 0x0107
+#define EVENT_SUBCORE_DONE        (1 << 0)
+
+/* 300 chars, format string too long for maincore to read */
+#define TEST_STR_10   "0123456789"
+#define TEST_STR_100  TEST_STR_10 TEST_STR_10 TEST_STR_10 TEST_STR_10 TEST_STR_10 \
+                      TEST_STR_10 TEST_STR_10 TEST_STR_10 TEST_STR_10 TEST_STR_10
+#define TEST_STR_LONG TEST_STR_100 TEST_STR_100 TEST_STR_100
+
+static atomic_uint *log_sync = NULL;
+static unsigned int s_step = 0;
+
+/* log_sync is the number of steps maincore is ready to receive */
+static void wait_step(void)
+{
+    while (s_step >= atomic_load(log_sync));
+    s_step++;
+}
+
+/* print the same line with binary log and with text print */
+#define TEST_PRINT_PAIR(...) do { \
+        wait_step(); \
+        esp_amp_subcore_binary_log_enable(true); \
+        printf(__VA_ARGS__); \
+        esp_amp_subcore_binary_log_enable(false); \
+        printf(__VA_ARGS__); \
+    } while (0)
+
+int main(void)
+{
+    printf("Hello!!\r\n");
+
+    assert(esp_amp_init() == 0);
+    log_sync = (atomic_uint *)esp_amp_sys_info_get(SYS_INFO_ID_TEST_LOG_SYNC, NULL);
+    assert(log_sync != NULL);
+
+    /* conversion specs rebuilt on maincore */
+    TEST_PRINT_PAIR("spec: [%-6d] [%06x] [%6u] [%.3s] [%5s] [%05d]\n", -42, 0xbeef, 7u, "abcdef", "ab", -3);
+    TEST_PRINT_PAIR("ll: %lld %llu %llx %lx %ld\n", -1234567890123LL, 18446744073709551615ULL,
+                    0x123456789abcdefULL, 0xdeadbeefUL, -5L);
+    TEST_PRINT_PAIR("str %s, chr %c%c, pct 100%%, ptr %p\n", "abc", 'A', 'z', (void *)0x4ff12345);
+    /* longest conversion spec maincore rebuilds, and one char longer sent as text */
+    TEST_PRINT_PAIR("prec [%.0000000003s]\n", "abcdef");
+    TEST_PRINT_PAIR("long prec [%.00000000003s]\n", "abcdef");
+    /* maincore decodes a cut-off copy of this record */
+    TEST_PRINT_PAIR("cut %d %s %d end\n", 1, "middle", 2);
+
+    /* sent as text even with binary log enabled */
+    wait_step();
+    esp_amp_subcore_binary_log_enable(true);
+    printf(TEST_STR_LONG "\n");
+
+    esp_amp_event_notify(EVENT_SUBCORE_DONE);
+    while (1);
+
+    printf("Bye!!\r\n");
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "esp_amp.h"
+#include "esp_amp_system.h"
+
+#define SYS_INFO_ID_TEST_BITS 0x0000
+#define EVENT_SUBCORE_DONE    (1 << 0)
+
+#define TEST_FILE_PATH  "/fake/log.txt"
+#define TEST_FULL_PATH  "/fake/full.txt"  /* every write fails with ENOSPC */
+#define TEST_LINE_NUM   64
+#define TEST_LINE_LEN   8   /* "line XX\n" */
+
+#define TEST_WRITE (1 << 0)
+#define TEST_READ (1 << 1)
+#define TEST_READ_SHARED (1 << 2)
+#define TEST_ERROR (1 << 3)
+#define TEST_PENDING_ERROR (1 << 4)
+#define TEST_ALL (TEST_WRITE | TEST_READ | TEST_READ_SHARED | TEST_ERROR | TEST_PENDING_ERROR)
+
+static atomic_uint *test_bits = NULL;
+
+static void make_line(char *line, int i)
+{
+    memcpy(line, "line ", 5);
+    line[5] = '0' + i / 10;
+    line[6] = '0' + i % 10;
+    line[7] = '\n';
+}
+
+static void test_write(void)
+{
+    char line[TEST_LINE_LEN];
+    struct stat st;
+
+    int fd = open(TEST_FILE_PATH, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    assert(fd >= 0);
+
+    /* small writes are batched and written by maincore at once */
+    for (int i = 0; i < TEST_LINE_NUM; i++) {
+        make_line(line, i);
+        assert(write(fd, line, TEST_LINE_LEN) == TEST_LINE_LEN);
+    }
+    assert(esp_amp_subcore_file_flush() == 0);
+
+    assert(fstat(fd, &st) == 0);
+    assert(S_ISREG(st.st_mode));
+    assert(st.st_size == TEST_LINE_NUM * TEST_LINE_LEN);
+    assert(close(fd) == 0);
+
+    atomic_fetch_or(test_bits, TEST_WRITE);
+}
+
+static void test_read(void)
+{
+    char buf[TEST_LINE_LEN * 4];
+    char line[TEST_LINE_LEN];
+
+    int fd = open(TEST_FILE_PATH, O_RDONLY);
+    assert(fd >= 0);
+
+    assert(read(fd, buf, sizeof(buf)) == sizeof(buf));
+    for (int i = 0; i < 4; i++) {
+        make_line(line, i);
+        assert(memcmp(buf + i * TEST_LINE_LEN, line, TEST_LINE_LEN) == 0);
+    }
+
+    /* read at end of file */
+    assert(lseek(fd, 0, SEEK_END) == TEST_LINE_NUM * TEST_LINE_LEN);
+    assert(read(fd, buf, sizeof(buf)) == 0);
+    assert(close(fd) == 0);
+
+    atomic_fetch_or(test_bits, TEST_READ);
+}
+
+static void test_read_shared(void)
+{
+    const char *data;
+    char line[TEST_LINE_LEN];
+
+    int fd = open(TEST_FILE_PATH, O_RDONLY);
+    assert(fd >= 0);
+
+    /* data is read into shared memory by maincore and used in place */
+    assert(lseek(fd, 10 * TEST_LINE_LEN, SEEK_SET) == 10 * TEST_LINE_LEN);
+    assert(esp_amp_subcore_file_read_shared(fd, 2 * TEST_LINE_LEN, (const void **)&data) == 2 * TEST_LINE_LEN);
+    make_line(line, 10);
+    assert(memcmp(data, line, TEST_LINE_LEN) == 0);
+    make_line(line, 11);
+    assert(memcmp(data + TEST_LINE_LEN, line, TEST_LINE_LEN) == 0);
+    assert(close(fd) == 0);
+
+    atomic_fetch_or(test_bits, TEST_READ_SHARED);
+}
+
+static void test_error(void)
+{
+    char line[TEST_LINE_LEN];
+
+    assert(open("/fake/missing.txt", O_RDONLY) == -1);
+    assert(errno == ENOENT);
+
+    int fd = open(TEST_FILE_PATH, O_RDONLY);
+    assert(fd >= 0);
+    assert(close(fd) == 0);
+
+    make_line(line, 0);
+    assert(write(fd, line, TEST_LINE_LEN) == -1);
+    assert(errno == EBADF);
+    assert(close(fd) == -1);
+
+    atomic_fetch_or(test_bits, TEST_ERROR);
+}
+
+static void test_pending_error(void)
+{
+    char line[TEST_LINE_LEN];
+
+    int full_fd = open(TEST_FULL_PATH, O_WRONLY);
+    assert(full_fd >= 0);
+    int fd = open(TEST_FILE_PATH, O_RDONLY);
+    assert(fd >= 0);
+
+    /* batched data of full file fails to be written when the other file is used, which is not affected */
+    make_line(line, 0);
+    assert(write(full_fd, line, TEST_LINE_LEN) == TEST_LINE_LEN);
+    assert(lseek(fd, 0, SEEK_SET) == 0);
+
+    /* error is reported by next write of full file */
+    assert(write(full_fd, line, TEST_LINE_LEN) == -1);
+    assert(errno == ENOSPC);
+
+    /* or by flush, only once */
+    assert(write(full_fd, line, TEST_LINE_LEN) == TEST_LINE_LEN);
+    assert(esp_amp_subcore_file_flush() == -1);
+    assert(errno == ENOSPC);
+    assert(esp_amp_subcore_file_flush() == 0);
+
+    /* or by close */
+    assert(write(full_fd, line, TEST_LINE_LEN) == TEST_LINE_LEN);
+    assert(read(fd, line, TEST_LINE_LEN) == TEST_LINE_LEN);
+    assert(close(full_fd) == -1);
+    assert(errno == ENOSPC);
+    assert(close(fd) == 0);
+
+    atomic_fetch_or(test_bits, TEST_PENDING_ERROR);
+}
+
+int main(void)
+{
+    printf("Hello!!\r\n");
+
+    assert(esp_amp_init() == 0);
+    test_bits = (atomic_uint *)esp_amp_sys_info_get(SYS_INFO_ID_TEST_BITS, NULL);
+    assert(test_bits != NULL);
+
+    test_write();
+    test_read();
+    test_read_shared();
+    test_error();
+    test_pending_error();
+
+    esp_amp_event_notify(EVENT_SUBCORE_DONE);
+    while (1);
+
+    printf("Bye!!\r\n");
+    return 0;
+}
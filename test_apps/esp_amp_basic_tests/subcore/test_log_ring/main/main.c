@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
+
+#include "esp_amp.h"
+#include "esp_amp_system.h"
+
+#define SYS_INFO_ID_TEST_BITS     0x0000
+#define SYS_INFO_ID_TEST_LOG_SYNC 0x0105
+#define SYS_INFO_ID_TEST_LOG_CYCLES 0x0106
+#define EVENT_SUBCORE_DONE        (1 << 0)
+
+#define TEST_FULL_LINE_NUM  64  /* more lines than log ring can hold */
+#define TEST_WRAP_LINE_NUM  128 /* lines wrapping around log ring several times */
+
+#define TEST_LOG_FULL (1 << 0)
+#define TEST_LOG_WRAP (1 << 1)
+
+static atomic_uint *test_bits = NULL;
+static atomic_uint *log_sync = NULL;
+static uint32_t *log_cycles = NULL;
+
+static void test_log_full(void)
+{
+    /* maincore does not drain log ring now, lines not fitting into it are dropped without waiting */
+    uint64_t start = esp_amp_arch_get_cpu_cycle();
+    for (int i = 0; i < TEST_FULL_LINE_NUM; i++) {
+        printf("log %03d\n", i);
+    }
+    *log_cycles = (uint32_t)((esp_amp_arch_get_cpu_cycle() - start) / TEST_FULL_LINE_NUM);
+
+    atomic_fetch_or(test_bits, TEST_LOG_FULL);
+}
+
+static void test_log_wrap(void)
+{
+    /* log_sync is the number of lines maincore is ready to receive */
+    for (int i = TEST_FULL_LINE_NUM; i < TEST_FULL_LINE_NUM + TEST_WRAP_LINE_NUM; i++) {
+        while (i >= atomic_load(log_sync));
+        printf("log %03d\n", i);
+    }
+
+    atomic_fetch_or(test_bits, TEST_LOG_WRAP);
+}
+
+int main(void)
+{
+    printf("Hello!!\r\n");
+
+    assert(esp_amp_init() == 0);
+    test_bits = (atomic_uint *)esp_amp_sys_info_get(SYS_INFO_ID_TEST_BITS, NULL);
+    assert(test_bits != NULL);
+    log_sync = (atomic_uint *)esp_amp_sys_info_get(SYS_INFO_ID_TEST_LOG_SYNC, NULL);
+    assert(log_sync != NULL);
+    log_cycles = (uint32_t *)esp_amp_sys_info_get(SYS_INFO_ID_TEST_LOG_CYCLES, NULL);
+    assert(log_cycles != NULL);
+
+#if CONFIG_ESP_AMP_SUBCORE_BINARY_LOG
+    /* lines are counted and their lengths checked as text records */
+    esp_amp_subcore_binary_log_enable(false);
+#endif
+
+    test_log_full();
+    test_log_wrap();
+
+    esp_amp_event_notify(EVENT_SUBCORE_DONE);
+    while (1);
+
+    printf("Bye!!\r\n");
+    return 0;
+}
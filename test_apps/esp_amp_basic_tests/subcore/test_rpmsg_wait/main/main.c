@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "esp_amp.h"
+
+#define EVENT_SUBCORE_DONE  (1 << 0)
+
+#define TEST_EPT_SUB        0x20
+#define TEST_QUEUE_LEN      4
+#define TEST_HOLD_MS        50   /* time all buffers are held by subcore */
+
+static esp_amp_rpmsg_dev_t rpmsg_dev;
+static esp_amp_rpmsg_ept_t rpmsg_ept;
+
+static void *held[TEST_QUEUE_LEN];
+static int rx_cnt = 0;
+
+static int ept_cb(void* msg_data, uint16_t data_len, uint16_t src_addr, void* rx_cb_data)
+{
+    if (rx_cnt < TEST_QUEUE_LEN) {
+        held[rx_cnt] = msg_data;
+    } else {
+        esp_amp_rpmsg_destroy(&rpmsg_dev, msg_data);
+    }
+    rx_cnt++;
+    return 0;
+}
+
+int main(void)
+{
+    printf("Hello!!\r\n");
+
+    assert(esp_amp_init() == 0);
+    /* notify is required to ring the doorbell when giving back buffers */
+    assert(esp_amp_rpmsg_sub_init(&rpmsg_dev, true, true) == 0);
+    assert(esp_amp_rpmsg_create_endpoint(&rpmsg_dev, TEST_EPT_SUB, ept_cb, NULL, &rpmsg_ept) != NULL);
+
+    /* hold every buffer, so that maincore has to wait for one */
+    while (rx_cnt < TEST_QUEUE_LEN) {
+        esp_amp_rpmsg_poll(&rpmsg_dev);
+    }
+    esp_amp_platform_delay_us(TEST_HOLD_MS * 1000);
+    for (int i = 0; i < TEST_QUEUE_LEN; i++) {
+        esp_amp_rpmsg_destroy(&rpmsg_dev, held[i]);
+    }
+
+    /* message sent by maincore after waking up */
+    while (rx_cnt < TEST_QUEUE_LEN + 1) {
+        esp_amp_rpmsg_poll(&rpmsg_dev);
+    }
+
+    esp_amp_event_notify(EVENT_SUBCORE_DONE);
+    while (1);
+
+    printf("Bye!!\r\n");
+    return 0;
+}
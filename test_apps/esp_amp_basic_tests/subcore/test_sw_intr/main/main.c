@@ -34,6 +34,15 @@ static int sw_intr_id3_handler(void *arg)
     return 0;
 }
 
+/* trigger interrupts of different priority classes on maincore at once */
+static int sw_intr_id4_handler(void *arg)
+{
+    esp_amp_sw_intr_trigger(SW_INTR_ID_0);
+    esp_amp_sw_intr_trigger(SW_INTR_ID_1);
+    esp_amp_sw_intr_trigger(SW_INTR_ID_2);
+    return 0;
+}
+
 int main(void)
 {
     printf("Hello!!\r\n");
@@ -43,6 +52,7 @@ int main(void)
     assert(esp_amp_sw_intr_add_handler(SW_INTR_ID_1, sw_intr_id1_handler, NULL) == 0);
     assert(esp_amp_sw_intr_add_handler(SW_INTR_ID_2, sw_intr_id2_handler, NULL) == 0);
     assert(esp_amp_sw_intr_add_handler(SW_INTR_ID_3, sw_intr_id3_handler, NULL) == 0);
+    assert(esp_amp_sw_intr_add_handler(SW_INTR_ID_4, sw_intr_id4_handler, NULL) == 0);
 
     while (1);
 
@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#include "esp_amp.h"
+#include "esp_amp_system.h"
+
+#define SYS_INFO_ID_TEST_BITS 0x0000
+#define EVENT_SUBCORE_DONE    (1 << 0)
+
+#define TEST_SRV_ID_ECHO       1
+#define TEST_SRV_ID_UNHANDLED  2
+#define TEST_BURST_NUM         14   /* more than drained by supplicant at once */
+#define TEST_UNHANDLED_NUM     3
+
+#define TEST_BURST (1 << 0)
+#define TEST_UNHANDLED (1 << 1)
+#define TEST_INVALID (1 << 2)
+
+static atomic_uint *test_bits = NULL;
+
+static void *create_request(uint16_t *max_len)
+{
+    void *buf = NULL;
+    while (esp_amp_system_service_create_request(&buf, max_len) != 0) {
+        /* all requests are in flight, wait for supplicant to give some back */
+    }
+    return buf;
+}
+
+static void test_burst(void)
+{
+    uint16_t max_len;
+
+    /* request i carries i + 1 bytes, each of value i */
+    for (int i = 0; i < TEST_BURST_NUM; i++) {
+        uint8_t *buf = (uint8_t *)create_request(&max_len);
+        memset(buf, i, i + 1);
+        assert(esp_amp_system_service_send_request(TEST_SRV_ID_ECHO, buf, i + 1) == 0);
+    }
+
+    atomic_fetch_or(test_bits, TEST_BURST);
+}
+
+static void test_unhandled(void)
+{
+    uint16_t max_len;
+
+    for (int i = 0; i < TEST_UNHANDLED_NUM; i++) {
+        void *buf = create_request(&max_len);
+        assert(esp_amp_system_service_send_request(TEST_SRV_ID_UNHANDLED, buf, 4) == 0);
+    }
+
+    atomic_fetch_or(test_bits, TEST_UNHANDLED);
+}
+
+static void test_invalid(void)
+{
+    uint16_t max_len;
+
+    /* invalid requests are given back without reaching any handler */
+    void *buf = create_request(&max_len);
+    assert(max_len > 0);
+    assert(esp_amp_system_service_send_request(CONFIG_ESP_AMP_SYSTEM_SERVICE_TABLE_LEN, buf, 1) == -1);
+
+    buf = create_request(&max_len);
+    assert(esp_amp_system_service_send_request(TEST_SRV_ID_ECHO, buf, max_len + 1) == -1);
+
+    atomic_fetch_or(test_bits, TEST_INVALID);
+}
+
+int main(void)
+{
+    printf("Hello!!\r\n");
+
+    assert(esp_amp_init() == 0);
+    test_bits = (atomic_uint *)esp_amp_sys_info_get(SYS_INFO_ID_TEST_BITS, NULL);
+    assert(test_bits != NULL);
+
+    test_burst();
+    test_unhandled();
+    test_invalid();
+
+    esp_amp_event_notify(EVENT_SUBCORE_DONE);
+    while (1);
+
+    printf("Bye!!\r\n");
+    return 0;
+}